@@ -0,0 +1,56 @@
+/*
+ * @file   : adc_filter.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef INC_ADC_FILTER_H_
+#define INC_ADC_FILTER_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+
+/********************** macros ***********************************************/
+
+/* Bloques que el CIC2 necesita para asentarse, antes la salida no vale */
+#define ADC_FILTER_SETTLE_BLOCKS	(2ul)
+
+/********************** typedef **********************************************/
+
+typedef enum {
+	ADC_FILTER_BOXCAR,		// Promedio por bloque, sin estado entre bloques
+	ADC_FILTER_CIC2,		// CIC de 2do orden, mejor rechazo y más retardo
+} adc_filter_t;
+
+typedef struct {
+	adc_filter_t type;
+	uint32_t integrator[2];
+	uint32_t comb[2];		// Salidas anteriores de cada etapa de comb
+} adc_filter_dta_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void adc_filter_reset(adc_filter_dta_t *p_filter, adc_filter_t type);
+
+/* Decima un bloque de ADC_OVERSAMPLE muestras de 12 bits separadas por
+ * stride (los canales del scan van intercalados). Devuelve la lectura con
+ * ADC_EXTRA_BITS bits más. */
+uint32_t adc_filter_block(adc_filter_dta_t *p_filter, const volatile uint16_t *p_sample, uint32_t stride);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_ADC_FILTER_H_ */
+
+/********************** end of file ******************************************/
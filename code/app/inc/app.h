@@ -44,6 +44,7 @@ extern "C" {
 #endif
 
 /********************** inclusions *******************************************/
+#include "snapshot.h"
 
 /********************** macros ***********************************************/
 #define TEST_0 (0)
@@ -52,13 +53,31 @@ extern "C" {
 
 #define TEST_X (TEST_0)
 
+/* Cambia cada vez que cambia el formato o las unidades de system_config_t,
+ * así se descarta lo guardado en la EEPROM por una versión anterior */
+#define SYSTEM_CONFIG_VERSION	(3)
+
 /********************** typedef **********************************************/
 
+/* Modo de control de un canal */
+typedef enum {
+	CTRL_MODE_ONOFF,			// Histéresis sobre el setpoint
+	CTRL_MODE_PID,				// PID sobre una salida PWM
+	CTRL_MODE_QTY
+} ctrl_mode_t;
+
+/* Temperaturas en décimas de °C y presiones en décimas de kPa */
 typedef struct
 {
+	uint32_t version;           // SYSTEM_CONFIG_VERSION
+
 	uint32_t temp_setpoint;     // Temperatura objetivo
 	uint32_t temp_hysteresis;   // Margen de temperatura
 	uint32_t temp_alarm_limit;  // Límite para disparar alarma
+	uint32_t temp_mode;         // ctrl_mode_t
+	uint32_t temp_kp;           // Ganancias del PID en décimas (ver pid.h)
+	uint32_t temp_ki;
+	uint32_t temp_kd;
 
 	uint32_t press_setpoint;    // Presión objetivo
 	uint32_t press_hysteresis;  // Margen de presión
@@ -67,24 +86,58 @@ typedef struct
 	uint8_t  alarm_enabled;      // Estado general de alarmas (ON/OFF)
 } system_config_t;
 
-typedef struct {
-	bool     adc_end_of_conversion;
+/* Una medición completa, la publica el ADC por cada bloque decimado */
+typedef struct
+{
 	uint16_t temp_raw;
 	uint16_t pressure_raw;
+	uint16_t temp;				// Temperatura medida [0.1 °C]
+	uint16_t press;				// Presión medida [0.1 kPa]
+} sensor_frame_t;
+
+/* Setpoints instantáneos de una receta en curso, reemplazan a los de cfg */
+typedef struct
+{
+	bool     active;
+	uint16_t temp;				// [0.1 °C]
+	uint16_t press;				// [0.1 kPa]
+} setpoint_frame_t;
+
+/* sensor (sensor_frame_t) lo escribe task_adc, cfg (system_config_t)
+ * task_menu y setpoint (setpoint_frame_t) task_recipe. Cada tarea copia lo
+ * que usa una vez por ejecución con snapshot_read(), así nunca ve un
+ * setpoint nuevo con una histéresis vieja */
+typedef struct {
+	bool     adc_end_of_conversion;
 	uint16_t pwm_active;
 
-	system_config_t cfg;
+	snapshot_t sensor;
+	snapshot_t cfg;
+	snapshot_t setpoint;
 } shared_data_type;
 
 /********************** external data declaration ****************************/
 extern uint32_t g_app_cnt;
 extern uint32_t g_app_time_us;
+extern uint32_t g_app_tick;
+extern uint32_t g_app_idle_time_us;	// Tiempo ocioso del último segundo
+extern uint32_t g_app_cpu_load;		// Carga de CPU del último segundo [0.1 %]
+extern uint32_t g_app_overrun_cnt;		// Overruns de todas las tareas
+extern uint32_t g_app_overrun_tick;		// Tick del último overrun
 
 extern volatile uint32_t g_app_tick_cnt;
 
 /********************** external functions declaration ***********************/
 void app_init(void);
 void app_update(void);
+void app_idle(void);
+
+/* Estadísticas de ejecución por tarea. app_stats_line() formatea la línea
+ * pedida (0 .. app_stats_line_qty() - 1) y devuelve 0 si no hay nada que
+ * imprimir */
+void app_stats_reset(void);
+uint32_t app_stats_line_qty(void);
+int app_stats_line(uint32_t line, char *buf, size_t size);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
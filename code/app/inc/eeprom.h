@@ -15,18 +15,27 @@ extern "C" {
 
 /********************** inclusions *******************************************/
 
+#include <stdbool.h>
+
 /********************** macros ***********************************************/
 
 #define EEPROM_MAX_ADDRESS 63999
 
+/* Mapa de la EEPROM. Cada bloque está alineado a 64 bytes para que una
+ * escritura nunca cruce el límite de una página */
+#define EEPROM_CFG_ADDR				0
+#define EEPROM_RECIPE_ADDR			64
+#define EEPROM_RECIPE_SLOT_SIZE		64
+
 /********************** typedef **********************************************/
 
 /********************** external data declaration ****************************/
 
 /********************** external functions declaration ***********************/
 
-HAL_StatusTypeDef eeprom_write_async(uint8_t offset, void *data, size_t size);
-void eeprom_read(uint8_t offset, void *data, size_t size);
+HAL_StatusTypeDef eeprom_write_async(uint16_t offset, void *data, size_t size);
+void eeprom_read(uint16_t offset, void *data, size_t size);
+bool eeprom_is_busy(void);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
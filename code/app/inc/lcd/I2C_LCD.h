@@ -19,22 +19,36 @@
 #define I2C_LCD_MAX	1	// Maximum Number of I2C_LCD Modules in Your Project
 #define I2C_LCD_1	0	// I2C_LCD Instance Number 1 (Add more if you need)
 
-#define LCD_TX_BUFFER_SIZE 64
+#define LCD_TX_BUFFER_SIZE 32	// Items, cada tira de caracteres ocupa uno solo
+#define LCD_TX_BATCH_SIZE 16	// Bytes al LCD por transferencia DMA, una línea de 16x2
 
+// Un comando o carácter suelto va en value; una tira de caracteres se lee de
+// p_data recién al armar la transferencia, así que no puede cambiar antes
 typedef struct {
-    uint16_t buffer[LCD_TX_BUFFER_SIZE];
+    const char *p_data;
+    uint8_t len;
+    uint8_t value;
+    uint8_t mode;	// 0 comando, RS dato
+} I2C_LCD_Item_t;
+
+typedef struct {
+    I2C_LCD_Item_t buffer[LCD_TX_BUFFER_SIZE];
     volatile uint16_t head;
     volatile uint16_t tail;
+    uint8_t tail_offset; // Caracteres ya mandados del item en tail
     volatile bool is_busy; // Flag para saber si el I2C está transmitiendo
 } I2C_LCD_Queue_t;
 
 //-----[ Prototypes For All User External Functions ]-----
 
 void I2C_LCD_Init(uint8_t I2C_LCD_InstanceIndex);
-void I2C_LCD_Clear(uint8_t I2C_LCD_InstanceIndex);
+bool I2C_LCD_InitStep(uint8_t I2C_LCD_InstanceIndex);	// Avanza la inicialización, true cuando el LCD está listo
+void I2C_LCD_Clear(uint8_t I2C_LCD_InstanceIndex);	// Después esperar a que I2C_LCD_InitStep() devuelva true
 void I2C_LCD_Home(uint8_t I2C_LCD_InstanceIndex);
 void I2C_LCD_SetCursor(uint8_t I2C_LCD_InstanceIndex, uint8_t Col, uint8_t Row);
 void I2C_LCD_WriteChar(uint8_t I2C_LCD_InstanceIndex, char Ch);
+void I2C_LCD_WriteRun(uint8_t I2C_LCD_InstanceIndex, const char* Str, uint8_t Len);
+uint16_t I2C_LCD_TxFree(uint8_t I2C_LCD_InstanceIndex);	// Items que entran en la cola sin perderse
 void I2C_LCD_WriteString(uint8_t I2C_LCD_InstanceIndex, char* Str);
 
 void I2C_LCD_ShiftLeft(uint8_t I2C_LCD_InstanceIndex);
@@ -0,0 +1,60 @@
+/*
+ * @file   : pid.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef INC_PID_H_
+#define INC_PID_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/* Rango de las ganancias, en décimas */
+#define PID_GAIN_MIN			(0ul)
+#define PID_GAIN_MAX			(1000ul)	// 100.0
+
+/********************** typedef **********************************************/
+
+/* Ganancias en décimas, con la medición en décimas y la salida en 0.1 %:
+ * kp [%/u], ki [%/(u.s)], kd [%.s/u], siendo u la unidad de la medición */
+typedef struct {
+	uint32_t kp;
+	uint32_t ki;
+	uint32_t kd;
+	uint32_t dt_ms;			// Período de muestreo
+	uint32_t out_max;		// La salida va de 0 a out_max
+} pid_cfg_t;
+
+typedef struct {
+	int32_t i_acc;			// Integral escalada por PID_I_SCALE
+	int32_t d_filt;			// Derivada filtrada
+	int32_t prev_meas;
+	bool    first;			// Sin medición anterior para derivar
+} pid_dta_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void pid_reset(pid_dta_t *p_pid);
+uint32_t pid_update(pid_dta_t *p_pid, const pid_cfg_t *p_cfg, int32_t setpoint, int32_t meas);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_PID_H_ */
+
+/********************** end of file ******************************************/
@@ -0,0 +1,59 @@
+/*
+ * @file   : pwm.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef INC_PWM_H_
+#define INC_PWM_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+
+/********************** macros ***********************************************/
+
+/* Escala del ciclo de trabajo: 1000 = 100 %, pasos de 0.1 %. La resolución
+ * real es la de cada salida: el duty se redondea a sus pasos */
+#define PWM_DUTY_MAX	(1000ul)
+
+/* Calefactor: ventana de 2 s en pasos de 10 ms, medio ciclo de red, para que
+ * lo pueda conmutar un relé o un SSR con cruce por cero. TIM4 cuenta 0.1 ms
+ * con ARR de 16 bits: el período llega hasta 6553 ms */
+#define PWM_HEATER_PERIOD_MS	(2000ul)
+#define PWM_HEATER_STEPS		(200ul)
+
+/********************** typedef **********************************************/
+
+typedef enum {
+	PWM_ID_HEATER,
+	PWM_ID_QTY
+} pwm_id_t;
+
+/* Para salidas que no tienen PWM */
+#define PWM_ID_NONE		(PWM_ID_QTY)
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void pwm_init(void);
+void pwm_set_duty(pwm_id_t id, uint32_t duty);
+uint32_t pwm_get_duty(pwm_id_t id);
+void pwm_lock(pwm_id_t id);
+void pwm_unlock(pwm_id_t id);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_PWM_H_ */
+
+/********************** end of file ******************************************/
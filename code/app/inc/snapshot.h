@@ -0,0 +1,58 @@
+/*
+ * @file   : snapshot.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef INC_SNAPSHOT_H_
+#define INC_SNAPSHOT_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/* Inicializa un snapshot sobre un arreglo de dos elementos del tipo publicado */
+#define SNAPSHOT_INIT(buffer)													\
+	{0, 0, sizeof((buffer)[0]), (uint8_t *)(buffer), 0}
+
+/********************** typedef **********************************************/
+
+/* Valor publicado por un único escritor y leído entero por cualquier tarea.
+ * El escritor llena el buffer que no está publicado y después lo publica,
+ * así una publicación no pisa la copia que un lector está haciendo. seq es
+ * impar mientras se escribe; si durante la copia empezó más de una
+ * publicación el lector vuelve a copiar. El escritor nunca espera, así que
+ * puede ser una ISR, y nadie deshabilita interrupciones. */
+typedef struct {
+	volatile uint32_t	seq;			// Dos por publicación
+	volatile uint8_t	front;			// Buffer publicado (0 o 1)
+	uint16_t			size;			// Tamaño de cada buffer
+	uint8_t				*buffer;		// 2 * size bytes
+	uint32_t			retry_cnt;		// Copias repetidas por los lectores
+} snapshot_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void snapshot_publish(snapshot_t *p_snapshot, const void *p_value);
+void snapshot_read(snapshot_t *p_snapshot, void *p_value);
+uint32_t snapshot_count(const snapshot_t *p_snapshot);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_SNAPSHOT_H_ */
+
+/********************** end of file ******************************************/
@@ -0,0 +1,63 @@
+/*
+ * @file   : spsc_queue.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef INC_SPSC_QUEUE_H_
+#define INC_SPSC_QUEUE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/* Define una cola y su buffer. El tamaño tiene que ser potencia de 2 */
+#define SPSC_QUEUE_DEFINE(name, size)											\
+	_Static_assert((0 < (size)) && (0 == ((size) & ((size) - 1))),				\
+				   #name " size must be a power of two");						\
+	_Static_assert((size) <= 32768u, #name " size too big");					\
+	uint8_t name##_buffer[(size)];												\
+	spsc_queue_t name = {name##_buffer, (size) - 1, 0, 0, 0, 0}
+
+/********************** typedef **********************************************/
+
+/* Cola de un solo productor y un solo consumidor de elementos de un byte.
+ * head solo lo escribe el productor y tail solo el consumidor, ambos corren
+ * libres y se enmascaran al indexar, así que no hace falta deshabilitar
+ * interrupciones si uno de los dos lados es una ISR. */
+typedef struct {
+	uint8_t				*buffer;
+	uint16_t			mask;			// Tamaño - 1
+	volatile uint16_t	head;			// Próxima posición a escribir
+	volatile uint16_t	tail;			// Próxima posición a leer
+	uint16_t			overflow_cnt;	// Elementos descartados por cola llena
+	uint16_t			high_water;		// Máximo de elementos pendientes visto
+} spsc_queue_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void spsc_queue_init(spsc_queue_t *p_queue);
+bool spsc_queue_put(spsc_queue_t *p_queue, uint8_t item);
+bool spsc_queue_get(spsc_queue_t *p_queue, uint8_t *p_item);
+bool spsc_queue_any(const spsc_queue_t *p_queue);
+uint16_t spsc_queue_count(const spsc_queue_t *p_queue);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_SPSC_QUEUE_H_ */
+
+/********************** end of file ******************************************/
@@ -47,15 +47,21 @@ extern "C" {
 
 /********************** macros ***********************************************/
 
+/* Scheduler release period & offset [ticks] */
+#define TASK_ACTUATOR_PERIOD		(1ul)
+#define TASK_ACTUATOR_OFFSET		(0ul)
+
 /********************** typedef **********************************************/
 
 /********************** external data declaration ****************************/
 extern uint32_t g_task_actuator_cnt;
-extern volatile uint32_t g_task_actuator_tick_cnt;
 
 /********************** external functions declaration ***********************/
 extern void task_actuator_init(void *parameters);
 extern void task_actuator_update(void *parameters);
+extern void task_actuator_force_safe(void);
+extern void task_actuator_release_safe(void);
+extern bool task_actuator_is_safe(void);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
@@ -44,9 +44,13 @@ extern "C" {
 #endif
 
 /********************** inclusions *******************************************/
+#include "pwm.h"
 
 /********************** macros ***********************************************/
 
+/* Comandos pendientes por actuador */
+#define ACT_CMD_QUEUE_SIZE	(4)
+
 /********************** typedef **********************************************/
 /* Actuator Statechart - State Transition Table */
 /* 	------------------------+-----------------------+-----------------------+-----------------------+------------------------
@@ -59,6 +63,11 @@ extern "C" {
  * 	|                       |-----------------------+-----------------------+-----------------------+-----------------------|
  * 	|                       | EV_ACT_XX_BLINK       |                       | ST_ACT_XX_BLINK_ON    | tick = tick_max       |
  * 	|                       |                       |                       |                       | act = ACT_ON			|
+ * 	|                       |-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_ACT_XX_PULSE       |                       | ST_ACT_XX_PULSE       | tick = tick_pulse     |
+ * 	|                       |                       |                       |                       | act = ACT_ON			|
+ * 	|                       |-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_ACT_XX_DUTY (duty) | [duty >  0]           | ST_ACT_XX_DUTY        | act = duty            |
  * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
  * 	| ST_ACT_XX_ON          | EV_ACT_XX_OFF         |                       | ST_ACT_XX_OFF		    | act = ACT_OFF         |
  * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
@@ -98,7 +107,29 @@ extern "C" {
  * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
  * 	|                       |                       | [tick == 0]           | ST_ACT_XX_OFF         | tick = tick_max       |
  * 	|                       |                       |                       |                       | act = ACT_OFF         |
+ * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	| ST_ACT_XX_DUTY        | EV_ACT_XX_OFF         |                       | ST_ACT_XX_OFF         | act = ACT_OFF         |
+ * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_ACT_XX_ON          |                       | ST_ACT_XX_ON		    | act = ACT_ON          |
+ * 	|                       |-----------------------+-----------------------+-----------------------+-----------------------|
+ * 	|                       | EV_ACT_XX_DUTY (duty) | [duty >  0]           | ST_ACT_XX_DUTY        | act = duty            |
+ * 	|                       |                       +-----------------------+-----------------------+-----------------------|
+ * 	|                       |                       | [duty == 0]           | ST_ACT_XX_OFF         | act = ACT_OFF         |
  * 	------------------------+-----------------------+-----------------------+-----------------------+------------------------
+ *
+ * EV_ACT_XX_DUTY se atiende igual en todos los estados: con duty > 0 pasa a
+ * ST_ACT_XX_DUTY y con duty == 0 apaga y pasa a ST_ACT_XX_OFF. En una salida
+ * sin PWM cualquier duty > 0 la enciende.
+ *
+ * Los comandos se encolan por actuador y se consume uno por update. Uno nuevo
+ * reemplaza al pendiente de su misma clase, gana el último: ON/OFF/DUTY son
+ * una clase y BLINK/NOT_BLINK otra. Los PULSE no se fusionan, y uno que llega
+ * durante un pulso espera a que termine el actual.
+ *
+ * Un comando que encendería la salida antes de min_off_ms o sin arranques en
+ * el balde, o la apagaría antes de min_on_ms, queda diferido: sigue pendiente
+ * y se aplica cuando se abre su ventana, salvo que lo reemplace uno más nuevo.
+ * El estado seguro forzado no respeta estos límites.
  */
 
 /* Events to excite Task Actuator */
@@ -106,20 +137,24 @@ typedef enum task_actuator_ev {EV_ACT_XX_OFF,
 							   EV_ACT_XX_ON,
 							   EV_ACT_XX_NOT_BLINK,
 							   EV_ACT_XX_BLINK,
-							   EV_ACT_XX_PULSE} task_actuator_ev_t;
+							   EV_ACT_XX_PULSE,
+							   EV_ACT_XX_DUTY} task_actuator_ev_t;
 
 /* States of Task Actuator */
 typedef enum task_actuator_st {ST_ACT_XX_OFF,
 							   ST_ACT_XX_ON,
 							   ST_ACT_XX_BLINK_ON,
-							   ST_ACT_XX_BLINK_OFF} task_actuator_st_t;
+							   ST_ACT_XX_BLINK_OFF,
+							   ST_ACT_XX_PULSE,
+							   ST_ACT_XX_DUTY} task_actuator_st_t;
 
 /* Identifier of Task Actuator */
 typedef enum task_actuator_id {ID_ACT_PUMP,
 							   ID_ACT_VALVE,
 							   ID_ACT_COOLER,
 							   ID_ACT_HEATER,
-							   ID_ACT_BUZZER} task_actuator_id_t;
+							   ID_ACT_BUZZER,
+							   ID_ACT_QTY} task_actuator_id_t;
 
 typedef struct
 {
@@ -129,6 +164,13 @@ typedef struct
 	GPIO_PinState		act_on;
 	GPIO_PinState		act_off;
 	uint32_t			tick_blink;
+	uint32_t			tick_pulse;
+	bool				safe_off;		// Se apaga al forzar el estado seguro
+	pwm_id_t			pwm_id;			// PWM_ID_NONE: se maneja por GPIO
+	uint32_t			min_on_ms;		// Tiempo mínimo encendido
+	uint32_t			min_off_ms;		// Tiempo mínimo apagado
+	uint8_t				max_starts;		// Arranques por start_window_ms, 0 sin límite
+	uint32_t			start_window_ms;
 } task_actuator_cfg_t;
 
 typedef struct
@@ -137,6 +179,17 @@ typedef struct
 	task_actuator_st_t	state;
 	task_actuator_ev_t	event;
 	bool				flag;
+	uint8_t				cmd_queue[ACT_CMD_QUEUE_SIZE];	// El más viejo primero
+	uint8_t				cmd_count;
+	uint16_t			merged_cnt;		// Comandos reemplazados por uno nuevo
+	uint16_t			dropped_cnt;	// Comandos perdidos con la cola llena
+	bool				out_on;			// Nivel actual de la salida
+	uint32_t			switch_tick;	// g_app_tick del último cambio de la salida
+	uint8_t				start_tokens;	// Arranques disponibles
+	uint32_t			token_tick;		// g_app_tick de la última recarga
+	bool				deferred;		// El comando pendiente espera su ventana
+	uint16_t			deferred_cnt;	// Comandos demorados por los tiempos mínimos
+	uint16_t			duty_cmd;		// Duty del EV_ACT_XX_DUTY pendiente
 } task_actuator_dta_t;
 
 /********************** external data declaration ****************************/
@@ -52,7 +52,11 @@ extern "C" {
 /********************** external data declaration ****************************/
 
 /********************** external functions declaration ***********************/
+extern void init_queue_event_task_actuator(void);
 extern void put_event_task_actuator(task_actuator_ev_t event, task_actuator_id_t identifier);
+extern void put_duty_task_actuator(uint32_t duty, task_actuator_id_t identifier);
+extern task_actuator_ev_t get_event_task_actuator(task_actuator_id_t identifier);
+extern bool any_event_task_actuator(task_actuator_id_t identifier);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
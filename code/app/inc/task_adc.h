@@ -47,7 +47,21 @@ extern "C" {
 
 /********************** macros ***********************************************/
 
-#define ADC_MAX_VALUE 4095
+/* Cada lectura entregada es el resultado de decimar ADC_OVERSAMPLE muestras de
+ * 12 bits: sobremuestrear por 4^n agrega n bits, 16 muestras -> 14 bits */
+#define ADC_RAW_MAX_VALUE	4095
+#define ADC_OVERSAMPLE		16
+#define ADC_EXTRA_BITS		2
+#define ADC_MAX_VALUE		(ADC_RAW_MAX_VALUE << ADC_EXTRA_BITS)
+
+/* Filtro de decimación de cada canal (adc_filter.h). El barrido de sim/ usa
+ * los mismos. */
+#define ADC_TEMP_FILTER		ADC_FILTER_CIC2
+#define ADC_PRESS_FILTER	ADC_FILTER_BOXCAR
+
+/* Scheduler release period & offset [ticks] */
+#define TASK_ADC_PERIOD		(1ul)
+#define TASK_ADC_OFFSET		(0ul)
 
 /********************** typedef **********************************************/
 
@@ -58,6 +72,9 @@ extern uint32_t g_task_a_cnt;
 void task_adc_init(void *parameters);
 void task_adc_update(void *parameters);
 
+void task_adc_temp_watchdog_arm(uint16_t low_raw, uint16_t high_raw);
+void task_adc_temp_watchdog_disarm(void);
+
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
 }
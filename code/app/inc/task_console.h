@@ -0,0 +1,44 @@
+/*
+ * @file   : task_console.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef TASK_INC_TASK_CONSOLE_H_
+#define TASK_INC_TASK_CONSOLE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+/********************** macros ***********************************************/
+
+/* Scheduler release period & offset [ticks] */
+#define TASK_CONSOLE_PERIOD		(5ul)
+#define TASK_CONSOLE_OFFSET		(2ul)
+
+/* Comandos de la consola serie (USART2, 115200 8N1) */
+#define CONSOLE_CMD_STATS		's'		// Imprime las estadísticas de las tareas
+#define CONSOLE_CMD_RESET		'r'		// Reinicia las estadísticas
+
+/********************** typedef **********************************************/
+
+/********************** external data declaration ****************************/
+extern uint32_t g_task_console_cnt;
+
+/********************** external functions declaration ***********************/
+void task_console_init(void *parameters);
+void task_console_update(void *parameters);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TASK_INC_TASK_CONSOLE_H_ */
+
+/********************** end of file ******************************************/
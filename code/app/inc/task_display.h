@@ -17,12 +17,15 @@ extern "C" {
 
 /********************** macros ***********************************************/
 
+/* Scheduler release period & offset [ticks] */
+#define TASK_DISPLAY_PERIOD		(1ul)
+#define TASK_DISPLAY_OFFSET		(0ul)
+
 /********************** typedef **********************************************/
 
 /********************** external data declaration ****************************/
 
 extern uint32_t g_task_display_cnt;
-extern volatile uint32_t g_task_display_tick_cnt;
 
 /********************** external functions declaration ***********************/
 
@@ -0,0 +1,70 @@
+/*
+ * @file   : task_display_attribute.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ *
+ * Las tareas no le escriben al LCD sino a un framebuffer (next). La tarea
+ * display compara next con lo que ya tiene el LCD (shown) y solo manda las
+ * celdas que cambiaron, moviendo el cursor únicamente cuando no son
+ * consecutivas: el LCD avanza solo después de cada carácter. Si una fila se
+ * reescribe antes de terminar de mandarse, la versión vieja se descarta.
+ */
+
+#ifndef INC_TASK_DISPLAY_ATTRIBUTE_H_
+#define INC_TASK_DISPLAY_ATTRIBUTE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/* Alcanza para un 16x2 o un 20x4, el tamaño real sale de I2C_LCD_CfgParam */
+#define DISPLAY_COLS_MAX		(20u)
+#define DISPLAY_ROWS_MAX		(4u)
+
+/* Posición del cursor del LCD que no se conoce */
+#define DISPLAY_POS_UNKNOWN		(0xFFu)
+
+/********************** typedef **********************************************/
+
+typedef struct
+{
+	uint8_t	cols;
+	uint8_t	rows;
+
+	/* Lo que escriben las tareas y el cursor de escritura */
+	char	next[DISPLAY_ROWS_MAX][DISPLAY_COLS_MAX];
+	uint8_t	col;
+	uint8_t	row;
+	uint8_t	dirty_rows;					// Filas con alguna celda distinta de shown
+
+	/* Lo que ya se mandó al LCD y dónde quedó su cursor. El driver del LCD
+	 * lee los caracteres directamente de acá. */
+	char	shown[DISPLAY_ROWS_MAX][DISPLAY_COLS_MAX];
+	uint8_t	lcd_col;
+	uint8_t	lcd_row;
+
+	uint32_t sent_cnt;					// Comandos mandados al LCD
+	uint32_t dropped_cnt;				// Filas reescritas antes de terminar de mandarse
+} task_display_dta_t;
+
+/********************** external data declaration ****************************/
+extern task_display_dta_t task_display_dta;
+
+/********************** external functions declaration ***********************/
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_TASK_DISPLAY_ATTRIBUTE_H_ */
+
+/********************** end of file ******************************************/
@@ -15,6 +15,7 @@ extern "C" {
 
 /********************** inclusions *******************************************/
 
+#include <stdint.h>
 #include <stdbool.h>
 
 /********************** macros ***********************************************/
@@ -24,24 +25,21 @@ extern "C" {
 typedef enum {
 	CMD_DISP_TO_LINE_0,
 	CMD_DISP_TO_LINE_1,
+	CMD_DISP_TO_LINE_2,
+	CMD_DISP_TO_LINE_3,
 	CMD_DISP_WRITE_STR
 } task_disp_cmd_t;
 
-#define SUBCMD_LINE_0		'\x1'
-#define SUBCMD_LINE_1		'\x2'
-
 /********************** external data declaration ****************************/
 
 /********************** external functions declaration ***********************/
 
-void init_queue_cmd_task_display(void);
+void init_framebuffer_task_display(uint8_t cols, uint8_t rows);
 
+/* Escribe en el framebuffer: TO_LINE_x lleva el cursor al principio de la
+ * fila y WRITE_STR escribe desde ahí, lo que pasa del ancho se descarta */
 void put_cmd_task_display(task_disp_cmd_t cmd, const char *text);
 
-char get_subcmd_task_display(void);
-
-bool any_submcd_task_display(void);
-
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
 }
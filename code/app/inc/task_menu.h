@@ -47,11 +47,14 @@ extern "C" {
 
 /********************** macros ***********************************************/
 
+/* Scheduler release period & offset [ticks] */
+#define TASK_MENU_PERIOD		(10ul)
+#define TASK_MENU_OFFSET		(7ul)
+
 /********************** typedef **********************************************/
 
 /********************** external data declaration ****************************/
 extern uint32_t g_task_menu_cnt;
-extern volatile uint32_t g_task_menu_tick_cnt;
 
 /********************** external functions declaration ***********************/
 extern void task_menu_init(void *parameters);
@@ -59,44 +59,129 @@ typedef enum task_menu_ev {EV_MEN_ENT_IDLE,
 						   EV_MEN_PRE_IDLE,
 						   EV_MEN_PRE_ACTIVE,
 						   EV_MEN_ESC_IDLE,
-						   EV_MEN_ESC_ACTIVE,} task_menu_ev_t;
+						   EV_MEN_ESC_ACTIVE,
+						   EV_MEN_NEX_ACTIVE_X5,	// NEX/PRE que valen 5 o 10 pasos
+						   EV_MEN_NEX_ACTIVE_X10,
+						   EV_MEN_PRE_ACTIVE_X5,
+						   EV_MEN_PRE_ACTIVE_X10,
+						   EV_MEN_AUTOTUNE_DONE,
+						   EV_MEN_ALARM_EXIT,		// Disparo con el menú abierto, se sale sin ESC
+						   } task_menu_ev_t;
 
 /* State of Task Menu */
 typedef enum task_menu_st {
-	ST_MEN_IDLE,       		// Fuera del menú
-	ST_MEN_MAIN_SELECT,     // Menú Principal: Seleccionar Temp / Presión / Alarmas
-
+	ST_MEN_IDLE,			// Fuera del menú
+	ST_MEN_BROWSE,			// Recorriendo el árbol de menu_node_list
 	ST_MEN_SAVING,			// Esperando para poder guardar los datos en la EEPROM.
+} task_menu_st_t;
+
+/* Nodos del árbol del menú */
+typedef enum {
+	MENU_ID_ROOT,			// Temp / Presión / Alarmas / Recetas
 
 	// Rama Temperatura
-	ST_MEN_TEMP_SELECT,     // Submenú Temp: Setpoint o Histéresis
-	ST_MEN_MOD_TEMP_SET,    // Modificar Setpoint Temperatura
-	ST_MEN_MOD_TEMP_HYS,    // Modificar Histéresis Temperatura
+	MENU_ID_TEMP,
+	MENU_ID_TEMP_SET,
+	MENU_ID_TEMP_HYS,
+	MENU_ID_TEMP_MODE,
+	MENU_ID_TEMP_KP,
+	MENU_ID_TEMP_KI,
+	MENU_ID_TEMP_KD,
+	MENU_ID_TEMP_AUTOTUNE,
 
 	// Rama Presión
-	ST_MEN_PRESS_SELECT,    // Submenú Presión: Setpoint o Histéresis
-	ST_MEN_MOD_PRESS_SET,   // Modificar Setpoint Presión
-	ST_MEN_MOD_PRESS_HYS,   // Modificar Histéresis Presión
+	MENU_ID_PRESS,
+	MENU_ID_PRESS_SET,
+	MENU_ID_PRESS_HYS,
 
 	// Rama Alarmas
-	ST_MEN_ALARM_SELECT,    // Submenú Alarmas: Limites o Habilitación
-	ST_MEN_MOD_ALARM_TLIM,  // Modificar Límite T
-	ST_MEN_MOD_ALARM_PLIM,  // Modificar Límite P
-	ST_MEN_MOD_ALARM_EN     // Habilitar/Deshabilitar Alarmas
-} task_menu_st_t;
+	MENU_ID_ALARM,
+	MENU_ID_ALARM_EN,
+	MENU_ID_ALARM_TLIM,
+	MENU_ID_ALARM_PLIM,
+
+	// Rama Recetas: una página por receta, todas con las mismas acciones
+	MENU_ID_RECIPE,
+	MENU_ID_RECIPE_1,
+	MENU_ID_RECIPE_2,
+	MENU_ID_RECIPE_3,
+	MENU_ID_RECIPE_4,
+	MENU_ID_RECIPE_START,
+	MENU_ID_RECIPE_PAUSE,
+	MENU_ID_RECIPE_ABORT,
+
+	MENU_ID_QTY
+} menu_id_t;
+
+typedef enum {
+	MENU_NODE_LIST,			// Página con opciones, ENT entra a la elegida
+	MENU_NODE_VALUE,		// Campo numérico en décimas, con mín, máx y paso
+	MENU_NODE_CHOICE,		// Campo que vale 0..max, cada valor con su texto
+	MENU_NODE_ACTION,		// ENT ejecuta action sin cambiar de página
+} menu_node_type_t;
+
+/* Después de la acción vuelve a la página anterior */
+#define MENU_FLAG_BACK			(0x01u)
+
+/* Máxima profundidad del árbol debajo de la raíz */
+#define MENU_DEPTH_MAX			(3u)
+
+typedef struct menu_node_s menu_node_t;
+
+/* Texto que depende del estado: devuelve una cadena de 16 caracteres */
+typedef const char *(*menu_text_fn_t)(const menu_node_t *p_node);
+
+struct menu_node_s
+{
+	menu_node_type_t	type;
+	const char			*title;		// Línea 0 cuando es la página actual
+	const char			*item;		// Línea 1 cuando está elegido en la página de arriba
+	menu_text_fn_t		title_fn;	// Si no es NULL reemplaza a title
+	menu_text_fn_t		item_fn;	// Si no es NULL reemplaza a item
+	uint8_t				flags;
+	uint8_t				arg;		// Para action y los textos
+
+	/* MENU_NODE_LIST */
+	const uint8_t		*p_child_list;	// menu_id_t de cada opción
+	uint8_t				child_qty;
+
+	/* MENU_NODE_VALUE y MENU_NODE_CHOICE: campo de system_config_t */
+	uint8_t				field;		// offsetof
+	uint8_t				field_size;	// sizeof, 1 o 4
+	uint32_t			min;
+	uint32_t			max;
+	uint32_t			step;
+	const char			*unit;		// VALUE: 7 caracteres después del número
+	const char * const	*p_option_list;	// CHOICE: max + 1 textos
+
+	/* LIST: al entrar, ACTION: al confirmar */
+	void				(*action)(const menu_node_t *p_node);
+};
+
+/* Una página de arriba del camino y la opción que tenía elegida */
+typedef struct
+{
+	uint8_t				node;
+	uint8_t				selection;
+} menu_pos_t;
 
 typedef struct
 {
-	uint32_t		  tick;
+	uint32_t		  tick;				// ms hasta refrescar una página con textos vivos
 	task_menu_st_t 	  state;
 	task_menu_ev_t	  event;
 	bool			  flag;
-	system_config_t	  cfg;
+	bool			  b_dirty;			// La página cambió y hay que dibujarla
+	system_config_t	  cfg;				// Copia que se edita, se publica al confirmar
 	uint32_t          current_selection;
+	uint8_t			  node;				// Página actual, menu_id_t
+	uint8_t			  depth;			// Páginas en path
+	menu_pos_t		  path[MENU_DEPTH_MAX];
 } task_menu_dta_t;
 
 /********************** external data declaration ****************************/
 extern task_menu_dta_t task_menu_dta;
+extern const menu_node_t menu_node_list[MENU_ID_QTY];
 
 /********************** external functions declaration ***********************/
 
@@ -16,11 +16,14 @@ extern "C" {
 
 /********************** macros ***********************************************/
 
+/* Scheduler release period & offset [ticks] */
+#define TASK_PRESS_PERIOD		(10ul)
+#define TASK_PRESS_OFFSET		(5ul)
+
 /********************** typedef **********************************************/
 
 /********************** external data declaration ****************************/
 extern uint32_t g_task_press_cnt;
-extern volatile uint32_t g_task_press_tick_cnt;
 
 /********************** external functions declaration ***********************/
 extern void task_press_init(void *parameters);
@@ -14,6 +14,7 @@ extern "C" {
 #endif
 
 /********************** inclusions *******************************************/
+#include "app.h"
 
 /********************** macros ***********************************************/
 
@@ -41,6 +42,10 @@ extern task_press_dta_t task_press_dta;
 
 /********************** external functions declaration ***********************/
 
+/* Una ejecución del statechart sobre una instancia, como task_temp_statechart */
+extern void task_press_statechart(task_press_dta_t *p_task_press_dta, const system_config_t *p_cfg,
+								  uint32_t press);
+
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
 }
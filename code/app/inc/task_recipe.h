@@ -0,0 +1,60 @@
+/*
+ * @file   : task_recipe.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef INC_TASK_RECIPE_H_
+#define INC_TASK_RECIPE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/* Scheduler release period & offset [ticks] */
+#define TASK_RECIPE_PERIOD		(100ul)
+#define TASK_RECIPE_OFFSET		(9ul)
+
+/* Recetas guardadas en la EEPROM */
+#define RECIPE_SLOT_QTY			(4ul)
+
+/********************** typedef **********************************************/
+
+/* Estado de la receta para mostrar, lo lee el menú y la pantalla principal */
+typedef struct
+{
+	bool     running;
+	bool     paused;
+	uint8_t  slot;
+	uint8_t  segment;			// Segmento en curso, desde 0
+	uint8_t  segment_qty;
+	uint8_t  cycle;				// Vuelta en curso, desde 0
+} recipe_status_t;
+
+/********************** external data declaration ****************************/
+extern uint32_t g_task_recipe_cnt;
+
+/********************** external functions declaration ***********************/
+extern void task_recipe_init(void *parameters);
+extern void task_recipe_update(void *parameters);
+extern void task_recipe_select(uint8_t slot);
+extern bool task_recipe_is_valid(uint8_t slot);
+extern void task_recipe_get_status(recipe_status_t *p_status);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_TASK_RECIPE_H_ */
+
+/********************** end of file ******************************************/
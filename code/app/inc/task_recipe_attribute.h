@@ -0,0 +1,87 @@
+/*
+ * @file   : task_recipe_attribute.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef INC_TASK_RECIPE_ATTRIBUTE_H_
+#define INC_TASK_RECIPE_ATTRIBUTE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include "app.h"
+
+/********************** macros ***********************************************/
+
+#define RECIPE_MAGIC			(0xA5u)
+#define RECIPE_SEGMENT_MAX		(7u)
+
+/********************** typedef **********************************************/
+
+/* Un segmento lleva la temperatura hasta temp con la pendiente rate (0 es un
+ * salto) y fija la presión en press. Cuando la medición llega a ambos
+ * valores se mantienen durante soak minutos. */
+typedef struct
+{
+	uint16_t temp;				// Setpoint final [0.1 °C]
+	uint16_t press;				// Setpoint [0.1 kPa]
+	uint16_t rate;				// Pendiente [0.1 °C/min]
+	uint16_t soak;				// Mantenimiento [min]
+} recipe_segment_t;
+
+/* Formato en la EEPROM, un bloque de 64 bytes por receta */
+typedef struct
+{
+	uint8_t  magic;				// RECIPE_MAGIC si el bloque tiene una receta
+	uint8_t  segment_qty;
+	uint8_t  cycles;			// Vueltas, al menos 1
+	uint8_t  loop_first;		// Segmento en el que empieza cada vuelta
+	recipe_segment_t segment[RECIPE_SEGMENT_MAX];
+} recipe_t;
+
+/* Events to excite Task Recipe */
+typedef enum task_recipe_ev {EV_REC_START,
+							 EV_REC_PAUSE,
+							 EV_REC_ABORT,} task_recipe_ev_t;
+
+/* State of Task Recipe */
+typedef enum task_recipe_st {ST_REC_IDLE,
+							 ST_REC_RAMP,		// Setpoint de temperatura en rampa
+							 ST_REC_WAIT,		// Esperando que la medición llegue
+							 ST_REC_SOAK,		// Mantenimiento
+							 ST_REC_PAUSED,} task_recipe_st_t;
+
+typedef struct
+{
+	task_recipe_st_t	state;
+	task_recipe_ev_t	event;
+	bool				flag;
+	task_recipe_st_t	paused_state;	// Estado al que vuelve al reanudar
+	uint8_t				slot;			// Receta elegida
+	uint8_t				segment;
+	uint8_t				cycle;
+	uint32_t			last_tick;
+	uint32_t			elapsed;		// Tiempo del segmento sin pausas ni deshabilitado [ms]
+	uint16_t			ramp_from;		// Setpoint al empezar la rampa [0.1 °C]
+	setpoint_frame_t	setpoint;
+} task_recipe_dta_t;
+
+/********************** external data declaration ****************************/
+extern task_recipe_dta_t task_recipe_dta;
+
+/********************** external functions declaration ***********************/
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_TASK_RECIPE_ATTRIBUTE_H_ */
+
+/********************** end of file ******************************************/
@@ -0,0 +1,39 @@
+/*
+ * @file   : task_recipe_interface.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef INC_TASK_RECIPE_INTERFACE_H_
+#define INC_TASK_RECIPE_INTERFACE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+
+#include "task_recipe_attribute.h"
+
+/********************** macros ***********************************************/
+
+/********************** typedef **********************************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+extern void init_queue_event_task_recipe(void);
+extern void put_event_task_recipe(task_recipe_ev_t event);
+extern task_recipe_ev_t get_event_task_recipe(void);
+extern bool any_event_task_recipe(void);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_TASK_RECIPE_INTERFACE_H_ */
+
+/********************** end of file ******************************************/
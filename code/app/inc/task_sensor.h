@@ -47,11 +47,14 @@ extern "C" {
 
 /********************** macros ***********************************************/
 
+/* Scheduler release period & offset [ticks] */
+#define TASK_SENSOR_PERIOD		(1ul)
+#define TASK_SENSOR_OFFSET		(0ul)
+
 /********************** typedef **********************************************/
 
 /********************** external data declaration ****************************/
 extern uint32_t g_task_sensor_cnt;
-extern volatile uint32_t g_task_sensor_tick_cnt;
 
 /********************** external functions declaration ***********************/
 void task_sensor_init(void *parameters);
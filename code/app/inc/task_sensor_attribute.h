@@ -47,6 +47,9 @@ extern "C" {
 
 /********************** macros ***********************************************/
 
+/* Niveles de la repetición al mantener apretado: 1, 5 y 10 pasos por evento */
+#define SENSOR_REPEAT_LEVEL_QTY		3
+
 /********************** typedef **********************************************/
 /* Sensor Statechart - State Transition Table */
 /* 	------------------------+-----------------------+-----------------------+-----------------------+------------------------
@@ -68,7 +71,15 @@ extern "C" {
  * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
  *	| ST_BTN_XX_DOWN        | EV_BTN_XX_UP          |                       | ST_BTN_XX_RISING      | tick = TICK_MAX       |
  * 	|                       +-----------------------+-----------------------+-----------------------+-----------------------|
- * 	|                       | EV_BTN_XX_DOWN        |                       | ST_BTN_XX_DOWN        |                       |
+ * 	|                       | EV_BTN_XX_DOWN        | [repeat_delay == 0]   | ST_BTN_XX_DOWN        |                       |
+ * 	|                       |                       +-----------------------+-----------------------+-----------------------|
+ * 	|                       |                       | [tick >  0]           | ST_BTN_XX_DOWN        | tick--                |
+ * 	|                       |                       +-----------------------+-----------------------+-----------------------|
+ * 	|                       |                       | [tick == 0]           | ST_BTN_XX_DOWN        | put_event_task_system |
+ * 	|                       |                       |                       |                       |  (signal_repeat       |
+ * 	|                       |                       |                       |                       |   [level(repeat_cnt)])|
+ * 	|                       |                       |                       |                       | repeat_cnt++          |
+ * 	|                       |                       |                       |                       | tick = repeat_period  |
  * 	|-----------------------+-----------------------+-----------------------+-----------------------+-----------------------|
  * 	| ST_BTN_XX_RISING      | EV_BTN_XX_UP          | [tick >  0]           | ST_BTN_XX_RISING      | tick--                |
  * 	|                       |                       +-----------------------+-----------------------+-----------------------|
@@ -105,8 +116,11 @@ typedef struct
 	uint16_t			pin;
 	GPIO_PinState		pressed;
 	uint32_t			tick_max;
-	task_sensor_ev_t	signal_up;
-	task_sensor_ev_t	signal_down;
+	task_system_ev_t	signal_up;			// Eventos que recibe task_system
+	task_system_ev_t	signal_down;
+	uint32_t			repeat_delay;		// Ticks apretado hasta repetir, 0 no repite
+	uint32_t			repeat_period;		// Ticks entre repeticiones, en todos los niveles
+	task_system_ev_t	signal_repeat[SENSOR_REPEAT_LEVEL_QTY];	// Evento de cada nivel
 } task_sensor_cfg_t;
 
 typedef struct
@@ -114,6 +128,7 @@ typedef struct
 	uint32_t			tick;
 	task_sensor_st_t	state;
 	task_sensor_ev_t	event;
+	uint32_t			repeat_cnt;
 } task_sensor_dta_t;
 
 /********************** external data declaration ****************************/
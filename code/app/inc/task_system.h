@@ -47,15 +47,19 @@ extern "C" {
 
 /********************** macros ***********************************************/
 
+/* Scheduler release period & offset [ticks] */
+#define TASK_SYSTEM_PERIOD		(10ul)
+#define TASK_SYSTEM_OFFSET		(1ul)
+
 /********************** typedef **********************************************/
 
 /********************** external data declaration ****************************/
 extern uint32_t g_task_system_cnt;
-extern volatile uint32_t g_task_system_tick_cnt;
 
 /********************** external functions declaration ***********************/
 extern void task_system_init(void *parameters);
 extern void task_system_update(void *parameters);
+extern bool task_system_is_enabled(void);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
@@ -58,9 +58,14 @@ typedef enum task_system_ev {EV_SYS_ENT_IDLE,
 							 EV_SYS_PRE_ACTIVE,
 							 EV_SYS_ESC_IDLE,
 							 EV_SYS_ESC_ACTIVE,
+							 EV_SYS_NEX_ACTIVE_X5,		// Repetición acelerada: el mismo
+							 EV_SYS_NEX_ACTIVE_X10,		// botón, 5 o 10 pasos por evento
+							 EV_SYS_PRE_ACTIVE_X5,
+							 EV_SYS_PRE_ACTIVE_X10,
 							 EV_SYS_ENABLE_IDLE,
 							 EV_SYS_ENABLE_ACTIVE,
-							 EV_SYS_EXIT_MENU} task_system_ev_t;
+							 EV_SYS_EXIT_MENU,
+							 EV_SYS_ALARM_TRIP} task_system_ev_t;
 
 /* State of Task System */
 typedef enum task_system_st {ST_SYS_MENU_MODE,
@@ -75,6 +80,9 @@ typedef struct
 	bool				flag;
 
 	bool				enabled;
+	bool				awd_armed;		// Watchdog analógico del ADC armado
+	uint16_t			awd_low;		// Ventana armada, en cuentas del ADC
+	uint16_t			awd_high;
 } task_system_dta_t;
 
 /********************** external data declaration ****************************/
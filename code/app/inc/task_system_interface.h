@@ -56,6 +56,7 @@ extern "C" {
 /********************** external functions declaration ***********************/
 extern void init_queue_event_task_system(void);
 extern void put_event_task_system(task_system_ev_t event);
+extern void put_event_task_system_isr(task_system_ev_t event);
 extern task_system_ev_t get_event_task_system(void);
 extern bool any_event_task_system(void);
 
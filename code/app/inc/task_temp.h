@@ -17,15 +17,29 @@ extern "C" {
 
 /********************** macros ***********************************************/
 
+/* Scheduler release period & offset [ticks] */
+#define TASK_TEMP_PERIOD		(10ul)
+#define TASK_TEMP_OFFSET		(3ul)
+
 /********************** typedef **********************************************/
 
+/* Resultado del autoajuste, ganancias en décimas como en system_config_t */
+typedef struct
+{
+	uint32_t kp;
+	uint32_t ki;
+	uint32_t kd;
+	uint32_t hysteresis;		// Recomendada para el modo ON/OFF [0.1 °C]
+} temp_autotune_result_t;
+
 /********************** external data declaration ****************************/
 extern uint32_t g_task_temp_cnt;
-extern volatile uint32_t g_task_temp_tick_cnt;
 
 /********************** external functions declaration ***********************/
 extern void task_temp_init(void *parameters);
 extern void task_temp_update(void *parameters);
+extern bool task_temp_autotune_running(void);
+extern const temp_autotune_result_t *task_temp_autotune_result(void);
 
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
@@ -14,6 +14,9 @@ extern "C" {
 #endif
 
 /********************** inclusions *******************************************/
+#include "app.h"
+#include "pid.h"
+#include "task_temp.h"
 
 /********************** macros ***********************************************/
 
@@ -21,19 +24,38 @@ extern "C" {
 
 /* Events to excite Task Temp */
 typedef enum task_temp_ev {EV_TEMP_ENABLE_OFF,
-						   EV_TEMP_ENABLE_ON,} task_temp_ev_t;
+						   EV_TEMP_ENABLE_ON,
+						   EV_TEMP_AUTOTUNE,} task_temp_ev_t;
 
 /* State of Task Temp */
 typedef enum task_temp_st {ST_TEMP_OFF,
 	   	   	   	   	   	   ST_TEMP_IDLE,
 						   ST_TEMP_HEATING,
-						   ST_TEMP_COOLING,} task_temp_st_t;
+						   ST_TEMP_COOLING,
+						   ST_TEMP_PID,
+						   ST_TEMP_AUTOTUNE,} task_temp_st_t;
+
+/* Ensayo de relé (Åström-Hägglund) en curso */
+typedef struct
+{
+	uint32_t		start_tick;
+	uint32_t		on_tick;		// Último encendido del relé
+	uint32_t		cycles;			// Ciclos completos, el primero se descarta
+	uint32_t		period_sum;		// [ms]
+	uint32_t		amplitude_sum;	// Pico a pico [0.1 °C]
+	uint32_t		max;			// Extremos del ciclo en curso
+	uint32_t		min;
+	bool			relay_on;
+	temp_autotune_result_t result;	// Del último ensayo terminado
+} task_temp_autotune_t;
 
 typedef struct
 {
 	task_temp_st_t	state;
 	task_temp_ev_t	event;
 	bool			flag;
+	pid_dta_t		pid;
+	task_temp_autotune_t autotune;
 } task_temp_dta_t;
 
 /********************** external data declaration ****************************/
@@ -41,6 +63,12 @@ extern task_temp_dta_t task_temp_dta;
 
 /********************** external functions declaration ***********************/
 
+/* Una ejecución del statechart sobre una instancia, con el evento pendiente
+ * ya cargado en flag/event. No usa otro estado que el de p_task_temp_dta,
+ * así que se pueden simular varias en paralelo. now en [ms]. */
+extern void task_temp_statechart(task_temp_dta_t *p_task_temp_dta, const system_config_t *p_cfg,
+								 uint32_t temp, uint32_t now);
+
 /********************** End of CPP guard *************************************/
 #ifdef __cplusplus
 }
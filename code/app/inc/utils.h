@@ -26,8 +26,9 @@ extern "C" {
 /********************** external functions declaration ***********************/
 bool is_in_range(uint32_t value, uint32_t min, uint32_t max);
 
-uint32_t temp_raw_to_celsius(uint32_t temp_raw);
-uint32_t press_raw_to_kPa(uint32_t press_raw);
+uint32_t temp_raw_to_deci_celsius(uint32_t temp_raw);
+uint32_t press_raw_to_deci_kPa(uint32_t press_raw);
+uint16_t temp_deci_celsius_to_adc(uint32_t temp);
 
 void build_status_bar(char out_str[17], uint32_t temp, uint32_t press);
 
@@ -0,0 +1,74 @@
+/*
+ * @file   : adc_filter.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+#include "adc_filter.h"
+#include "task_adc.h"
+
+/********************** macros and definitions *******************************/
+
+/* Boxcar: suma de 16 muestras (16 bits), se descartan 2 bits.
+ * CIC2: ganancia R^2 = 256 (20 bits), se descartan 6 bits. */
+#define ADC_BOXCAR_SHIFT	(4 - ADC_EXTRA_BITS)
+#define ADC_CIC2_SHIFT		(8 - ADC_EXTRA_BITS)
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+
+void adc_filter_reset(adc_filter_dta_t *p_filter, adc_filter_t type)
+{
+	p_filter->type = type;
+	p_filter->integrator[0] = 0;
+	p_filter->integrator[1] = 0;
+	p_filter->comb[0] = 0;
+	p_filter->comb[1] = 0;
+}
+
+uint32_t adc_filter_block(adc_filter_dta_t *p_filter, const volatile uint16_t *p_sample, uint32_t stride)
+{
+	uint32_t scan;
+	uint32_t sum;
+	uint32_t c1;
+	uint32_t out;
+
+	if (ADC_FILTER_CIC2 == p_filter->type)
+	{
+		/* Integradores a la tasa de entrada. El desborde de uint32_t no
+		 * importa: los combs restan y el resultado final entra en 20 bits */
+		for (scan = 0; ADC_OVERSAMPLE > scan; scan++)
+		{
+			p_filter->integrator[0] += p_sample[scan * stride];
+			p_filter->integrator[1] += p_filter->integrator[0];
+		}
+
+		/* Combs a la tasa de salida */
+		c1 = p_filter->integrator[1] - p_filter->comb[0];
+		p_filter->comb[0] = p_filter->integrator[1];
+		out = (c1 - p_filter->comb[1]) >> ADC_CIC2_SHIFT;
+		p_filter->comb[1] = c1;
+	}
+	else
+	{
+		sum = 0;
+		for (scan = 0; ADC_OVERSAMPLE > scan; scan++)
+		{
+			sum += p_sample[scan * stride];
+		}
+		out = sum >> ADC_BOXCAR_SHIFT;
+	}
+
+	return out;
+}
+
+/********************** end of file ******************************************/
@@ -54,54 +54,151 @@
 #include "task_display.h"
 #include "task_temp.h"
 #include "task_press.h"
+#include "task_console.h"
+#include "task_recipe.h"
 #include "eeprom.h"
 
 /********************** macros and definitions *******************************/
 #define G_APP_CNT_INI		0ul
 #define G_APP_TICK_CNT_INI	0ul
+#define G_APP_TICK_INI		0ul
+
+/* Ventana de medición de carga de CPU [ticks] */
+#define APP_LOAD_WINDOW_TICKS	1000ul
+#define APP_LOAD_FULL_SCALE		1000ul	// Carga en décimas de %
 
-#define TASK_X_WCET_INI		0ul
 #define TASK_X_DELAY_MIN	0ul
 
+/* Ciclos de CPU por tick del scheduler (1 tick = 1 ms) */
+#define APP_CYCLES_PER_TICK	(SystemCoreClock / 1000ul)
+
+/* Histograma log2: el bin k cuenta ejecuciones de [2^k, 2^(k+1)) ciclos,
+ * el último bin acumula todo lo que sea más largo */
+#define TASK_STATS_HIST_BINS	16ul
+
+/* Qué hacer con los releases atrasados después de un bloqueo */
+typedef enum {
+	TASK_CATCHUP_ALL,		// Ejecutar todos los releases perdidos
+	TASK_CATCHUP_CAP,		// Ejecutar como máximo catchup_max, saltear el resto
+	TASK_CATCHUP_SKIP,		// Descartar los atrasados y ejecutar solo el actual
+} task_catchup_t;
+
 typedef struct {
+	const char *name;				// Name reported by the statistics
 	void (*task_init)(void *);		// Pointer to task (must be a
 									// 'void (void *)' function)
 	void (*task_update)(void *);	// Pointer to task (must be a
 									// 'void (void *)' function)
 	void *parameters;				// Pointer to parameters
+	uint32_t period;				// Release period (ticks)
+	uint32_t offset;				// First release (ticks), spreads tasks
+	task_catchup_t catchup;			// Catch-up policy after an overrun
+	uint32_t catchup_max;			// Max releases replayed (TASK_CATCHUP_CAP)
 } task_cfg_t;
 
 typedef struct {
-    uint32_t WCET;				// Worst-case execution time (microseconds)
+	uint32_t count;				// Executions measured
+	uint32_t min_cycles;		// Best-case execution time (cycles)
+	uint32_t max_cycles;		// Worst-case execution time (cycles)
+	uint64_t sum_cycles;		// Sum of execution times, for the mean
+	uint32_t max_jitter;		// Worst release jitter (cycles)
+	uint64_t sum_jitter;		// Sum of release jitters, for the mean
+	uint32_t hist[TASK_STATS_HIST_BINS];	// log2 histogram of execution times
+} task_stats_t;
+
+typedef struct {
+    uint32_t next_release;		// Next release time (ticks)
+    uint32_t overrun_cnt;		// Updates that found more than one release due
+    uint32_t overrun_tick;		// Time of the last overrun (ticks)
+    uint32_t skipped_cnt;		// Releases dropped by the catch-up policy
+    task_stats_t stats;			// Execution time & jitter statistics
 } task_dta_t;
 
 /********************** internal data declaration ****************************/
 
-shared_data_type shared_data;
+sensor_frame_t sensor_frame_buffer[2];
+system_config_t system_config_buffer[2];
+setpoint_frame_t setpoint_frame_buffer[2];
+
+shared_data_type shared_data = {
+		.sensor		= SNAPSHOT_INIT(sensor_frame_buffer),
+		.cfg		= SNAPSHOT_INIT(system_config_buffer),
+		.setpoint	= SNAPSHOT_INIT(setpoint_frame_buffer),
+};
 
 
 const task_cfg_t task_cfg_list[]	= {
-		{task_sensor_init, 		task_sensor_update, 	NULL},
-		{task_system_init, 		task_system_update, 	&shared_data},
-		{task_temp_init, 		task_temp_update, 		&shared_data},
-		{task_press_init, 		task_press_update, 		&shared_data},
-		{task_actuator_init,	task_actuator_update, 	NULL},
-		{task_adc_init,			task_adc_update, 		&shared_data},
-		{task_display_init,		task_display_update, 	NULL},
-		{task_menu_init,		task_menu_update, 		&shared_data},
+		{"sensor",
+		 task_sensor_init, 		task_sensor_update, 	NULL,
+		 TASK_SENSOR_PERIOD,	TASK_SENSOR_OFFSET,
+		 TASK_CATCHUP_SKIP,	0},
+		{"system",
+		 task_system_init, 		task_system_update, 	&shared_data,
+		 TASK_SYSTEM_PERIOD,	TASK_SYSTEM_OFFSET,
+		 TASK_CATCHUP_SKIP,	0},
+		{"recipe",
+		 task_recipe_init,		task_recipe_update, 	&shared_data,
+		 TASK_RECIPE_PERIOD,	TASK_RECIPE_OFFSET,
+		 TASK_CATCHUP_SKIP,	0},
+		{"temp",
+		 task_temp_init, 		task_temp_update, 		&shared_data,
+		 TASK_TEMP_PERIOD,		TASK_TEMP_OFFSET,
+		 TASK_CATCHUP_SKIP,	0},
+		{"press",
+		 task_press_init, 		task_press_update, 		&shared_data,
+		 TASK_PRESS_PERIOD,		TASK_PRESS_OFFSET,
+		 TASK_CATCHUP_SKIP,	0},
+		{"actuator",
+		 task_actuator_init,	task_actuator_update, 	NULL,
+		 TASK_ACTUATOR_PERIOD,	TASK_ACTUATOR_OFFSET,
+		 TASK_CATCHUP_ALL,		0},
+		{"adc",
+		 task_adc_init,			task_adc_update, 		&shared_data,
+		 TASK_ADC_PERIOD,		TASK_ADC_OFFSET,
+		 TASK_CATCHUP_SKIP,	0},
+		{"display",
+		 task_display_init,		task_display_update, 	NULL,
+		 TASK_DISPLAY_PERIOD,	TASK_DISPLAY_OFFSET,
+		 TASK_CATCHUP_CAP,		8},
+		{"menu",
+		 task_menu_init,		task_menu_update, 		&shared_data,
+		 TASK_MENU_PERIOD,		TASK_MENU_OFFSET,
+		 TASK_CATCHUP_SKIP,	0},
+		{"console",
+		 task_console_init,		task_console_update, 	NULL,
+		 TASK_CONSOLE_PERIOD,	TASK_CONSOLE_OFFSET,
+		 TASK_CATCHUP_SKIP,	0},
 };
 
 #define TASK_QTY	(sizeof(task_cfg_list)/sizeof(task_cfg_t))
 
 /********************** internal functions declaration ***********************/
+void app_update_cpu_load(void);
+void app_stats_clear(task_stats_t *p_stats);
+void app_stats_record(task_stats_t *p_stats, uint32_t cycles, uint32_t jitter);
 
 /********************** internal data definition *****************************/
 const char *p_sys	= " Bare Metal - Event-Triggered Systems (ETS)\r\n";
 const char *p_app	= " App - Model Integration\r\n";
 
+/* Acumuladores de la ventana de carga en curso */
+uint32_t app_busy_cycles;
+uint32_t app_load_window_start;
+
+/* Marca del CYCCNT tomada en el último tick */
+volatile uint32_t app_tick_cycles;
+
+/* Pedido de reset de estadísticas, se atiende al inicio del próximo update */
+volatile bool app_stats_reset_request;
+
 /********************** external data declaration ****************************/
 uint32_t g_app_cnt;
 uint32_t g_app_time_us;
+uint32_t g_app_tick;
+uint32_t g_app_idle_time_us;
+uint32_t g_app_cpu_load;
+uint32_t g_app_overrun_cnt;
+uint32_t g_app_overrun_tick;
 
 volatile uint32_t g_app_tick_cnt;
 
@@ -114,7 +211,7 @@ void app_init(void)
 
 	/* Print out: Application Initialized */
 	LOGGER_LOG("\r\n");
-	LOGGER_LOG("%s is running - Tick [mS] = %lu\r\n", GET_NAME(app_init), HAL_GetTick());
+	LOGGER_LOG("%s is running - Tick [mS] = %" PRIu32 "\r\n", GET_NAME(app_init), HAL_GetTick());
 
 	LOGGER_LOG(p_sys);
 	LOGGER_LOG(p_app);
@@ -122,7 +219,7 @@ void app_init(void)
 	g_app_cnt = G_APP_CNT_INI;
 
 	/* Print out: Application execution counter */
-	LOGGER_LOG(" %s = %lu\r\n", GET_NAME(g_app_cnt), g_app_cnt);
+	LOGGER_LOG(" %s = %" PRIu32 "\r\n", GET_NAME(g_app_cnt), g_app_cnt);
 
 	/* Go through the task arrays */
 	for (index = 0; TASK_QTY > index; index++)
@@ -131,75 +228,303 @@ void app_init(void)
 		(*task_cfg_list[index].task_init)(task_cfg_list[index].parameters);
 
 		/* Init variables */
-		task_dta_list[index].WCET = TASK_X_WCET_INI;
+		app_stats_clear(&task_dta_list[index].stats);
+		task_dta_list[index].next_release = task_cfg_list[index].offset;
+		task_dta_list[index].overrun_cnt = 0;
+		task_dta_list[index].overrun_tick = 0;
+		task_dta_list[index].skipped_cnt = 0;
 	}
 
-	// Como la inicialización tarda decenas de ms,
-	// estos valores se actualizan con el callback a números grandes
-	// antes de la primera llamada a task_*_update().
-	// Esto hace que el primer update tome demasiado tiempo ejecutando muchas veces
-	// las actualizaciones. En lugar de que ocurra eso, seteamos a cero los tick_cnt
-	// justo antes de empezar a hacer el primer update.
+	// Como la inicialización tarda decenas de ms, el callback acumula
+	// muchos ticks antes del primer update y todas las tareas los
+	// recuperarían de golpe. En lugar de que ocurra eso, arrancamos el
+	// tiempo del scheduler en cero justo antes de empezar.
 	__asm("CPSID i");	/* disable interrupts*/
-	g_app_tick_cnt = 0;
-	g_task_sensor_tick_cnt = 0;
-	g_task_system_tick_cnt = 0;
-	g_task_actuator_tick_cnt = 0;
-	g_task_menu_tick_cnt = 0;
-	g_task_display_tick_cnt = 0;
-	g_task_temp_tick_cnt = 0;
-	g_task_press_tick_cnt = 0;
+	g_app_tick_cnt = G_APP_TICK_CNT_INI;
+	g_app_tick = G_APP_TICK_INI;
     __asm("CPSIE i");	/* enable interrupts*/
 
+	g_app_idle_time_us = 0;
+	g_app_cpu_load = 0;
+	app_busy_cycles = 0;
+	app_load_window_start = G_APP_TICK_INI;
+	app_stats_reset_request = false;
+	g_app_overrun_cnt = 0;
+	g_app_overrun_tick = 0;
+
 	cycle_counter_init();
 }
 
 void app_update(void)
 {
 	uint32_t index;
-	uint32_t cycle_counter_time_us;
+	uint32_t tick_cnt;
+	uint32_t tick_cycles;
+	uint32_t release;
+	uint32_t release_cycles;
+	uint32_t backlog;
+	uint32_t runs;
+	uint32_t update_start;
+	uint32_t task_start;
+	uint32_t task_cycles;
+
+	/* Protect shared resource (g_app_tick_cnt & app_tick_cycles) */
+	__asm("CPSID i");	/* disable interrupts*/
+	tick_cnt = g_app_tick_cnt;
+	tick_cycles = app_tick_cycles;
+	g_app_tick_cnt = G_APP_TICK_CNT_INI;
+	__asm("CPSIE i");	/* enable interrupts*/
 
 	/* Check if it's time to run tasks */
-	if (G_APP_TICK_CNT_INI < g_app_tick_cnt)
+	if (G_APP_TICK_CNT_INI < tick_cnt)
     {
-    	g_app_tick_cnt--;
+		update_start = cycle_counter_get();
 
-    	/* Update App Counter */
+    	/* Update App Counter & Time */
     	g_app_cnt++;
+    	g_app_tick += tick_cnt;
     	g_app_time_us = 0;
 
-    	/* Go through the task arrays */
+    	if (true == app_stats_reset_request)
+    	{
+    		app_stats_reset_request = false;
+    		for (index = 0; TASK_QTY > index; index++)
+    		{
+    			app_stats_clear(&task_dta_list[index].stats);
+    		}
+    	}
+
+    	/* Go through the task arrays, running only the released tasks */
     	for (index = 0; TASK_QTY > index; index++)
     	{
-			cycle_counter_reset();
+    		if ((int32_t)(g_app_tick - task_dta_list[index].next_release) < 0)
+    		{
+    			continue;
+    		}
+
+    		/* Releases vencidos desde el último update, incluido el actual */
+    		backlog = (g_app_tick - task_dta_list[index].next_release)
+    					/ task_cfg_list[index].period + 1;
+    		runs = backlog;
+
+    		if (1 < backlog)
+    		{
+    			/* Overrun: la tarea no pudo correr en alguno de sus releases */
+    			task_dta_list[index].overrun_cnt++;
+    			task_dta_list[index].overrun_tick = g_app_tick;
+    			g_app_overrun_cnt++;
+    			g_app_overrun_tick = g_app_tick;
+
+    			if (TASK_CATCHUP_SKIP == task_cfg_list[index].catchup)
+    			{
+    				runs = 1;
+    			}
+    			else if ((TASK_CATCHUP_CAP == task_cfg_list[index].catchup)
+    					&& (task_cfg_list[index].catchup_max < runs))
+    			{
+    				runs = task_cfg_list[index].catchup_max;
+    			}
+
+    			/* Se descartan los releases más viejos */
+    			task_dta_list[index].skipped_cnt += backlog - runs;
+    			task_dta_list[index].next_release +=
+    					(backlog - runs) * task_cfg_list[index].period;
+    		}
+
+    		for (; 0 < runs; runs--)
+    		{
+    			release = task_dta_list[index].next_release;
+    			task_dta_list[index].next_release += task_cfg_list[index].period;
+
+    			/* tick_cycles es el instante del tick g_app_tick, se retrocede
+    			 * hasta el tick en que la tarea debía arrancar */
+    			release_cycles = tick_cycles - (g_app_tick - release) * APP_CYCLES_PER_TICK;
+
+				task_start = cycle_counter_get();
+
+				/* Run task_x_update */
+				(*task_cfg_list[index].task_update)(task_cfg_list[index].parameters);
+
+				task_cycles = cycle_counter_get() - task_start;
+
+				/* Update variables */
+				g_app_time_us += task_cycles / cycles_per_us;
+
+				app_stats_record(&task_dta_list[index].stats, task_cycles,
+								 task_start - release_cycles);
+    		}
+	    }
+
+    	/* El CYCCNT se detiene mientras el core duerme en WFI, así que solo
+    	 * mide tiempo ocupado: el de este update sale por diferencia. Por lo
+    	 * mismo vale retroceder release_cycles desde tick_cycles: un release
+    	 * solo se atrasa con el core ocupado, nunca mientras duerme */
+    	app_busy_cycles += cycle_counter_get() - update_start;
 
-    		/* Run task_x_update */
-			(*task_cfg_list[index].task_update)(task_cfg_list[index].parameters);
+    	app_update_cpu_load();
+    }
+}
 
-			cycle_counter_time_us = cycle_counter_time_us();
+void app_idle(void)
+{
+	/* Con las interrupciones deshabilitadas, un tick que llegue entre la
+	 * verificación y el WFI queda pendiente y despierta al core igual */
+	__asm("CPSID i");	/* disable interrupts*/
+	if (G_APP_TICK_CNT_INI == g_app_tick_cnt)
+	{
+		__asm("WFI");
+	}
+	__asm("CPSIE i");	/* enable interrupts*/
+}
 
-			/* Update variables */
-	    	g_app_time_us += cycle_counter_time_us;
+void app_stats_reset(void)
+{
+	app_stats_reset_request = true;
+}
 
-			if (task_dta_list[index].WCET < cycle_counter_time_us)
-			{
-				task_dta_list[index].WCET = cycle_counter_time_us;
-			}
-	    }
-    }
+uint32_t app_stats_line_qty(void)
+{
+	/* Una línea de carga general y dos por tarea */
+	return 1 + 2 * TASK_QTY;
+}
+
+int app_stats_line(uint32_t line, char *buf, size_t size)
+{
+	const task_stats_t *p_stats;
+	uint32_t count;
+	uint32_t first;
+	uint32_t last;
+	uint32_t bin;
+	int len;
+
+	if (0 == line)
+	{
+		return snprintf(buf, size, "load %" PRIu32 ".%" PRIu32 "%% idle %" PRIu32 "us/s\r\n",
+						g_app_cpu_load / 10, g_app_cpu_load % 10, g_app_idle_time_us);
+	}
+
+	line--;
+	if ((2 * TASK_QTY) <= line)
+	{
+		return 0;
+	}
+
+	p_stats = &task_dta_list[line / 2].stats;
+	count = p_stats->count;
+
+	if (0 == count)
+	{
+		/* Sin ejecuciones no hay histograma, la línea se omite */
+		return (0 == (line % 2)) ?
+				snprintf(buf, size, "%-8s no runs\r\n", task_cfg_list[line / 2].name) : 0;
+	}
+
+	/* Línea par: min/media/max y jitter en us */
+	if (0 == (line % 2))
+	{
+		return snprintf(buf, size, "%-8s n %" PRIu32 " t %" PRIu32 "/%" PRIu32 "/%" PRIu32 " jit %" PRIu32 "/%" PRIu32 " us ovr %" PRIu32 "@%" PRIu32 " skip %" PRIu32 "\r\n",
+						task_cfg_list[line / 2].name, count,
+						p_stats->min_cycles / cycles_per_us,
+						(uint32_t)(p_stats->sum_cycles / count) / cycles_per_us,
+						p_stats->max_cycles / cycles_per_us,
+						(uint32_t)(p_stats->sum_jitter / count) / cycles_per_us,
+						p_stats->max_jitter / cycles_per_us,
+						task_dta_list[line / 2].overrun_cnt,
+						task_dta_list[line / 2].overrun_tick,
+						task_dta_list[line / 2].skipped_cnt);
+	}
+
+	/* Línea impar: histograma, solo el rango de bins no vacíos */
+	first = 0;
+	while (0 == p_stats->hist[first])
+	{
+		first++;
+	}
+	last = TASK_STATS_HIST_BINS - 1;
+	while (0 == p_stats->hist[last])
+	{
+		last--;
+	}
+
+	len = snprintf(buf, size, "  hist 2^%" PRIu32 ":", first);
+	for (bin = first; (bin <= last) && (0 <= len) && ((size_t)len < size); bin++)
+	{
+		len += snprintf(buf + len, size - len, " %" PRIu32, p_stats->hist[bin]);
+	}
+	if ((0 <= len) && ((size_t)len < size))
+	{
+		len += snprintf(buf + len, size - len, "\r\n");
+	}
+
+	return len;
+}
+
+void app_stats_clear(task_stats_t *p_stats)
+{
+	memset(p_stats, 0, sizeof(task_stats_t));
+	p_stats->min_cycles = UINT32_MAX;
+}
+
+void app_stats_record(task_stats_t *p_stats, uint32_t cycles, uint32_t jitter)
+{
+	uint32_t bin;
+
+	p_stats->count++;
+	p_stats->sum_cycles += cycles;
+	p_stats->sum_jitter += jitter;
+
+	if (p_stats->min_cycles > cycles)
+	{
+		p_stats->min_cycles = cycles;
+	}
+	if (p_stats->max_cycles < cycles)
+	{
+		p_stats->max_cycles = cycles;
+	}
+	if (p_stats->max_jitter < jitter)
+	{
+		p_stats->max_jitter = jitter;
+	}
+
+	/* floor(log2(cycles)), con el último bin como tope */
+	bin = (0 == cycles) ? 0 : (31ul - __CLZ(cycles));
+	if (TASK_STATS_HIST_BINS <= bin)
+	{
+		bin = TASK_STATS_HIST_BINS - 1;
+	}
+	p_stats->hist[bin]++;
+}
+
+void app_update_cpu_load(void)
+{
+	uint32_t window_us;
+	uint32_t busy_us;
+
+	if (APP_LOAD_WINDOW_TICKS > (g_app_tick - app_load_window_start))
+	{
+		return;
+	}
+
+	// El tiempo ocioso no se mide: se descuenta el tiempo ocupado del largo
+	// de la ventana (1 tick = 1 ms).
+	window_us = (g_app_tick - app_load_window_start) * 1000ul;
+	busy_us = app_busy_cycles / cycles_per_us;
+	if (busy_us > window_us)
+	{
+		busy_us = window_us;
+	}
+
+	g_app_idle_time_us = window_us - busy_us;
+	g_app_cpu_load = (busy_us * APP_LOAD_FULL_SCALE) / window_us;
+
+	app_busy_cycles = 0;
+	app_load_window_start = g_app_tick;
 }
 
 void HAL_SYSTICK_Callback(void)
 {
 	g_app_tick_cnt++;
-
-	g_task_sensor_tick_cnt++;
-	g_task_system_tick_cnt++;
-	g_task_actuator_tick_cnt++;
-	g_task_menu_tick_cnt++;
-	g_task_display_tick_cnt++;
-	g_task_temp_tick_cnt++;
-	g_task_press_tick_cnt++;
+	app_tick_cycles = cycle_counter_get();
 }
 
 /********************** end of file ******************************************/
@@ -24,8 +24,6 @@ static uint32_t write_start_tick = 0;
 
 /********************** internal functions declaration ***********************/
 
-static bool eeprom_is_busy(void);
-
 /********************** internal data definition *****************************/
 
 /********************** external data declaration ****************************/
@@ -35,7 +33,7 @@ extern I2C_HandleTypeDef hi2c1;
 /********************** external functions definition ************************/
 
 // La escritura se tiene que hacer de forma asíncrona porque ocurre durante los updates.
-HAL_StatusTypeDef eeprom_write_async(uint8_t offset, void *data, size_t size)
+HAL_StatusTypeDef eeprom_write_async(uint16_t offset, void *data, size_t size)
 {
     if (eeprom_is_busy())
     {
@@ -55,12 +53,12 @@ HAL_StatusTypeDef eeprom_write_async(uint8_t offset, void *data, size_t size)
 }
 
 // La lectura puede ser bloqueante porque solo ocurre al principio
-void eeprom_read(uint8_t offset, void *data, size_t size)
+void eeprom_read(uint16_t offset, void *data, size_t size)
 {
 	HAL_I2C_Mem_Read(&hi2c1, EEEPROM_I2C_ADDRESS, offset, I2C_MEMADD_SIZE_16BIT, data, size, EEPROM_TIMEOUT_MS);
 }
 
-static bool eeprom_is_busy(void) {
+bool eeprom_is_busy(void) {
     if (eeprom_writing)
     {
         if ((HAL_GetTick() - write_start_tick) >= EEPROM_INTERNAL_WRITE_MS)
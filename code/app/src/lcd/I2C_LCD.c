@@ -12,7 +12,6 @@
 
 #include "lcd/I2C_LCD.h"
 #include "lcd/I2C_LCD_cfg.h"
-#include "lcd/Util.h"
 
 /*-----------------------[INTERNAL DEFINITIONS]-----------------------*/
 // CMD
@@ -61,17 +60,51 @@ typedef struct I2C_LCD_InfoParam_s
 {
     uint8_t DisplayCtrl;
     uint8_t BacklightVal;
+    uint8_t InitIndex;	// Próximo comando de I2C_LCD_InitSeq
+    uint8_t InitWait;	// ms a esperar con la cola vacía antes de seguir
+    uint32_t InitMark;	// Último tick en que la cola estaba ocupada
+    bool InitDone;	// false también mientras se espera un Clear
 }I2C_LCD_InfoParam_t;
 
+typedef struct I2C_LCD_InitCmd_s
+{
+    uint8_t Cmd;
+    uint8_t WaitMs;	// 0: el siguiente sale en la misma transferencia
+}I2C_LCD_InitCmd_t;
+
 static I2C_LCD_InfoParam_t I2C_LCD_InfoParam_g[I2C_LCD_MAX];
 
 static I2C_LCD_Queue_t lcd_queue_list[I2C_LCD_MAX];
 
+// La secuencia de la hoja de datos. Las esperas se cuentan desde que la cola
+// se vació con resolución de 1 ms, por eso cada una tiene 1 ms de más.
+#define I2C_LCD_CLEAR_MS	3	// > 1.52ms
+
+static const I2C_LCD_InitCmd_t I2C_LCD_InitSeq[] = {
+    {0x30, 6},	// > 4.1ms
+    {0x30, 6},	// > 4.1ms
+    {0x30, 2},	// > 100us
+    {0x02, 0},
+    {LCD_FUNCTIONSET | LCD_4BITMODE | LCD_2LINE | LCD_5x8DOTS, 0},
+    {LCD_DISPLAYCONTROL | LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF, 0},
+    {LCD_ENTRYMODESET | LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT, 0},
+    {LCD_CLEARDISPLAY, I2C_LCD_CLEAR_MS},
+};
+
+#define I2C_LCD_INIT_QTY	(sizeof(I2C_LCD_InitSeq) / sizeof(I2C_LCD_InitSeq[0]))
+
+// According To Datasheet, We Must Wait At Least 40ms After Power Up Before Interacting With The LCD Module
+#define I2C_LCD_POWER_UP_MS	50
+
 /*---------------------[STATIC INTERNAL FUNCTIONS]-----------------------*/
 
-static uint8_t i2c_tx_buffer[4];
+// 4 bytes por byte al LCD: el PCF8574 latchea cada uno, así que una ráfaga
+// sale en una sola escritura I2C sin STOP ni interrupción entre caracteres
+static uint8_t i2c_tx_buffer[LCD_TX_BATCH_SIZE * 4];
 
 static void I2C_LCD_Process_Next(uint8_t instance) {
+	uint16_t len = 0;
+
 	if (lcd_queue_list[instance].head == lcd_queue_list[instance].tail) {
 		lcd_queue_list[instance].is_busy = 0;
 		return;
@@ -79,37 +112,54 @@ static void I2C_LCD_Process_Next(uint8_t instance) {
 
 	lcd_queue_list[instance].is_busy = 1;
 
-	uint16_t item = lcd_queue_list[instance].buffer[lcd_queue_list[instance].tail];
-	lcd_queue_list[instance].tail = (lcd_queue_list[instance].tail + 1) % LCD_TX_BUFFER_SIZE;
+	uint8_t bl = I2C_LCD_InfoParam_g[instance].BacklightVal;
 
-	uint8_t value = (uint8_t)(item & 0x00FF);
-	uint8_t rs_bit = (uint8_t)((item >> 8) & RS);
+	// Entre dos pulsos de EN pasan al menos 2 bytes de bus (~180us a 100kHz),
+	// más que los 37us que necesitan SetCursor y WriteChar
+	while ((lcd_queue_list[instance].head != lcd_queue_list[instance].tail)
+			&& (sizeof(i2c_tx_buffer) > len)) {
+		const I2C_LCD_Item_t *item = &lcd_queue_list[instance].buffer[lcd_queue_list[instance].tail];
 
-	uint8_t high_nibble = value & 0xF0;
-	uint8_t low_nibble = (value << 4) & 0xF0;
-	uint8_t bl = I2C_LCD_InfoParam_g[instance].BacklightVal;
+		uint8_t value = (NULL == item->p_data) ? item->value
+						: (uint8_t)item->p_data[lcd_queue_list[instance].tail_offset];
+		uint8_t rs_bit = item->mode & RS;
 
-	// Estructura: [Nibble | Backlight | RS | EN/RW]
-	i2c_tx_buffer[0] = high_nibble | bl | rs_bit | EN; // Enable High
-	i2c_tx_buffer[1] = high_nibble | bl | rs_bit;      // Enable Low (Write)
+		// El item se libera recién cuando salió entero
+		if (item->len <= ++lcd_queue_list[instance].tail_offset) {
+			lcd_queue_list[instance].tail_offset = 0;
+			lcd_queue_list[instance].tail = (lcd_queue_list[instance].tail + 1) % LCD_TX_BUFFER_SIZE;
+		}
 
-	i2c_tx_buffer[2] = low_nibble  | bl | rs_bit | EN; // Enable High
-	i2c_tx_buffer[3] = low_nibble  | bl | rs_bit;      // Enable Low (Write)
+		uint8_t high_nibble = value & 0xF0;
+		uint8_t low_nibble = (value << 4) & 0xF0;
+
+		// Estructura: [Nibble | Backlight | RS | EN/RW]
+		i2c_tx_buffer[len++] = high_nibble | bl | rs_bit | EN; // Enable High
+		i2c_tx_buffer[len++] = high_nibble | bl | rs_bit;      // Enable Low (Write)
+
+		i2c_tx_buffer[len++] = low_nibble  | bl | rs_bit | EN; // Enable High
+		i2c_tx_buffer[len++] = low_nibble  | bl | rs_bit;      // Enable Low (Write)
+	}
 
-	HAL_I2C_Master_Transmit_IT(
+	HAL_I2C_Master_Transmit_DMA(
 		I2C_LCD_CfgParam[instance].I2C_Handle,
 		I2C_LCD_CfgParam[instance].I2C_LCD_Address << 1,
 		i2c_tx_buffer,
-		4
+		len
 	);
 }
 
-static void I2C_LCD_Push(uint8_t instance, uint8_t value, uint16_t type) {
+static void I2C_LCD_Push(uint8_t instance, const char *data, uint8_t len, uint8_t value, uint8_t mode) {
     uint16_t next_head = (lcd_queue_list[instance].head + 1) % LCD_TX_BUFFER_SIZE;
 
     // TODO: quizás habría que fallar de alguna forma si la cola está llena?
     if (next_head != lcd_queue_list[instance].tail) {
-    	lcd_queue_list[instance].buffer[lcd_queue_list[instance].head] = (uint16_t)value | (type << 8);
+    	I2C_LCD_Item_t *item = &lcd_queue_list[instance].buffer[lcd_queue_list[instance].head];
+
+    	item->p_data = data;
+    	item->len = len;
+    	item->value = value;
+    	item->mode = mode;
     	lcd_queue_list[instance].head = next_head;
     }
 
@@ -118,75 +168,76 @@ static void I2C_LCD_Push(uint8_t instance, uint8_t value, uint16_t type) {
     }
 }
 
-//  Solo para inicialización porque son bloqueantes
+/*-----------------------------------------------------------------------*/
 
-static void I2C_LCD_ExpanderWrite(uint8_t I2C_LCD_InstanceIndex, uint8_t DATA)
-{
-    uint8_t TxData = (DATA) | I2C_LCD_InfoParam_g[I2C_LCD_InstanceIndex].BacklightVal;
-    HAL_I2C_Master_Transmit(I2C_LCD_CfgParam[I2C_LCD_InstanceIndex].I2C_Handle, (I2C_LCD_CfgParam[I2C_LCD_InstanceIndex].I2C_LCD_Address<<1), &TxData, sizeof(TxData), 100);
+//=========================================================================================================================
 
-}
+/*-----------------------[USER EXTERNAL FUNCTIONS]-----------------------*/
 
-static void I2C_LCD_EnPulse(uint8_t I2C_LCD_InstanceIndex, uint8_t DATA)
+// No bloquea: la secuencia la van mandando las llamadas a I2C_LCD_InitStep()
+// por la cola, y hasta que devuelva true no hay que mandarle nada al LCD
+void I2C_LCD_Init(uint8_t I2C_LCD_InstanceIndex)
 {
-	I2C_LCD_ExpanderWrite(I2C_LCD_InstanceIndex, (DATA | EN)); // En high
-	DELAY_US(2); // enable pulse must be >450ns
-
-    I2C_LCD_ExpanderWrite(I2C_LCD_InstanceIndex, (DATA & ~EN)); // En low
-    DELAY_US(50); // commands need > 37us to settle
+    I2C_LCD_InfoParam_t *info = &I2C_LCD_InfoParam_g[I2C_LCD_InstanceIndex];
+
+    info->DisplayCtrl = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
+    info->BacklightVal = LCD_BACKLIGHT;
+    info->InitIndex = 0;
+    info->InitWait = I2C_LCD_POWER_UP_MS;
+    info->InitMark = 0;	// El tick arranca en 0 con el reset
+    info->InitDone = false;
 }
 
-static void I2C_LCD_Write4Bits(uint8_t I2C_LCD_InstanceIndex, uint8_t Val)
+bool I2C_LCD_InitStep(uint8_t I2C_LCD_InstanceIndex)
 {
-	I2C_LCD_ExpanderWrite(I2C_LCD_InstanceIndex, Val);
-	I2C_LCD_EnPulse(I2C_LCD_InstanceIndex, Val);
-}
+    I2C_LCD_InfoParam_t *info = &I2C_LCD_InfoParam_g[I2C_LCD_InstanceIndex];
+    uint32_t now = HAL_GetTick();
 
-static void I2C_LCD_Send(uint8_t I2C_LCD_InstanceIndex, uint8_t Val, uint8_t Mode)
-{
-    uint8_t HighNib = Val & 0xF0;
-    uint8_t LowNib = (Val << 4) & 0xF0;
-    I2C_LCD_Write4Bits(I2C_LCD_InstanceIndex, (HighNib) | Mode);
-    I2C_LCD_Write4Bits(I2C_LCD_InstanceIndex, (LowNib) | Mode);
-}
+    if (info->InitDone) {
+        return true;
+    }
 
-static void I2C_LCD_Cmd(uint8_t I2C_LCD_InstanceIndex, uint8_t CMD)
-{
-	I2C_LCD_Send(I2C_LCD_InstanceIndex, CMD, 0);
-}
+    if (lcd_queue_list[I2C_LCD_InstanceIndex].is_busy) {
+        info->InitMark = now;
+        return false;
+    }
 
-/*-----------------------------------------------------------------------*/
+    if ((now - info->InitMark) < info->InitWait) {
+        return false;
+    }
 
-//=========================================================================================================================
+    if (I2C_LCD_INIT_QTY <= info->InitIndex) {
+        info->InitDone = true;
+        return true;
+    }
 
-/*-----------------------[USER EXTERNAL FUNCTIONS]-----------------------*/
+    // Los comandos sin espera salen juntos en una transferencia
+    do {
+        I2C_LCD_Push(I2C_LCD_InstanceIndex, NULL, 1, I2C_LCD_InitSeq[info->InitIndex].Cmd, 0);
+        info->InitWait = I2C_LCD_InitSeq[info->InitIndex].WaitMs;
+        info->InitIndex++;
+    } while ((0 == info->InitWait) && (I2C_LCD_INIT_QTY > info->InitIndex));
 
-void I2C_LCD_Init(uint8_t I2C_LCD_InstanceIndex)
-{
-	// According To Datasheet, We Must Wait At Least 40ms After Power Up Before Interacting With The LCD Module
-	while(HAL_GetTick() < 50);
-    I2C_LCD_Cmd(I2C_LCD_InstanceIndex, 0x30);
-    DELAY_MS(5);  // Delay > 4.1ms
-    I2C_LCD_Cmd(I2C_LCD_InstanceIndex, 0x30);
-    DELAY_MS(5);  // Delay > 4.1ms
-    I2C_LCD_Cmd(I2C_LCD_InstanceIndex, 0x30);
-    DELAY_US(150);  // Delay > 100μs
-    I2C_LCD_Cmd(I2C_LCD_InstanceIndex, 0x02);
-    // Configure the LCD
-    I2C_LCD_Cmd(I2C_LCD_InstanceIndex, LCD_FUNCTIONSET | LCD_4BITMODE | LCD_2LINE | LCD_5x8DOTS);
-    I2C_LCD_Cmd(I2C_LCD_InstanceIndex, LCD_DISPLAYCONTROL | LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF);
-    I2C_LCD_Cmd(I2C_LCD_InstanceIndex, LCD_ENTRYMODESET | LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT);
-    I2C_LCD_InfoParam_g[I2C_LCD_InstanceIndex].DisplayCtrl = LCD_DISPLAYON | LCD_CURSOROFF | LCD_BLINKOFF;
-    I2C_LCD_InfoParam_g[I2C_LCD_InstanceIndex].BacklightVal = LCD_BACKLIGHT;
-    // Clear the LCD
-    I2C_LCD_Clear(I2C_LCD_InstanceIndex);
-}
+    info->InitMark = now;
 
+    return false;
+}
 
+// No bloquea: el comando va por la cola y la espera la cuenta
+// I2C_LCD_InitStep(), que devuelve false hasta que el LCD acepta otro
 void I2C_LCD_Clear(uint8_t I2C_LCD_InstanceIndex)
 {
-    I2C_LCD_Cmd(I2C_LCD_InstanceIndex, LCD_CLEARDISPLAY);
-    DELAY_MS(2);
+    I2C_LCD_InfoParam_t *info = &I2C_LCD_InfoParam_g[I2C_LCD_InstanceIndex];
+
+    // La secuencia de inicialización ya termina borrando
+    if (!info->InitDone) {
+        return;
+    }
+
+    I2C_LCD_Push(I2C_LCD_InstanceIndex, NULL, 1, LCD_CLEARDISPLAY, 0);
+    info->InitWait = I2C_LCD_CLEAR_MS;
+    info->InitMark = HAL_GetTick();
+    info->InitDone = false;
 }
 
 void I2C_LCD_SetCursor(uint8_t instance, uint8_t Col, uint8_t Row) {
@@ -198,11 +249,27 @@ void I2C_LCD_SetCursor(uint8_t instance, uint8_t Col, uint8_t Row) {
 
     uint8_t command = LCD_SETDDRAMADDR | (Col + Row_Offsets[Row]);
 
-    I2C_LCD_Push(instance, command, 0);
+    I2C_LCD_Push(instance, NULL, 1, command, 0);
 }
 
 void I2C_LCD_WriteChar(uint8_t instance, char Ch) {
-    I2C_LCD_Push(instance, (uint8_t)Ch, RS);
+    I2C_LCD_Push(instance, NULL, 1, (uint8_t)Ch, RS);
+}
+
+// Str se lee desde la interrupción del I2C: tiene que seguir valiendo hasta
+// que la tira salga, por ejemplo una cadena en flash o la fila de un buffer
+void I2C_LCD_WriteRun(uint8_t instance, const char* Str, uint8_t Len) {
+    if (0 < Len) {
+        I2C_LCD_Push(instance, Str, Len, 0, RS);
+    }
+}
+
+uint16_t I2C_LCD_TxFree(uint8_t instance) {
+    uint16_t used = (uint16_t)((lcd_queue_list[instance].head + LCD_TX_BUFFER_SIZE
+    							- lcd_queue_list[instance].tail) % LCD_TX_BUFFER_SIZE);
+
+    // Un lugar queda siempre vacío para distinguir llena de vacía
+    return (uint16_t)(LCD_TX_BUFFER_SIZE - 1 - used);
 }
 
 void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
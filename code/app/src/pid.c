@@ -0,0 +1,101 @@
+/*
+ * @file   : pid.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+#include "pid.h"
+
+/********************** macros and definitions *******************************/
+
+/* Con ganancias y medición en décimas y salida en 0.1 %:
+ *   P = kp * e / 10
+ *   I = ki * sum(e * dt_ms) / 10000
+ *   D = kd * de * 100 / dt_ms
+ * Todo entra en int32_t para los rangos que permite el menú. */
+#define PID_P_DIV			(10)
+#define PID_I_SCALE			(10000)
+#define PID_D_MUL			(100)
+
+/* Filtro de primer orden de la derivada, constante de tiempo 8 muestras */
+#define PID_D_FILTER_DIV	(8)
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+
+void pid_reset(pid_dta_t *p_pid)
+{
+	p_pid->i_acc = 0;
+	p_pid->d_filt = 0;
+	p_pid->prev_meas = 0;
+	p_pid->first = true;
+}
+
+// Forma paralela con la derivada sobre la medición, así un cambio de setpoint
+// no da un pico en la salida. Anti-windup por integración condicional: si la
+// salida satura, no se integra el error que la empuja más allá del límite.
+uint32_t pid_update(pid_dta_t *p_pid, const pid_cfg_t *p_cfg, int32_t setpoint, int32_t meas)
+{
+	int32_t out_max = (int32_t)p_cfg->out_max;
+	int32_t error = setpoint - meas;
+	int32_t p_term;
+	int32_t d_raw;
+	int32_t i_acc;
+	int32_t out;
+
+	p_term = ((int32_t)p_cfg->kp * error) / PID_P_DIV;
+
+	if (p_pid->first)
+	{
+		p_pid->first = false;
+		p_pid->prev_meas = meas;
+	}
+	d_raw = -((int32_t)p_cfg->kd * (meas - p_pid->prev_meas) * PID_D_MUL)
+			/ (int32_t)p_cfg->dt_ms;
+	p_pid->d_filt += (d_raw - p_pid->d_filt) / PID_D_FILTER_DIV;
+	p_pid->prev_meas = meas;
+
+	i_acc = p_pid->i_acc + (int32_t)p_cfg->ki * error * (int32_t)p_cfg->dt_ms;
+	if (i_acc < 0)
+	{
+		i_acc = 0;
+	}
+	else if (i_acc > out_max * PID_I_SCALE)
+	{
+		i_acc = out_max * PID_I_SCALE;
+	}
+
+	out = p_term + (i_acc / PID_I_SCALE) + p_pid->d_filt;
+
+	if (((out > out_max) && (error > 0)) || ((out < 0) && (error < 0)))
+	{
+		/* Saturada: se descarta el paso de integración */
+		out = p_term + (p_pid->i_acc / PID_I_SCALE) + p_pid->d_filt;
+	}
+	else
+	{
+		p_pid->i_acc = i_acc;
+	}
+
+	if (out < 0)
+	{
+		out = 0;
+	}
+	else if (out > out_max)
+	{
+		out = out_max;
+	}
+
+	return (uint32_t)out;
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,174 @@
+/*
+ * @file   : pwm.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+#include "main.h"
+#include "pwm.h"
+
+#include <stdbool.h>
+
+/********************** macros and definitions *******************************/
+
+/* TIM4 cuenta a 8 MHz / 800 = 10 kHz (MX_TIM4_Init) */
+#define PWM_TIM_TICKS_PER_MS	(10ul)
+
+typedef struct {
+	TIM_HandleTypeDef	*htim;
+	uint32_t			channel;		// Canal de comparación, sin salida
+	uint32_t			active_channel;	// El mismo canal como lo informa la ISR
+	GPIO_TypeDef		*gpio_port;
+	uint16_t			pin;
+	GPIO_PinState		act_on;
+	uint32_t			period_ms;
+	uint32_t			steps;			// Resolución: pasos de duty por período
+} pwm_cfg_t;
+
+/********************** internal data declaration ****************************/
+
+/* PWM lento por software: el pin del calefactor (PB5) no llega a ningún
+ * canal libre, así que TIM4 da la base de tiempo. El update enciende el pin
+ * y la comparación del canal 1 lo apaga. TIM3 queda solo para el ADC. */
+extern TIM_HandleTypeDef htim4;
+
+const pwm_cfg_t pwm_cfg_list[PWM_ID_QTY] = {
+	[PWM_ID_HEATER]	= {&htim4, TIM_CHANNEL_1, HAL_TIM_ACTIVE_CHANNEL_1,
+					   D4_GPIO_Port, D4_Pin, GPIO_PIN_RESET,
+					   PWM_HEATER_PERIOD_MS, PWM_HEATER_STEPS},
+};
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/* Duty cuantizado, en pasos de la resolución de cada salida */
+static volatile uint32_t pwm_step_list[PWM_ID_QTY];
+
+/* Trabada por el estado seguro: queda en cero hasta pwm_unlock() */
+static volatile bool pwm_locked_list[PWM_ID_QTY];
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+
+void pwm_init(void)
+{
+	uint32_t id;
+	const pwm_cfg_t *p_cfg;
+
+	for (id = 0; PWM_ID_QTY > id; id++)
+	{
+		p_cfg = &pwm_cfg_list[id];
+
+		pwm_step_list[id] = 0;
+		HAL_GPIO_WritePin(p_cfg->gpio_port, p_cfg->pin,
+						  (GPIO_PIN_SET == p_cfg->act_on) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+
+		__HAL_TIM_SET_AUTORELOAD(p_cfg->htim, p_cfg->period_ms * PWM_TIM_TICKS_PER_MS - 1);
+		__HAL_TIM_SET_COMPARE(p_cfg->htim, p_cfg->channel, 0);
+		__HAL_TIM_ENABLE_OCxPRELOAD(p_cfg->htim, p_cfg->channel);
+		HAL_TIM_Base_Start_IT(p_cfg->htim);
+		HAL_TIM_OC_Start_IT(p_cfg->htim, p_cfg->channel);
+	}
+}
+
+// Escribe un solo registro, se puede llamar desde una ISR. El CCR tiene
+// preload: el duty nuevo se aplica desde el próximo período, así un CCR por
+// debajo de la cuenta no saltea el apagado de este. El duty cero además
+// apaga el pin en el momento.
+void pwm_set_duty(pwm_id_t id, uint32_t duty)
+{
+	const pwm_cfg_t *p_cfg = &pwm_cfg_list[id];
+	uint32_t period = __HAL_TIM_GET_AUTORELOAD(p_cfg->htim) + 1;
+	uint32_t step;
+
+	if (true == pwm_locked_list[id])
+	{
+		duty = 0;
+	}
+	else if (PWM_DUTY_MAX < duty)
+	{
+		duty = PWM_DUTY_MAX;
+	}
+
+	step = (duty * p_cfg->steps + PWM_DUTY_MAX / 2) / PWM_DUTY_MAX;
+	pwm_step_list[id] = step;
+
+	/* Con step == steps el CCR pasa el ARR y la comparación nunca dispara */
+	__HAL_TIM_SET_COMPARE(p_cfg->htim, p_cfg->channel, (step * period) / p_cfg->steps);
+
+	/* Un pwm_lock() desde una ISR entre la lectura de arriba y el CCR ya
+	 * escribió su cero y este CCR lo pisó: se vuelve a poner en cero */
+	if (true == pwm_locked_list[id])
+	{
+		step = 0;
+		pwm_step_list[id] = 0;
+		__HAL_TIM_SET_COMPARE(p_cfg->htim, p_cfg->channel, 0);
+	}
+
+	if (0 == step)
+	{
+		HAL_GPIO_WritePin(p_cfg->gpio_port, p_cfg->pin,
+						  (GPIO_PIN_SET == p_cfg->act_on) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+	}
+}
+
+uint32_t pwm_get_duty(pwm_id_t id)
+{
+	return (pwm_step_list[id] * PWM_DUTY_MAX) / pwm_cfg_list[id].steps;
+}
+
+// Apaga la salida y la deja en cero aunque se pida otro duty. Se puede
+// llamar desde una ISR: un pwm_set_duty() interrumpido vuelve a mirar la
+// traba después de escribir el CCR y no deja su duty.
+void pwm_lock(pwm_id_t id)
+{
+	pwm_locked_list[id] = true;
+	pwm_set_duty(id, 0);
+}
+
+void pwm_unlock(pwm_id_t id)
+{
+	pwm_locked_list[id] = false;
+}
+
+/* Comienzo de período: enciende las salidas con duty */
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+	uint32_t id;
+	const pwm_cfg_t *p_cfg;
+
+	for (id = 0; PWM_ID_QTY > id; id++)
+	{
+		p_cfg = &pwm_cfg_list[id];
+
+		if ((htim == p_cfg->htim) && (0 < __HAL_TIM_GET_COMPARE(htim, p_cfg->channel)))
+		{
+			HAL_GPIO_WritePin(p_cfg->gpio_port, p_cfg->pin, p_cfg->act_on);
+		}
+	}
+}
+
+/* Fin del tiempo encendido */
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim)
+{
+	uint32_t id;
+	const pwm_cfg_t *p_cfg;
+
+	for (id = 0; PWM_ID_QTY > id; id++)
+	{
+		p_cfg = &pwm_cfg_list[id];
+
+		// Disparó el CCR activo, el que se lee es el de preload y puede ser otro
+		if ((htim == p_cfg->htim) && (p_cfg->active_channel == htim->Channel))
+		{
+			HAL_GPIO_WritePin(p_cfg->gpio_port, p_cfg->pin,
+							  (GPIO_PIN_SET == p_cfg->act_on) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+		}
+	}
+}
+
+/********************** end of file ******************************************/
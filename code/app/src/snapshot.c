@@ -0,0 +1,72 @@
+/*
+ * @file   : snapshot.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+#include "main.h"
+#include "snapshot.h"
+
+#include <string.h>
+
+/********************** macros and definitions *******************************/
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+
+void snapshot_publish(snapshot_t *p_snapshot, const void *p_value)
+{
+	uint8_t back = p_snapshot->front ^ 1u;
+
+	p_snapshot->seq++;
+	__DMB();
+
+	memcpy(&p_snapshot->buffer[back * p_snapshot->size], p_value, p_snapshot->size);
+
+	/* El buffer tiene que quedar escrito antes de publicarlo */
+	__DMB();
+	p_snapshot->front = back;
+	__DMB();
+	p_snapshot->seq++;
+}
+
+// Con el escritor en el mismo contexto que el lector nunca reintenta. Si el
+// escritor es una ISR alcanza con que la copia dure menos que su período.
+void snapshot_read(snapshot_t *p_snapshot, void *p_value)
+{
+	uint32_t seq;
+
+	for (;;)
+	{
+		seq = p_snapshot->seq;
+		__DMB();
+		memcpy(p_value, &p_snapshot->buffer[p_snapshot->front * p_snapshot->size],
+			   p_snapshot->size);
+		__DMB();
+
+		/* Una sola publicación escribe el otro buffer, recién la segunda
+		 * puede pisar el que se estaba copiando */
+		if (2 > (uint32_t)(p_snapshot->seq - seq))
+		{
+			return;
+		}
+		p_snapshot->retry_cnt++;
+	}
+}
+
+// Publicaciones completas desde el arranque, 0 si todavía no hay valor
+uint32_t snapshot_count(const snapshot_t *p_snapshot)
+{
+	return p_snapshot->seq / 2;
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,89 @@
+/*
+ * @file   : spsc_queue.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+#include "main.h"
+#include "spsc_queue.h"
+
+/********************** macros and definitions *******************************/
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+
+// Vacía la cola. Los contadores de diagnóstico se conservan.
+void spsc_queue_init(spsc_queue_t *p_queue)
+{
+	p_queue->head = 0;
+	p_queue->tail = 0;
+}
+
+// Si la cola está llena el elemento nuevo se descarta y se cuenta,
+// los que ya estaban pendientes no se pisan.
+bool spsc_queue_put(spsc_queue_t *p_queue, uint8_t item)
+{
+	uint16_t head = p_queue->head;
+	uint16_t count = (uint16_t)(head - p_queue->tail);
+
+	if (count > p_queue->mask)
+	{
+		p_queue->overflow_cnt++;
+		return false;
+	}
+
+	p_queue->buffer[head & p_queue->mask] = item;
+
+	/* El dato tiene que quedar escrito antes de publicar el head */
+	__DMB();
+	p_queue->head = (uint16_t)(head + 1);
+
+	count++;
+	if (p_queue->high_water < count)
+	{
+		p_queue->high_water = count;
+	}
+
+	return true;
+}
+
+bool spsc_queue_get(spsc_queue_t *p_queue, uint8_t *p_item)
+{
+	uint16_t tail = p_queue->tail;
+
+	if (tail == p_queue->head)
+	{
+		return false;
+	}
+
+	/* Leer el dato recién después de ver el head publicado */
+	__DMB();
+	*p_item = p_queue->buffer[tail & p_queue->mask];
+
+	/* Y liberar la posición recién después de leerlo */
+	__DMB();
+	p_queue->tail = (uint16_t)(tail + 1);
+
+	return true;
+}
+
+bool spsc_queue_any(const spsc_queue_t *p_queue)
+{
+	return (p_queue->head != p_queue->tail);
+}
+
+uint16_t spsc_queue_count(const spsc_queue_t *p_queue)
+{
+	return (uint16_t)(p_queue->head - p_queue->tail);
+}
+
+/********************** end of file ******************************************/
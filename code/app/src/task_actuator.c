@@ -52,46 +52,69 @@
 
 /********************** macros and definitions *******************************/
 #define G_TASK_ACT_CNT_INIT			0ul
-#define G_TASK_ACT_TICK_CNT_INI		0ul
 
 #define DEL_ACT_XX_BLI				500ul
+#define DEL_ACT_XX_PUL				200ul
 #define DEL_ACT_XX_MIN				0ul
 
+/* Límites contra el ciclado corto, en ms */
+#define ACT_PUMP_MIN_ON				10000ul
+#define ACT_PUMP_MIN_OFF			30000ul
+#define ACT_PUMP_MAX_STARTS			6u
+#define ACT_COOLER_MIN_ON			60000ul
+#define ACT_COOLER_MIN_OFF			180000ul
+#define ACT_COOLER_MAX_STARTS		6u
+#define ACT_START_WINDOW			3600000ul	// 1 hora
+
 /********************** internal data declaration ****************************/
+/* Mismo orden que task_actuator_id_t, el identificador indexa ambas listas */
 const task_actuator_cfg_t task_actuator_cfg_list[] = {
-		{ID_ACT_COOLER,  D5_GPIO_Port,  D5_Pin, GPIO_PIN_RESET,  GPIO_PIN_SET,
-		 DEL_ACT_XX_BLI},
-		{ID_ACT_HEATER,  D4_GPIO_Port,  D4_Pin, GPIO_PIN_RESET,  GPIO_PIN_SET,
-		 DEL_ACT_XX_BLI},
 		{ID_ACT_PUMP,  D7_GPIO_Port,  D7_Pin, GPIO_PIN_RESET,  GPIO_PIN_SET,
-		 DEL_ACT_XX_BLI},
+		 DEL_ACT_XX_BLI, DEL_ACT_XX_PUL, true, PWM_ID_NONE,
+		 ACT_PUMP_MIN_ON, ACT_PUMP_MIN_OFF, ACT_PUMP_MAX_STARTS, ACT_START_WINDOW},
 		{ID_ACT_VALVE,  D8_GPIO_Port,  D8_Pin, GPIO_PIN_RESET,  GPIO_PIN_SET,
-		 DEL_ACT_XX_BLI},
+		 DEL_ACT_XX_BLI, DEL_ACT_XX_PUL, true, PWM_ID_NONE,
+		 0, 0, 0, 0},
+		{ID_ACT_COOLER,  D5_GPIO_Port,  D5_Pin, GPIO_PIN_RESET,  GPIO_PIN_SET,
+		 DEL_ACT_XX_BLI, DEL_ACT_XX_PUL, true, PWM_ID_NONE,
+		 ACT_COOLER_MIN_ON, ACT_COOLER_MIN_OFF, ACT_COOLER_MAX_STARTS, ACT_START_WINDOW},
+		{ID_ACT_HEATER,  D4_GPIO_Port,  D4_Pin, GPIO_PIN_RESET,  GPIO_PIN_SET,
+		 DEL_ACT_XX_BLI, DEL_ACT_XX_PUL, true, PWM_ID_HEATER,
+		 0, 0, 0, 0},
 		{ID_ACT_BUZZER,  D2_GPIO_Port,  D2_Pin, GPIO_PIN_SET,  GPIO_PIN_RESET,
-		 DEL_ACT_XX_BLI},
+		 DEL_ACT_XX_BLI, DEL_ACT_XX_PUL, false, PWM_ID_NONE,
+		 0, 0, 0, 0},
 };
 
 #define ACTUATOR_CFG_QTY	(sizeof(task_actuator_cfg_list)/sizeof(task_actuator_cfg_t))
 
 task_actuator_dta_t task_actuator_dta_list[] = {
-	{DEL_ACT_XX_MIN, ST_ACT_XX_OFF, EV_ACT_XX_NOT_BLINK, false},
-	{DEL_ACT_XX_MIN, ST_ACT_XX_OFF, EV_ACT_XX_NOT_BLINK, false},
-	{DEL_ACT_XX_MIN, ST_ACT_XX_OFF, EV_ACT_XX_NOT_BLINK, false},
-	{DEL_ACT_XX_MIN, ST_ACT_XX_OFF, EV_ACT_XX_NOT_BLINK, false},
-	{DEL_ACT_XX_MIN, ST_ACT_XX_OFF, EV_ACT_XX_NOT_BLINK, false}
+	{DEL_ACT_XX_MIN, ST_ACT_XX_OFF, EV_ACT_XX_NOT_BLINK, false, {0}, 0, 0, 0, false, 0, 0, 0, false, 0, 0},
+	{DEL_ACT_XX_MIN, ST_ACT_XX_OFF, EV_ACT_XX_NOT_BLINK, false, {0}, 0, 0, 0, false, 0, 0, 0, false, 0, 0},
+	{DEL_ACT_XX_MIN, ST_ACT_XX_OFF, EV_ACT_XX_NOT_BLINK, false, {0}, 0, 0, 0, false, 0, 0, 0, false, 0, 0},
+	{DEL_ACT_XX_MIN, ST_ACT_XX_OFF, EV_ACT_XX_NOT_BLINK, false, {0}, 0, 0, 0, false, 0, 0, 0, false, 0, 0},
+	{DEL_ACT_XX_MIN, ST_ACT_XX_OFF, EV_ACT_XX_NOT_BLINK, false, {0}, 0, 0, 0, false, 0, 0, 0, false, 0, 0}
 };
 
 #define ACTUATOR_DTA_QTY	(sizeof(task_actuator_dta_list)/sizeof(task_actuator_dta_t))
 
 /********************** internal functions declaration ***********************/
+static void actuator_write(const task_actuator_cfg_t *p_cfg, GPIO_PinState state);
+static void actuator_drive(const task_actuator_cfg_t *p_cfg, task_actuator_dta_t *p_dta, GPIO_PinState state);
+static void actuator_drive_duty(const task_actuator_cfg_t *p_cfg, task_actuator_dta_t *p_dta, uint32_t duty);
+static bool actuator_command_allowed(const task_actuator_cfg_t *p_cfg, task_actuator_dta_t *p_dta);
 
 /********************** internal data definition *****************************/
 const char *p_task_actuator 		= "Task Actuator (Actuator Statechart)";
 const char *p_task_actuator_ 		= "Non-Blocking & Update By Time Code";
 
+/* Pedido de estado seguro desde una ISR, lo consume task_actuator_update.
+ * El estado seguro queda trabado hasta task_actuator_release_safe() */
+static volatile bool actuator_safe_request = false;
+static volatile bool actuator_safe_latched = false;
+
 /********************** external data declaration ****************************/
 uint32_t g_task_actuator_cnt;
-volatile uint32_t g_task_actuator_tick_cnt;
 
 /********************** external functions definition ************************/
 void task_actuator_init(void *parameters)
@@ -110,7 +133,10 @@ void task_actuator_init(void *parameters)
 	g_task_actuator_cnt = G_TASK_ACT_CNT_INIT;
 
 	/* Print out: Task execution counter */
-	LOGGER_LOG("   %s = %lu\r\n", GET_NAME(g_task_actuator_cnt), g_task_actuator_cnt);
+	LOGGER_LOG("   %s = %" PRIu32 "\r\n", GET_NAME(g_task_actuator_cnt), g_task_actuator_cnt);
+
+	init_queue_event_task_actuator();
+	pwm_init();
 
 	for (index = 0; ACTUATOR_DTA_QTY > index; index++)
 	{
@@ -119,21 +145,25 @@ void task_actuator_init(void *parameters)
 		p_task_actuator_dta = &task_actuator_dta_list[index];
 
 		/* Print out: Index & Task execution FSM */
-		LOGGER_LOG("   %s = %lu", GET_NAME(index), index);
+		LOGGER_LOG("   %s = %" PRIu32, GET_NAME(index), index);
 
 		state = p_task_actuator_dta->state;
-		LOGGER_LOG("   %s = %lu", GET_NAME(state), (uint32_t)state);
+		LOGGER_LOG("   %s = %" PRIu32, GET_NAME(state), (uint32_t)state);
 
 		event = p_task_actuator_dta->event;
-		LOGGER_LOG("   %s = %lu", GET_NAME(event), (uint32_t)event);
+		LOGGER_LOG("   %s = %" PRIu32, GET_NAME(event), (uint32_t)event);
 
 		b_event = p_task_actuator_dta->flag;
 		LOGGER_LOG("   %s = %s\r\n", GET_NAME(b_event), (b_event ? "true" : "false"));
 
-		HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_off);
-	}
+		actuator_write(p_task_actuator_cfg, p_task_actuator_cfg->act_off);
 
-	g_task_actuator_tick_cnt = G_TASK_ACT_TICK_CNT_INI;
+		/* Al arrancar la salida cuenta como apagada desde hace min_off_ms */
+		p_task_actuator_dta->out_on = false;
+		p_task_actuator_dta->switch_tick = g_app_tick - p_task_actuator_cfg->min_off_ms;
+		p_task_actuator_dta->start_tokens = p_task_actuator_cfg->max_starts;
+		p_task_actuator_dta->token_tick = g_app_tick;
+	}
 }
 
 void task_actuator_update(void *parameters)
@@ -141,143 +171,414 @@ void task_actuator_update(void *parameters)
 	uint32_t index;
 	const task_actuator_cfg_t *p_task_actuator_cfg;
 	task_actuator_dta_t *p_task_actuator_dta;
-	bool b_time_update_required = false;
+	bool b_deferred;
 
 	/* Update Task Actuator Counter */
 	g_task_actuator_cnt++;
 
-	/* Protect shared resource (g_task_actuator_tick_cnt) */
-	__asm("CPSID i");	/* disable interrupts*/
-    if (G_TASK_ACT_TICK_CNT_INI < g_task_actuator_tick_cnt)
-    {
-    	g_task_actuator_tick_cnt--;
-    	b_time_update_required = true;
-    }
-    __asm("CPSIE i");	/* enable interrupts*/
-
-    while (b_time_update_required)
-    {
-		/* Protect shared resource (g_task_actuator_tick_cnt) */
-		__asm("CPSID i");	/* disable interrupts*/
-		if (G_TASK_ACT_TICK_CNT_INI < g_task_actuator_tick_cnt)
+	if (true == actuator_safe_request)
+	{
+		actuator_safe_request = false;
+
+		/* La ISR ya apagó las salidas, pero pudo interrumpir un update entre
+		 * el chequeo del estado seguro y la escritura del pin, que la volvió
+		 * a encender: se apagan otra vez. Después se alinean los statecharts
+		 * y se descartan los comandos encolados antes del disparo. El apagado
+		 * no respeta min_on_ms, pero el tiempo mínimo apagado corre desde acá */
+		for (index = 0; ACTUATOR_DTA_QTY > index; index++)
+		{
+			if (true == task_actuator_cfg_list[index].safe_off)
+			{
+				actuator_write(&task_actuator_cfg_list[index], task_actuator_cfg_list[index].act_off);
+				task_actuator_dta_list[index].state = ST_ACT_XX_OFF;
+				task_actuator_dta_list[index].flag = false;
+				task_actuator_dta_list[index].deferred = false;
+				task_actuator_dta_list[index].cmd_count = 0;
+				if (true == task_actuator_dta_list[index].out_on)
+				{
+					task_actuator_dta_list[index].out_on = false;
+					task_actuator_dta_list[index].switch_tick = g_app_tick;
+				}
+			}
+		}
+	}
+
+	for (index = 0; ACTUATOR_DTA_QTY > index; index++)
+	{
+		/* Update Task Actuator Configuration & Data Pointer */
+		p_task_actuator_cfg = &task_actuator_cfg_list[index];
+		p_task_actuator_dta = &task_actuator_dta_list[index];
+
+		/* Un comando por update, el siguiente espera a que se consuma este.
+		 * Un comando diferido lo reemplaza el siguiente, gana el último */
+		if (((false == p_task_actuator_dta->flag) || (true == p_task_actuator_dta->deferred))
+				&& (true == any_event_task_actuator(index)))
+		{
+			p_task_actuator_dta->event = get_event_task_actuator(index);
+			p_task_actuator_dta->flag = true;
+
+			/* Con el estado seguro trabado solo se aceptan apagados */
+			if ((true == actuator_safe_latched) && (true == p_task_actuator_cfg->safe_off)
+					&& (EV_ACT_XX_OFF != p_task_actuator_dta->event)
+					&& (EV_ACT_XX_NOT_BLINK != p_task_actuator_dta->event)
+					&& !((EV_ACT_XX_DUTY == p_task_actuator_dta->event) && (0 == p_task_actuator_dta->duty_cmd)))
+			{
+				p_task_actuator_dta->flag = false;
+			}
+		}
+
+		/* Fuera de su ventana el comando se oculta al statechart, que sigue
+		 * con sus tiempos, y queda pendiente para el próximo update. Se
+		 * cuenta una vez aunque lo reemplacen otros comandos también fuera */
+		b_deferred = (true == p_task_actuator_dta->flag)
+				&& (false == actuator_command_allowed(p_task_actuator_cfg, p_task_actuator_dta));
+		if (b_deferred)
 		{
-			g_task_actuator_tick_cnt--;
-			b_time_update_required = true;
+			if (false == p_task_actuator_dta->deferred)
+			{
+				p_task_actuator_dta->deferred = true;
+				p_task_actuator_dta->deferred_cnt++;
+			}
+			p_task_actuator_dta->flag = false;
 		}
 		else
 		{
-			b_time_update_required = false;
+			p_task_actuator_dta->deferred = false;
 		}
-		__asm("CPSIE i");	/* enable interrupts*/
 
-    	for (index = 0; ACTUATOR_DTA_QTY > index; index++)
+		switch (p_task_actuator_dta->state)
 		{
-    		/* Update Task Actuator Configuration & Data Pointer */
-			p_task_actuator_cfg = &task_actuator_cfg_list[index];
-			p_task_actuator_dta = &task_actuator_dta_list[index];
+		case ST_ACT_XX_OFF:
 
+			if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_ON == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_on);
+				p_task_actuator_dta->state = ST_ACT_XX_ON;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_BLINK == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_off);
+				p_task_actuator_dta->state = ST_ACT_XX_BLINK_ON;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_PULSE == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				p_task_actuator_dta->tick = p_task_actuator_cfg->tick_pulse;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_on);
+				p_task_actuator_dta->state = ST_ACT_XX_PULSE;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_DUTY == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive_duty(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_dta->duty_cmd);
+				p_task_actuator_dta->state = (0 < p_task_actuator_dta->duty_cmd) ? ST_ACT_XX_DUTY : ST_ACT_XX_OFF;
+			}
+
+			break;
+
+		case ST_ACT_XX_ON:
 
-			switch (p_task_actuator_dta->state)
+			if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_OFF == p_task_actuator_dta->event))
 			{
-			case ST_ACT_XX_OFF:
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_off);
+				p_task_actuator_dta->state = ST_ACT_XX_OFF;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_DUTY == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive_duty(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_dta->duty_cmd);
+				p_task_actuator_dta->state = (0 < p_task_actuator_dta->duty_cmd) ? ST_ACT_XX_DUTY : ST_ACT_XX_OFF;
+			}
 
-				if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_ON == p_task_actuator_dta->event))
-				{
-					p_task_actuator_dta->flag = false;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_on);
-					p_task_actuator_dta->state = ST_ACT_XX_ON;
-				}
-				else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_BLINK == p_task_actuator_dta->event))
-				{
-					p_task_actuator_dta->flag = false;
-					p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_off);
-					p_task_actuator_dta->state = ST_ACT_XX_BLINK_ON;
-				}
+			break;
 
-				break;
+		case ST_ACT_XX_BLINK_ON:
+			if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_OFF == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_off);
+				p_task_actuator_dta->state = ST_ACT_XX_OFF;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_ON == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_on);
+				p_task_actuator_dta->state = ST_ACT_XX_ON;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_NOT_BLINK == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_off);
+				p_task_actuator_dta->state = ST_ACT_XX_OFF;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_DUTY == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive_duty(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_dta->duty_cmd);
+				p_task_actuator_dta->state = (0 < p_task_actuator_dta->duty_cmd) ? ST_ACT_XX_DUTY : ST_ACT_XX_OFF;
+			}
+			else if (p_task_actuator_dta->tick > 0)
+			{
+				p_task_actuator_dta->tick--;
+			}
+			else
+			{
+				p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_off);
+				p_task_actuator_dta->state = ST_ACT_XX_BLINK_OFF;
+			}
 
-			case ST_ACT_XX_ON:
+			break;
 
-				if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_OFF == p_task_actuator_dta->event))
-				{
-					p_task_actuator_dta->flag = false;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_off);
-					p_task_actuator_dta->state = ST_ACT_XX_OFF;
-				}
+		case ST_ACT_XX_BLINK_OFF:
+			if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_OFF == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_off);
+				p_task_actuator_dta->state = ST_ACT_XX_OFF;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_ON == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_on);
+				p_task_actuator_dta->state = ST_ACT_XX_ON;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_NOT_BLINK == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_off);
+				p_task_actuator_dta->state = ST_ACT_XX_OFF;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_DUTY == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive_duty(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_dta->duty_cmd);
+				p_task_actuator_dta->state = (0 < p_task_actuator_dta->duty_cmd) ? ST_ACT_XX_DUTY : ST_ACT_XX_OFF;
+			}
+			else if (p_task_actuator_dta->tick > 0)
+			{
+				p_task_actuator_dta->tick--;
+			}
+			else
+			{
+				p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_on);
+				p_task_actuator_dta->state = ST_ACT_XX_BLINK_ON;
+			}
+			break;
 
-				break;
+		case ST_ACT_XX_PULSE:
+			if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_OFF == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_off);
+				p_task_actuator_dta->state = ST_ACT_XX_OFF;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_ON == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_on);
+				p_task_actuator_dta->state = ST_ACT_XX_ON;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_DUTY == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive_duty(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_dta->duty_cmd);
+				p_task_actuator_dta->state = (0 < p_task_actuator_dta->duty_cmd) ? ST_ACT_XX_DUTY : ST_ACT_XX_OFF;
+			}
+			else if (p_task_actuator_dta->tick > 0)
+			{
+				p_task_actuator_dta->tick--;
+			}
+			else
+			{
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_off);
+				p_task_actuator_dta->state = ST_ACT_XX_OFF;
+			}
+			break;
 
-			case ST_ACT_XX_BLINK_ON:
-				if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_OFF == p_task_actuator_dta->event))
-				{
-					p_task_actuator_dta->flag = false;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_off);
-					p_task_actuator_dta->state = ST_ACT_XX_OFF;
-				}
-				else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_ON == p_task_actuator_dta->event))
-				{
-					p_task_actuator_dta->flag = false;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_on);
-					p_task_actuator_dta->state = ST_ACT_XX_ON;
-				}
-				else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_NOT_BLINK == p_task_actuator_dta->event))
-				{
-					p_task_actuator_dta->flag = false;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_off);
-					p_task_actuator_dta->state = ST_ACT_XX_OFF;
-				}
+		case ST_ACT_XX_DUTY:
+			if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_OFF == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_off);
+				p_task_actuator_dta->state = ST_ACT_XX_OFF;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_ON == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_cfg->act_on);
+				p_task_actuator_dta->state = ST_ACT_XX_ON;
+			}
+			else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_DUTY == p_task_actuator_dta->event))
+			{
+				p_task_actuator_dta->flag = false;
+				actuator_drive_duty(p_task_actuator_cfg, p_task_actuator_dta, p_task_actuator_dta->duty_cmd);
+				p_task_actuator_dta->state = (0 < p_task_actuator_dta->duty_cmd) ? ST_ACT_XX_DUTY : ST_ACT_XX_OFF;
+			}
 
-				if (p_task_actuator_dta->tick > 0)
-				{
-					p_task_actuator_dta->tick--;
-				}
-				else
-				{
-					p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_off);
-					p_task_actuator_dta->state = ST_ACT_XX_BLINK_OFF;
-				}
+			break;
 
-				break;
+		default:
+			break;
+		}
 
-			case ST_ACT_XX_BLINK_OFF:
-				if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_OFF == p_task_actuator_dta->event))
-				{
-					p_task_actuator_dta->flag = false;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_off);
-					p_task_actuator_dta->state = ST_ACT_XX_OFF;
-				}
-				else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_ON == p_task_actuator_dta->event))
-				{
-					p_task_actuator_dta->flag = false;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_on);
-					p_task_actuator_dta->state = ST_ACT_XX_ON;
-				}
-				else if ((true == p_task_actuator_dta->flag) && (EV_ACT_XX_NOT_BLINK == p_task_actuator_dta->event))
-				{
-					p_task_actuator_dta->flag = false;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_off);
-					p_task_actuator_dta->state = ST_ACT_XX_OFF;
-				}
+		/* Un comando diferido sigue pendiente. Uno que el estado actual no
+		 * atiende se descarta, salvo un PULSE durante otro pulso, que espera
+		 * a que termine el actual */
+		if (b_deferred)
+		{
+			p_task_actuator_dta->flag = true;
+		}
+		else if ((true == p_task_actuator_dta->flag)
+				&& !((ST_ACT_XX_PULSE == p_task_actuator_dta->state)
+						&& (EV_ACT_XX_PULSE == p_task_actuator_dta->event)))
+		{
+			p_task_actuator_dta->flag = false;
+		}
+	}
+}
 
-				if (p_task_actuator_dta->tick > 0)
-				{
-					p_task_actuator_dta->tick--;
-				}
-				else
-				{
-					p_task_actuator_dta->tick = p_task_actuator_cfg->tick_blink;
-					HAL_GPIO_WritePin(p_task_actuator_cfg->gpio_port, p_task_actuator_cfg->pin, p_task_actuator_cfg->act_on);
-					p_task_actuator_dta->state = ST_ACT_XX_BLINK_ON;
-				}
-				break;
+/* Apaga de inmediato las salidas de potencia. Se puede llamar desde una ISR:
+ * solo escribe los pines (BSRR es atómico) y deja el resto para el update */
+void task_actuator_force_safe(void)
+{
+	uint32_t index;
 
-			default:
-				break;
+	for (index = 0; ACTUATOR_CFG_QTY > index; index++)
+	{
+		if (true == task_actuator_cfg_list[index].safe_off)
+		{
+			if (PWM_ID_NONE != task_actuator_cfg_list[index].pwm_id)
+			{
+				pwm_lock(task_actuator_cfg_list[index].pwm_id);
 			}
+			actuator_write(&task_actuator_cfg_list[index], task_actuator_cfg_list[index].act_off);
 		}
-    }
+	}
+
+	actuator_safe_latched = true;
+	actuator_safe_request = true;
+}
+
+void task_actuator_release_safe(void)
+{
+	uint32_t index;
+
+	actuator_safe_latched = false;
+
+	for (index = 0; ACTUATOR_CFG_QTY > index; index++)
+	{
+		if ((true == task_actuator_cfg_list[index].safe_off)
+				&& (PWM_ID_NONE != task_actuator_cfg_list[index].pwm_id))
+		{
+			pwm_unlock(task_actuator_cfg_list[index].pwm_id);
+		}
+	}
+}
+
+bool task_actuator_is_safe(void)
+{
+	return actuator_safe_latched;
+}
+
+// Las salidas con PWM van al 0 o al 100 %, así el statechart no distingue
+// entre una salida por GPIO y una por timer. Se puede llamar desde una ISR.
+static void actuator_write(const task_actuator_cfg_t *p_cfg, GPIO_PinState state)
+{
+	if (PWM_ID_NONE != p_cfg->pwm_id)
+	{
+		pwm_set_duty(p_cfg->pwm_id, (state == p_cfg->act_on) ? PWM_DUTY_MAX : 0);
+	}
+	else
+	{
+		HAL_GPIO_WritePin(p_cfg->gpio_port, p_cfg->pin, state);
+	}
+}
+
+static void actuator_drive(const task_actuator_cfg_t *p_cfg, task_actuator_dta_t *p_dta, GPIO_PinState state)
+{
+	actuator_drive_duty(p_cfg, p_dta, (state == p_cfg->act_on) ? PWM_DUTY_MAX : 0);
+}
+
+// Lleva la cuenta del nivel de la salida para los tiempos mínimos y los
+// arranques: cualquier duty > 0 cuenta como encendida. Solo desde el update,
+// actuator_write no tiene estado.
+static void actuator_drive_duty(const task_actuator_cfg_t *p_cfg, task_actuator_dta_t *p_dta, uint32_t duty)
+{
+	bool b_on = (0 < duty);
+
+	if (PWM_ID_NONE != p_cfg->pwm_id)
+	{
+		pwm_set_duty(p_cfg->pwm_id, duty);
+	}
+	else
+	{
+		HAL_GPIO_WritePin(p_cfg->gpio_port, p_cfg->pin, b_on ? p_cfg->act_on : p_cfg->act_off);
+	}
+
+	if (b_on != p_dta->out_on)
+	{
+		p_dta->out_on = b_on;
+		p_dta->switch_tick = g_app_tick;
+		if (b_on && (0 < p_dta->start_tokens))
+		{
+			/* Con el balde lleno la recarga empieza con este arranque */
+			if (p_dta->start_tokens >= p_cfg->max_starts)
+			{
+				p_dta->token_tick = g_app_tick;
+			}
+			p_dta->start_tokens--;
+		}
+	}
+}
+
+// Decide si el comando pendiente puede cambiar la salida ahora. Solo se
+// miran los comandos: el parpadeo y el pulso ya tienen sus tiempos fijos.
+static bool actuator_command_allowed(const task_actuator_cfg_t *p_cfg, task_actuator_dta_t *p_dta)
+{
+	uint32_t since = g_app_tick - p_dta->switch_tick;
+	uint32_t refill;
+	bool b_turn_on;
+
+	/* BLINK arranca apagado, no es un arranque hasta el primer cambio */
+	b_turn_on = (EV_ACT_XX_ON == p_dta->event) || (EV_ACT_XX_PULSE == p_dta->event)
+			|| ((EV_ACT_XX_DUTY == p_dta->event) && (0 < p_dta->duty_cmd));
+
+	if (b_turn_on == p_dta->out_on)
+	{
+		return true;
+	}
+
+	if (false == b_turn_on)
+	{
+		return since >= p_cfg->min_on_ms;
+	}
+
+	if (since < p_cfg->min_off_ms)
+	{
+		return false;
+	}
+
+	if (0 == p_cfg->max_starts)
+	{
+		return true;
+	}
+
+	/* Balde de arranques: se recupera uno cada start_window_ms / max_starts */
+	refill = p_cfg->start_window_ms / p_cfg->max_starts;
+	while ((p_dta->start_tokens < p_cfg->max_starts)
+			&& (g_app_tick - p_dta->token_tick >= refill))
+	{
+		p_dta->start_tokens++;
+		p_dta->token_tick += refill;
+	}
+
+	return 0 < p_dta->start_tokens;
 }
 
 /********************** end of file ******************************************/
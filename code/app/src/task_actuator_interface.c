@@ -50,24 +50,120 @@
 #include "task_actuator_attribute.h"
 
 /********************** macros and definitions *******************************/
+#define ACT_CMD_CLASS_LEVEL		0	// ON / OFF / DUTY
+#define ACT_CMD_CLASS_BLINK		1	// BLINK / NOT_BLINK
+#define ACT_CMD_CLASS_PULSE		2	// PULSE, no se fusiona
 
 /********************** internal data declaration ****************************/
 
 /********************** internal functions declaration ***********************/
+uint8_t actuator_cmd_class(task_actuator_ev_t event);
 
 /********************** internal data definition *****************************/
 
 /********************** external data declaration ****************************/
 
 /********************** external functions definition ************************/
+void init_queue_event_task_actuator(void)
+{
+	uint32_t index;
+
+	for (index = 0; ID_ACT_QTY > index; index++)
+	{
+		task_actuator_dta_list[index].cmd_count = 0;
+	}
+}
+
 void put_event_task_actuator(task_actuator_ev_t event, task_actuator_id_t identifier)
 {
 	task_actuator_dta_t *p_task_actuator_dta;
+	uint8_t cmd_class;
+	uint32_t i;
 
 	p_task_actuator_dta = &task_actuator_dta_list[identifier];
+	cmd_class = actuator_cmd_class(event);
+
+	// Un comando nuevo reemplaza al pendiente de su misma clase, que se saca
+	// de la cola para que el nuevo quede en orden de llegada.
+	if (ACT_CMD_CLASS_PULSE != cmd_class)
+	{
+		for (i = 0; p_task_actuator_dta->cmd_count > i; i++)
+		{
+			if (cmd_class == actuator_cmd_class(p_task_actuator_dta->cmd_queue[i]))
+			{
+				p_task_actuator_dta->cmd_count--;
+				for (; p_task_actuator_dta->cmd_count > i; i++)
+				{
+					p_task_actuator_dta->cmd_queue[i] = p_task_actuator_dta->cmd_queue[i + 1];
+				}
+				p_task_actuator_dta->merged_cnt++;
+				break;
+			}
+		}
+	}
+
+	if (ACT_CMD_QUEUE_SIZE <= p_task_actuator_dta->cmd_count)
+	{
+		p_task_actuator_dta->dropped_cnt++;
+		return;
+	}
+
+	p_task_actuator_dta->cmd_queue[p_task_actuator_dta->cmd_count++] = (uint8_t)event;
+}
+
+// EV_ACT_XX_DUTY con su parámetro. Como la clase se fusiona, en la cola hay
+// a lo sumo un DUTY y basta un lugar para el valor.
+void put_duty_task_actuator(uint32_t duty, task_actuator_id_t identifier)
+{
+	if (PWM_DUTY_MAX < duty)
+	{
+		duty = PWM_DUTY_MAX;
+	}
+
+	task_actuator_dta_list[identifier].duty_cmd = (uint16_t)duty;
+	put_event_task_actuator(EV_ACT_XX_DUTY, identifier);
+}
+
+task_actuator_ev_t get_event_task_actuator(task_actuator_id_t identifier)
+{
+	task_actuator_dta_t *p_task_actuator_dta;
+	task_actuator_ev_t event;
+	uint32_t i;
+
+	p_task_actuator_dta = &task_actuator_dta_list[identifier];
+
+	event = (task_actuator_ev_t)p_task_actuator_dta->cmd_queue[0];
+
+	p_task_actuator_dta->cmd_count--;
+	for (i = 0; p_task_actuator_dta->cmd_count > i; i++)
+	{
+		p_task_actuator_dta->cmd_queue[i] = p_task_actuator_dta->cmd_queue[i + 1];
+	}
+
+	return event;
+}
+
+bool any_event_task_actuator(task_actuator_id_t identifier)
+{
+	return (0 < task_actuator_dta_list[identifier].cmd_count);
+}
+
+uint8_t actuator_cmd_class(task_actuator_ev_t event)
+{
+	switch (event)
+	{
+	case EV_ACT_XX_OFF:
+	case EV_ACT_XX_ON:
+	case EV_ACT_XX_DUTY:
+		return ACT_CMD_CLASS_LEVEL;
+
+	case EV_ACT_XX_NOT_BLINK:
+	case EV_ACT_XX_BLINK:
+		return ACT_CMD_CLASS_BLINK;
 
-	p_task_actuator_dta->event = event;
-	p_task_actuator_dta->flag = true;
+	default:
+		return ACT_CMD_CLASS_PULSE;
+	}
 }
 
 /********************** end of file ******************************************/
@@ -46,17 +46,37 @@
 /* Application & Tasks includes. */
 #include "board.h"
 #include "app.h"
+#include "task_adc.h"
+#include "adc_filter.h"
+#include "utils.h"
 
 /********************** macros and definitions *******************************/
 #define ADC_TEMP_IDX     0
 #define ADC_PRESSURE_IDX 1
 #define ADC_NUM_READINGS 2
 
+/* Cada mitad del buffer circular es un bloque de decimación completo */
+#define ADC_SCANS_PER_HALF	ADC_OVERSAMPLE
+#define ADC_BUFFER_LEN		(2 * ADC_SCANS_PER_HALF * ADC_NUM_READINGS)
+
 /********************** internal data declaration ****************************/
-volatile uint16_t adc_buffer[ADC_NUM_READINGS];
+volatile uint16_t adc_buffer[ADC_BUFFER_LEN];
+
+/* Filtro elegido por canal, en el orden del scan */
+const adc_filter_t adc_filter_cfg[ADC_NUM_READINGS] = {
+	[ADC_TEMP_IDX]		= ADC_TEMP_FILTER,
+	[ADC_PRESSURE_IDX]	= ADC_PRESS_FILTER,
+};
+
+adc_filter_dta_t adc_filter_list[ADC_NUM_READINGS];
+
+/* Los callbacks del DMA publican cada bloque decimado en este snapshot */
+snapshot_t *p_adc_sensor_snapshot;
+uint32_t adc_block_cnt;
 
 /********************** internal functions declaration ***********************/
 HAL_StatusTypeDef ADC_Poll_Read(uint16_t *value);
+void adc_decimate_block(const volatile uint16_t *p_block);
 
 /********************** internal data definition *****************************/
 const char *p_task_adc 		= "Task ADC";
@@ -69,28 +89,105 @@ extern ADC_HandleTypeDef hadc1;
 void task_adc_init(void *parameters)
 {
 	shared_data_type *p_shared_data = (shared_data_type *) parameters;
+	uint32_t ch;
 
 	p_shared_data->adc_end_of_conversion = false;
 
 	/* Print out: Task Initialized */
 	LOGGER_LOG("  %s is running - %s\r\n", GET_NAME(task_adc_init), p_task_adc);
 
-	if (HAL_OK != HAL_ADC_Start_DMA(&hadc1, (uint32_t*)adc_buffer, ADC_NUM_READINGS)) {
+	for (ch = 0; ADC_NUM_READINGS > ch; ch++)
+	{
+		adc_filter_reset(&adc_filter_list[ch], adc_filter_cfg[ch]);
+	}
+	adc_block_cnt = 0;
+	p_adc_sensor_snapshot = &p_shared_data->sensor;
+
+	if (HAL_OK != HAL_ADC_Start_DMA(&hadc1, (uint32_t*)adc_buffer, ADC_BUFFER_LEN)) {
 		LOGGER_LOG("error: could not start ADC with DMA.\n");
 	}
 }
 
 void task_adc_update(void *parameters)
 {
-
 	shared_data_type *p_shared_data = (shared_data_type *) parameters;
 
-	p_shared_data->temp_raw = adc_buffer[ADC_TEMP_IDX];
-	p_shared_data->pressure_raw = adc_buffer[ADC_PRESSURE_IDX];
+	/* La medición la publican los callbacks del DMA, acá solo se avisa
+	 * que ya hay una válida */
+	p_shared_data->adc_end_of_conversion = (0 < snapshot_count(&p_shared_data->sensor));
+}
+
+// Vigila cada conversión cruda (12 bits) del canal de temperatura, sin pasar
+// por el filtro. La ventana es [low_raw, high_raw], fuera de ella interrumpe.
+void task_adc_temp_watchdog_arm(uint16_t low_raw, uint16_t high_raw)
+{
+	ADC_AnalogWDGConfTypeDef awd_cfg = {0};
+
+	awd_cfg.WatchdogMode = ADC_ANALOGWATCHDOG_SINGLE_REG;
+	awd_cfg.Channel = ADC_CHANNEL_0;
+	awd_cfg.ITMode = DISABLE;
+	awd_cfg.HighThreshold = high_raw;
+	awd_cfg.LowThreshold = low_raw;
+	HAL_ADC_AnalogWDGConfig(&hadc1, &awd_cfg);
+
+	/* Recién con los umbrales nuevos se habilita la interrupción */
+	__HAL_ADC_CLEAR_FLAG(&hadc1, ADC_FLAG_AWD);
+	__HAL_ADC_ENABLE_IT(&hadc1, ADC_IT_AWD);
+}
+
+void task_adc_temp_watchdog_disarm(void)
+{
+	ADC_AnalogWDGConfTypeDef awd_cfg = {0};
+
+	awd_cfg.WatchdogMode = ADC_ANALOGWATCHDOG_NONE;
+	awd_cfg.ITMode = DISABLE;
+	awd_cfg.HighThreshold = ADC_RAW_MAX_VALUE;
+	awd_cfg.LowThreshold = 0;
+	HAL_ADC_AnalogWDGConfig(&hadc1, &awd_cfg);
+}
+
+void adc_decimate_block(const volatile uint16_t *p_block)
+{
+	uint32_t ch;
+	uint32_t out[ADC_NUM_READINGS];
+	sensor_frame_t frame;
+
+	for (ch = 0; ADC_NUM_READINGS > ch; ch++)
+	{
+		out[ch] = adc_filter_block(&adc_filter_list[ch], &p_block[ch], ADC_NUM_READINGS);
+	}
+
+	/* El CIC2 necesita dos bloques para asentarse, hasta entonces no se
+	 * publica nada */
+	if (ADC_FILTER_SETTLE_BLOCKS > adc_block_cnt)
+	{
+		adc_block_cnt++;
+		return;
+	}
 
-	p_shared_data->adc_end_of_conversion = true;
+	frame.temp_raw = (uint16_t)out[ADC_TEMP_IDX];
+	frame.pressure_raw = (uint16_t)out[ADC_PRESSURE_IDX];
+	frame.temp = (uint16_t)temp_raw_to_deci_celsius(frame.temp_raw);
+	frame.press = (uint16_t)press_raw_to_deci_kPa(frame.pressure_raw);
+
+	snapshot_publish(p_adc_sensor_snapshot, &frame);
 }
 
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+	/* El DMA ya está llenando la segunda mitad */
+	if (hadc->Instance == ADC1)
+	{
+		adc_decimate_block(&adc_buffer[0]);
+	}
+}
 
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+	if (hadc->Instance == ADC1)
+	{
+		adc_decimate_block(&adc_buffer[ADC_BUFFER_LEN / 2]);
+	}
+}
 
 /********************** end of file ******************************************/
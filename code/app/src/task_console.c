@@ -0,0 +1,157 @@
+/*
+ * @file   : task_console.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+/* Project includes. */
+#include "main.h"
+
+/* Demo includes. */
+#include "logger.h"
+
+/* Application & Tasks includes. */
+#include "app.h"
+#include "task_console.h"
+
+/********************** macros and definitions *******************************/
+#define G_TASK_CON_CNT_INI			0ul
+
+#define CONSOLE_LINE_MAX			128
+
+typedef enum {
+	ST_CON_IDLE,
+	ST_CON_DUMP,
+} task_console_st_t;
+
+typedef struct {
+	task_console_st_t state;
+	uint32_t line;				// Próxima línea de estadísticas a enviar
+} task_console_dta_t;
+
+/********************** internal data declaration ****************************/
+task_console_dta_t task_console_dta = {ST_CON_IDLE, 0};
+
+/* Recepción de a un byte por interrupción */
+uint8_t console_rx_byte;
+volatile uint8_t console_rx_cmd;
+volatile bool console_rx_pending;
+
+/* La línea tiene que seguir viva mientras dura la transmisión por IT */
+char console_tx_line[CONSOLE_LINE_MAX];
+
+/********************** internal functions declaration ***********************/
+void task_console_statechart(void);
+
+/********************** internal data definition *****************************/
+const char *p_task_console 		= "Task Console (Serial Statistics)";
+
+/********************** external data declaration ****************************/
+uint32_t g_task_console_cnt;
+
+extern UART_HandleTypeDef huart2;
+
+/********************** external functions definition ************************/
+void task_console_init(void *parameters)
+{
+	/* Print out: Task Initialized */
+	LOGGER_LOG("  %s is running - %s\r\n", GET_NAME(task_console_init), p_task_console);
+
+	g_task_console_cnt = G_TASK_CON_CNT_INI;
+
+	console_rx_pending = false;
+	if (HAL_OK != HAL_UART_Receive_IT(&huart2, &console_rx_byte, 1))
+	{
+		LOGGER_LOG("error: could not start console reception.\n");
+	}
+}
+
+void task_console_update(void *parameters)
+{
+	/* Update Task Console Counter */
+	g_task_console_cnt++;
+
+	task_console_statechart();
+}
+
+void task_console_statechart(void)
+{
+	task_console_dta_t *p_task_console_dta = &task_console_dta;
+	uint8_t cmd = 0;
+	int len;
+
+	if (true == console_rx_pending)
+	{
+		cmd = console_rx_cmd;
+		console_rx_pending = false;
+	}
+
+	if (CONSOLE_CMD_RESET == cmd)
+	{
+		app_stats_reset();
+	}
+
+	switch (p_task_console_dta->state)
+	{
+	case ST_CON_IDLE:
+		if (CONSOLE_CMD_STATS == cmd)
+		{
+			p_task_console_dta->line = 0;
+			p_task_console_dta->state = ST_CON_DUMP;
+		}
+		break;
+
+	case ST_CON_DUMP:
+		// Se formatea una línea recién cuando terminó de salir la anterior
+		if (HAL_UART_STATE_READY != huart2.gState)
+		{
+			break;
+		}
+
+		if (app_stats_line_qty() <= p_task_console_dta->line)
+		{
+			p_task_console_dta->state = ST_CON_IDLE;
+			break;
+		}
+
+		len = app_stats_line(p_task_console_dta->line, console_tx_line, sizeof(console_tx_line));
+		p_task_console_dta->line++;
+
+		if (0 < len)
+		{
+			if ((size_t)len >= sizeof(console_tx_line))
+			{
+				len = sizeof(console_tx_line) - 1;
+			}
+			HAL_UART_Transmit_IT(&huart2, (uint8_t *)console_tx_line, (uint16_t)len);
+		}
+		break;
+
+	default:
+		p_task_console_dta->state = ST_CON_IDLE;
+		break;
+	}
+}
+
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+	if (huart->Instance == USART2)
+	{
+		console_rx_cmd = console_rx_byte;
+		console_rx_pending = true;
+		HAL_UART_Receive_IT(&huart2, &console_rx_byte, 1);
+	}
+}
+
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+	/* Un overrun aborta la recepción, se vuelve a armar */
+	if (huart->Instance == USART2)
+	{
+		HAL_UART_Receive_IT(&huart2, &console_rx_byte, 1);
+	}
+}
+
+/********************** end of file ******************************************/
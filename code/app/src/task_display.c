@@ -17,16 +17,23 @@
 /* Application & Tasks includes. */
 #include "board.h"
 #include "app.h"
+#include "task_display_attribute.h"
 #include "task_display_interface.h"
 #include "lcd/I2C_LCD.h"
+#include "lcd/I2C_LCD_cfg.h"
+
+#include <string.h>
 
 /********************** macros and definitions *******************************/
 #define G_TASK_DISPLAY_CNT_INI			0ul
-#define G_TASK_DISPLAY_TICK_CNT_INI		0ul
 
 
 /********************** internal data declaration ****************************/
+task_display_dta_t task_display_dta;
+
 /********************** internal functions declaration ***********************/
+static bool display_next_dirty(task_display_dta_t *p_task_display_dta, uint8_t *p_row, uint8_t *p_col);
+static uint8_t display_dirty_run(const task_display_dta_t *p_task_display_dta, uint8_t row, uint8_t col);
 
 /********************** internal data definition *****************************/
 const char *p_task_display 		= "Task display (Interactive display)";
@@ -34,7 +41,6 @@ const char *p_task_display_ 		= "Non-Blocking & Update By Time Code";
 
 /********************** external data declaration ****************************/
 uint32_t g_task_display_cnt;
-volatile uint32_t g_task_display_tick_cnt;
 
 extern I2C_HandleTypeDef hi2c2;
 
@@ -48,68 +54,121 @@ void task_display_init(void *parameters)
 	g_task_display_cnt = G_TASK_DISPLAY_CNT_INI;
 
 	/* Print out: Task execution counter */
-	LOGGER_LOG("   %s = %lu\r\n", GET_NAME(g_task_display_cnt), g_task_display_cnt);
+	LOGGER_LOG("   %s = %" PRIu32 "\r\n", GET_NAME(g_task_display_cnt), g_task_display_cnt);
 
-	init_queue_cmd_task_display();
+	init_framebuffer_task_display(I2C_LCD_CfgParam[I2C_LCD_1].I2C_LCD_nCol,
+								  I2C_LCD_CfgParam[I2C_LCD_1].I2C_LCD_nRow);
 
 	I2C_LCD_Init(I2C_LCD_1);
-
-	g_task_display_tick_cnt = G_TASK_DISPLAY_TICK_CNT_INI;
 }
 
 void task_display_update(void *parameters)
 {
-	bool b_time_update_required = false;
+	task_display_dta_t *p_task_display_dta = &task_display_dta;
+	uint32_t budget;
+	uint8_t row;
+	uint8_t col;
+	uint8_t len;
 
 	/* Update Task display Counter */
 	g_task_display_cnt++;
 
-	/* Protect shared resource (g_task_display_tick) */
-	__asm("CPSID i");	/* disable interrupts*/
-    if (G_TASK_DISPLAY_TICK_CNT_INI < g_task_display_tick_cnt)
-    {
-    	g_task_display_tick_cnt--;
-    	b_time_update_required = true;
-    }
-    __asm("CPSIE i");	/* enable interrupts*/
-
-    while (b_time_update_required)
-    {
-		/* Protect shared resource (g_task_display_tick) */
-		__asm("CPSID i");	/* disable interrupts*/
-		if (G_TASK_DISPLAY_TICK_CNT_INI < g_task_display_tick_cnt)
+	/* Mientras el LCD arranca las tareas ya escriben en el framebuffer, que
+	 * sale entero cuando termina */
+	if (false == I2C_LCD_InitStep(I2C_LCD_1))
+	{
+		return;
+	}
+
+	/* Se manda todo lo que el LCD acepta sin perder comandos: lo que no entra
+	 * queda sucio en el framebuffer y sale en otra ejecución */
+	budget = I2C_LCD_TxFree(I2C_LCD_1);
+
+	while ((0 < budget) && (true == display_next_dirty(p_task_display_dta, &row, &col)))
+	{
+		if ((row != p_task_display_dta->lcd_row) || (col != p_task_display_dta->lcd_col))
 		{
-			g_task_display_tick_cnt--;
-			b_time_update_required = true;
+			I2C_LCD_SetCursor(I2C_LCD_1, col, row);
+			p_task_display_dta->lcd_row = row;
+			p_task_display_dta->lcd_col = col;
 		}
 		else
 		{
-			b_time_update_required = false;
+			/* La tira de celdas distintas pasa a shown y el LCD la lee de ahí.
+			 * Si se pisa antes de salir, el LCD recibe el valor nuevo, que es
+			 * el mismo que queda en shown. */
+			len = display_dirty_run(p_task_display_dta, row, col);
+			memcpy(&p_task_display_dta->shown[row][col], &p_task_display_dta->next[row][col], len);
+			I2C_LCD_WriteRun(I2C_LCD_1, &p_task_display_dta->shown[row][col], len);
+			p_task_display_dta->lcd_col += len;
 		}
-		__asm("CPSIE i");	/* enable interrupts*/
 
-    	b_time_update_required = false;
+		p_task_display_dta->sent_cnt++;
+		budget--;
+	}
+}
 
-		if (true == any_submcd_task_display())
+/********************** internal functions definition ************************/
+
+// Busca la próxima celda distinta empezando donde está el cursor del LCD,
+// así una tira de cambios seguidos sale sin mover el cursor. Una fila que
+// se recorrió entera sin diferencias deja de estar sucia.
+static bool display_next_dirty(task_display_dta_t *p_task_display_dta, uint8_t *p_row, uint8_t *p_col)
+{
+	uint8_t rows = p_task_display_dta->rows;
+	uint8_t cols = p_task_display_dta->cols;
+	uint8_t first_row = 0;
+	uint8_t first_col = 0;
+	uint8_t pass;
+	uint8_t row;
+	uint8_t col;
+
+	if (rows > p_task_display_dta->lcd_row)
+	{
+		first_row = p_task_display_dta->lcd_row;
+		first_col = (cols > p_task_display_dta->lcd_col) ? p_task_display_dta->lcd_col : 0;
+	}
+
+	/* Una vuelta de más para las columnas de first_row antes de first_col */
+	for (pass = 0; rows >= pass; pass++)
+	{
+		row = (first_row + pass) % rows;
+		if (0 == (p_task_display_dta->dirty_rows & (1u << row)))
 		{
-			char subcmd = get_subcmd_task_display();
+			continue;
+		}
 
-			switch (subcmd)
+		for (col = (0 == pass) ? first_col : 0; cols > col; col++)
+		{
+			if (p_task_display_dta->next[row][col] != p_task_display_dta->shown[row][col])
 			{
-			case SUBCMD_LINE_0:
-				I2C_LCD_SetCursor(I2C_LCD_1, 0, 0);
-				break;
-
-			case SUBCMD_LINE_1:
-				I2C_LCD_SetCursor(I2C_LCD_1, 0, 1);
-				break;
-
-			default:
-				I2C_LCD_WriteChar(I2C_LCD_1, subcmd);
-				break;
+				*p_row = row;
+				*p_col = col;
+				return true;
 			}
 		}
-    }
+
+		if ((0 != pass) || (0 == first_col))
+		{
+			p_task_display_dta->dirty_rows &= (uint8_t)~(1u << row);
+		}
+	}
+
+	return false;
+}
+
+// Cuántas celdas seguidas desde col difieren de lo que muestra el LCD
+static uint8_t display_dirty_run(const task_display_dta_t *p_task_display_dta, uint8_t row, uint8_t col)
+{
+	uint8_t end = col;
+
+	while ((p_task_display_dta->cols > end)
+			&& (p_task_display_dta->next[row][end] != p_task_display_dta->shown[row][end]))
+	{
+		end++;
+	}
+
+	return (uint8_t)(end - col);
 }
 
 /********************** end of file ******************************************/
@@ -7,91 +7,83 @@
 
 /********************** inclusions *******************************************/
 #include "main.h"
-
+#include "task_display_attribute.h"
 #include "task_display_interface.h"
 
-/********************** macros and definitions *******************************/
-#define SUBCMD_UNDEFINED	'\xFF'
+#include <string.h>
 
-#define MAX_SUBCMDS			(64)
+/********************** macros and definitions *******************************/
 
 /********************** internal data declaration ****************************/
 
 /********************** internal functions declaration ***********************/
 
-void put_subcmd_task_display(char subcmd);
-
 /********************** internal data definition *****************************/
 
-struct
-{
-	uint32_t	head;
-	uint32_t	tail;
-	uint32_t	count;
-	char		queue[MAX_SUBCMDS];
-} queue_task_disp;
-
 /********************** external data declaration ****************************/
 
 /********************** external functions definition ************************/
-void init_queue_cmd_task_display(void)
-{
-	uint32_t i;
-
-	queue_task_disp.head = 0;
-	queue_task_disp.tail = 0;
-	queue_task_disp.count = 0;
 
-	for (i = 0; i < MAX_SUBCMDS; i++)
-		queue_task_disp.queue[i] = SUBCMD_UNDEFINED;
+void init_framebuffer_task_display(uint8_t cols, uint8_t rows)
+{
+	task_display_dta_t *p_dta = &task_display_dta;
+
+	p_dta->cols = (DISPLAY_COLS_MAX < cols) ? DISPLAY_COLS_MAX : cols;
+	p_dta->rows = (DISPLAY_ROWS_MAX < rows) ? DISPLAY_ROWS_MAX : rows;
+
+	/* El LCD arranca borrado */
+	memset(p_dta->next, ' ', sizeof(p_dta->next));
+	memset(p_dta->shown, ' ', sizeof(p_dta->shown));
+	p_dta->col = 0;
+	p_dta->row = 0;
+	p_dta->dirty_rows = 0;
+	p_dta->lcd_col = DISPLAY_POS_UNKNOWN;
+	p_dta->lcd_row = DISPLAY_POS_UNKNOWN;
+	p_dta->sent_cnt = 0;
+	p_dta->dropped_cnt = 0;
 }
 
 void put_cmd_task_display(task_disp_cmd_t cmd, const char *text)
 {
+	task_display_dta_t *p_dta = &task_display_dta;
+	char *p_cell;
+
 	switch (cmd)
 	{
 	case CMD_DISP_TO_LINE_0:
-		put_subcmd_task_display(SUBCMD_LINE_0);
-		break;
-
 	case CMD_DISP_TO_LINE_1:
-		put_subcmd_task_display(SUBCMD_LINE_1);
+	case CMD_DISP_TO_LINE_2:
+	case CMD_DISP_TO_LINE_3:
+		p_dta->col = 0;
+		p_dta->row = (uint8_t)(cmd - CMD_DISP_TO_LINE_0);
+
+		/* La versión anterior de la fila no terminó de llegar al LCD: se
+		 * pierde entera y solo se muestra la nueva */
+		if (0 != (p_dta->dirty_rows & (1u << p_dta->row)))
+		{
+			p_dta->dropped_cnt++;
+		}
 		break;
 
 	case CMD_DISP_WRITE_STR:
-		while (*text)
-			put_subcmd_task_display(*text++);
-	}
-}
-
-void put_subcmd_task_display(char subcmd)
-{
-	queue_task_disp.count++;
-	queue_task_disp.queue[queue_task_disp.head++] = subcmd;
-
-	if (MAX_SUBCMDS == queue_task_disp.head)
-		queue_task_disp.head = 0;
-}
-
-char get_subcmd_task_display(void)
-
-{
-	char subcmd_dta;
-
-	queue_task_disp.count--;
-	subcmd_dta = queue_task_disp.queue[queue_task_disp.tail];
-	queue_task_disp.queue[queue_task_disp.tail] = SUBCMD_UNDEFINED;
-	queue_task_disp.tail++;
-
-	if (MAX_SUBCMDS == queue_task_disp.tail)
-		queue_task_disp.tail = 0;
-
-	return subcmd_dta;
-}
+		if (p_dta->rows <= p_dta->row)
+		{
+			break;
+		}
+		for (; ('\0' != *text) && (p_dta->cols > p_dta->col); text++, p_dta->col++)
+		{
+			p_cell = &p_dta->next[p_dta->row][p_dta->col];
+			if (*p_cell != *text)
+			{
+				*p_cell = *text;
+				p_dta->dirty_rows |= (uint8_t)(1u << p_dta->row);
+			}
+		}
+		break;
 
-bool any_submcd_task_display(void)
-{
-  return (queue_task_disp.head != queue_task_disp.tail);
+	default:
+		break;
+	}
 }
 
 /********************** end of file ******************************************/
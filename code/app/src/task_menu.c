@@ -47,61 +47,223 @@
 /* Application & Tasks includes. */
 #include "board.h"
 #include "app.h"
+#include "task_menu.h"
 #include "task_menu_attribute.h"
 #include "task_menu_interface.h"
 #include "task_system_interface.h"
 #include "task_display_interface.h"
+#include "task_temp.h"
+#include "task_temp_attribute.h"
+#include "task_temp_interface.h"
+#include "pid.h"
+#include "task_recipe.h"
+#include "task_recipe_attribute.h"
+#include "task_recipe_interface.h"
 #include "eeprom.h"
 #include "utils.h"
 
+#include <stddef.h>
+#include <string.h>
+
 /********************** macros and definitions *******************************/
 #define G_TASK_MEN_CNT_INI			0ul
-#define G_TASK_MEN_TICK_CNT_INI		0ul
 
 #define DEL_MEN_XX_MIN				0ul
 #define DEL_MEN_XX_MED				100ul
 #define DEL_MEN_XX_MAX				500ul
 
 
-#define TEMP_SETPOINT_INI		25 		// celsius
-#define TEMP_HYSTERESIS_INI		2 		// celsius
-#define PRESS_SETPOINT_INI		101 	// kPa
-#define PRESS_HYSTERESIS_INI	1 		// kPa
+// Todos los valores en décimas de °C / décimas de kPa
+#define TEMP_SETPOINT_INI		250 	//  25.0 celsius
+#define TEMP_HYSTERESIS_INI		20 		//   2.0 celsius
+#define TEMP_ALARM_LIMIT_INI	600 	//  60.0 celsius
+#define PRESS_SETPOINT_INI		1010 	// 101.0 kPa
+#define PRESS_HYSTERESIS_INI	10 		//   1.0 kPa
+#define PRESS_ALARM_LIMIT_INI	1080 	// 108.0 kPa
 #define ALARM_ENABLE_INI 		false
 
-#define TEMP_SETPOINT_MIN		0		// celsius
-#define TEMP_HYSTERESIS_MIN		1		// celsius
-#define PRESS_SETPOINT_MIN		0		// kPa
-#define PRESS_HYSTERESIS_MIN	1		// kPa
+#define TEMP_SETPOINT_MIN		0		//   0.0 celsius
+#define TEMP_HYSTERESIS_MIN		1		//   0.1 celsius
+#define PRESS_SETPOINT_MIN		0		//   0.0 kPa
+#define PRESS_HYSTERESIS_MIN	1		//   0.1 kPa
+
+#define TEMP_SETPOINT_MAX		800		//  80.0 celsius
+#define TEMP_HYSTERESIS_MAX		100		//  10.0 celsius
+#define PRESS_SETPOINT_MAX		1100	// 110.0 kPa
+#define PRESS_HYSTERESIS_MAX	100		//  10.0 kPa
+
+// Paso de cada pulsación de NEX/PRE en los editores
+#define TEMP_SETPOINT_STEP		5		// 0.5 celsius
+#define TEMP_HYSTERESIS_STEP	1		// 0.1 celsius
+#define PRESS_SETPOINT_STEP		5		// 0.5 kPa
+#define PRESS_HYSTERESIS_STEP	1		// 0.1 kPa
+
+// Control de temperatura. Ganancias en décimas, unidades en pid.h
+#define TEMP_MODE_INI			CTRL_MODE_ONOFF
+#define TEMP_KP_INI				100		// 10.0 %/celsius
+#define TEMP_KI_INI				2		//  0.2 %/(celsius.s)
+#define TEMP_KD_INI				0		//  0.0 %.s/celsius
 
-#define TEMP_SETPOINT_MAX		80		// celsius
-#define TEMP_HYSTERESIS_MAX		10		// celsius
-#define PRESS_SETPOINT_MAX		110		// kPa
-#define PRESS_HYSTERESIS_MAX	10		// kPa
+#define TEMP_KP_STEP			5
+#define TEMP_KI_STEP			1
+#define TEMP_KD_STEP			5
 
+// Mayor valor que entra en la línea de edición: 999.9
+#define MENU_VALUE_DISP_MAX		9999ul
+
+// Campo de system_config_t que edita un nodo
+#define MENU_FIELD(name)		.field = offsetof(system_config_t, name), \
+								.field_size = sizeof(((system_config_t*)0)->name)
+
+#define MENU_CHILDREN(list)		.p_child_list = (list), .child_qty = sizeof(list)
+
+// Página de una receta: cualquiera de las cuatro lleva a las mismas acciones
+#define MENU_RECIPE_PAGE(slot)	{.type = MENU_NODE_LIST, .title_fn = menu_recipe_title,		\
+								 .item_fn = menu_recipe_item, .arg = (slot),				\
+								 .action = menu_recipe_select, MENU_CHILDREN(menu_recipe_action_list)}
 
 /********************** internal data declaration ****************************/
 task_menu_dta_t task_menu_dta =
-	{DEL_MEN_XX_MIN, ST_MEN_MAIN_SELECT, EV_MEN_ENT_IDLE, false, {0}, 0};
+	{DEL_MEN_XX_MIN, ST_MEN_BROWSE, EV_MEN_ENT_IDLE, false, true, {0}, 0, MENU_ID_ROOT, 0, {{0}}};
 
 #define MENU_DTA_QTY	(sizeof(task_menu_dta)/sizeof(task_menu_dta_t))
 
-#define MENU_CFG_ADDR 0
+_Static_assert(sizeof(system_config_t) <= (EEPROM_RECIPE_ADDR - EEPROM_CFG_ADDR),
+			   "system_config_t does not fit in its EEPROM block");
+
+_Static_assert(sizeof(system_config_t) <= UINT8_MAX, "menu_node_t.field is a uint8_t offset");
+
+_Static_assert(RECIPE_SLOT_QTY == (MENU_ID_RECIPE_START - MENU_ID_RECIPE_1),
+			   "one menu page per recipe slot");
 
 /********************** internal functions declaration ***********************/
 
 void recover_saved_cfg();
 void task_menu_statechart(shared_data_type *p_shared_data);
 
+static void menu_render(task_menu_dta_t *p_task_menu_dta, const menu_node_t *p_node);
+static bool menu_is_live(const task_menu_dta_t *p_task_menu_dta, const menu_node_t *p_node);
+static void menu_list_event(task_menu_dta_t *p_task_menu_dta, const menu_node_t *p_node);
+static void menu_edit_event(task_menu_dta_t *p_task_menu_dta, const menu_node_t *p_node,
+							system_config_t *p_cfg, shared_data_type *p_shared_data);
+static task_menu_ev_t menu_event_steps(task_menu_ev_t event, uint32_t *p_steps);
+static void menu_enter(task_menu_dta_t *p_task_menu_dta, uint8_t node);
+static void menu_back(task_menu_dta_t *p_task_menu_dta);
+static uint32_t menu_field_get(const system_config_t *p_cfg, const menu_node_t *p_node);
+static void menu_field_set(system_config_t *p_cfg, const menu_node_t *p_node, uint32_t value);
+
+static const char *menu_autotune_item(const menu_node_t *p_node);
+static const char *menu_recipe_title(const menu_node_t *p_node);
+static const char *menu_recipe_item(const menu_node_t *p_node);
+static const char *menu_recipe_pause_item(const menu_node_t *p_node);
+static void menu_autotune_start(const menu_node_t *p_node);
+static void menu_recipe_select(const menu_node_t *p_node);
+static void menu_recipe_event(const menu_node_t *p_node);
+
 /********************** internal data definition *****************************/
 const char *p_task_menu 		= "Task Menu (Interactive Menu)";
 const char *p_task_menu_ 		= "Non-Blocking & Update By Time Code";
 
 char menu_str[17] = {0};
 
+/* Copia que se graba en la EEPROM, tiene que seguir válida mientras dura
+ * la escritura asíncrona */
+system_config_t menu_saved_cfg;
+
+/* Hay una configuración publicada que falta grabar (autoajuste) */
+bool menu_save_pending = false;
+
+static const uint8_t menu_root_child_list[] =
+	{MENU_ID_TEMP, MENU_ID_PRESS, MENU_ID_ALARM, MENU_ID_RECIPE};
+
+static const uint8_t menu_temp_child_list[] =
+	{MENU_ID_TEMP_SET, MENU_ID_TEMP_HYS, MENU_ID_TEMP_MODE, MENU_ID_TEMP_KP,
+	 MENU_ID_TEMP_KI, MENU_ID_TEMP_KD, MENU_ID_TEMP_AUTOTUNE};
+
+static const uint8_t menu_press_child_list[] =
+	{MENU_ID_PRESS_SET, MENU_ID_PRESS_HYS};
+
+static const uint8_t menu_alarm_child_list[] =
+	{MENU_ID_ALARM_EN, MENU_ID_ALARM_TLIM, MENU_ID_ALARM_PLIM};
+
+static const uint8_t menu_recipe_child_list[] =
+	{MENU_ID_RECIPE_1, MENU_ID_RECIPE_2, MENU_ID_RECIPE_3, MENU_ID_RECIPE_4};
+
+static const uint8_t menu_recipe_action_list[] =
+	{MENU_ID_RECIPE_START, MENU_ID_RECIPE_PAUSE, MENU_ID_RECIPE_ABORT};
+
+// Indexados por ctrl_mode_t
+static const char * const menu_mode_option_list[] = {"> ON/OFF        ", "> PID           "};
+
+static const char * const menu_bool_option_list[] = {"> NO            ", "> SI            "};
+
+/* Todo el menú. Los títulos e items ocupan la línea entera del LCD. */
+const menu_node_t menu_node_list[MENU_ID_QTY] = {
+	[MENU_ID_ROOT]			= {.type = MENU_NODE_LIST, .title = "Configurar:     ",
+							   MENU_CHILDREN(menu_root_child_list)},
+
+	[MENU_ID_TEMP]			= {.type = MENU_NODE_LIST, .title = "Config. Temp:   ", .item = "> Temperatura   ",
+							   MENU_CHILDREN(menu_temp_child_list)},
+	[MENU_ID_TEMP_SET]		= {.type = MENU_NODE_VALUE, .title = "Setpoint Temp:  ", .item = "> Setpoint      ",
+							   MENU_FIELD(temp_setpoint), .unit = "\xDF""C",
+							   .min = TEMP_SETPOINT_MIN, .max = TEMP_SETPOINT_MAX, .step = TEMP_SETPOINT_STEP},
+	[MENU_ID_TEMP_HYS]		= {.type = MENU_NODE_VALUE, .title = "Histeresis Temp:", .item = "> Histeresis    ",
+							   MENU_FIELD(temp_hysteresis), .unit = "\xDF""C",
+							   .min = TEMP_HYSTERESIS_MIN, .max = TEMP_HYSTERESIS_MAX, .step = TEMP_HYSTERESIS_STEP},
+	[MENU_ID_TEMP_MODE]		= {.type = MENU_NODE_CHOICE, .title = "Control Temp:   ", .item = "> Modo          ",
+							   MENU_FIELD(temp_mode), .p_option_list = menu_mode_option_list,
+							   .min = 0, .max = CTRL_MODE_QTY - 1},
+	[MENU_ID_TEMP_KP]		= {.type = MENU_NODE_VALUE, .title = "Kp Temp:        ", .item = "> Kp            ",
+							   MENU_FIELD(temp_kp), .unit = "%/\xDF""C",
+							   .min = PID_GAIN_MIN, .max = PID_GAIN_MAX, .step = TEMP_KP_STEP},
+	[MENU_ID_TEMP_KI]		= {.type = MENU_NODE_VALUE, .title = "Ki Temp:        ", .item = "> Ki            ",
+							   MENU_FIELD(temp_ki), .unit = "%/\xDF""Cs",
+							   .min = PID_GAIN_MIN, .max = PID_GAIN_MAX, .step = TEMP_KI_STEP},
+	[MENU_ID_TEMP_KD]		= {.type = MENU_NODE_VALUE, .title = "Kd Temp:        ", .item = "> Kd            ",
+							   MENU_FIELD(temp_kd), .unit = "%s/\xDF""C",
+							   .min = PID_GAIN_MIN, .max = PID_GAIN_MAX, .step = TEMP_KD_STEP},
+	// Arranca el ensayo de relé, el resultado se guarda solo al terminar
+	[MENU_ID_TEMP_AUTOTUNE]	= {.type = MENU_NODE_ACTION, .item_fn = menu_autotune_item,
+							   .action = menu_autotune_start},
+
+	[MENU_ID_PRESS]			= {.type = MENU_NODE_LIST, .title = "Config. Presion:", .item = "> Presion       ",
+							   MENU_CHILDREN(menu_press_child_list)},
+	[MENU_ID_PRESS_SET]		= {.type = MENU_NODE_VALUE, .title = "Setpoint Pres:  ", .item = "> Setpoint      ",
+							   MENU_FIELD(press_setpoint), .unit = "kPa",
+							   .min = PRESS_SETPOINT_MIN, .max = PRESS_SETPOINT_MAX, .step = PRESS_SETPOINT_STEP},
+	[MENU_ID_PRESS_HYS]		= {.type = MENU_NODE_VALUE, .title = "Histeresis Pres:", .item = "> Histeresis    ",
+							   MENU_FIELD(press_hysteresis), .unit = "kPa",
+							   .min = PRESS_HYSTERESIS_MIN, .max = PRESS_HYSTERESIS_MAX, .step = PRESS_HYSTERESIS_STEP},
+
+	[MENU_ID_ALARM]			= {.type = MENU_NODE_LIST, .title = "Config. Alarmas:", .item = "> Alarmas       ",
+							   MENU_CHILDREN(menu_alarm_child_list)},
+	[MENU_ID_ALARM_EN]		= {.type = MENU_NODE_CHOICE, .title = "Alarma activa?  ", .item = "> Habilitacion  ",
+							   MENU_FIELD(alarm_enabled), .p_option_list = menu_bool_option_list,
+							   .min = 0, .max = 1},
+	[MENU_ID_ALARM_TLIM]	= {.type = MENU_NODE_VALUE, .title = "Alarma Temp:    ", .item = "> Limite Temp.  ",
+							   MENU_FIELD(temp_alarm_limit), .unit = "\xDF""C",
+							   .min = TEMP_SETPOINT_MIN, .max = TEMP_SETPOINT_MAX, .step = TEMP_SETPOINT_STEP},
+	[MENU_ID_ALARM_PLIM]	= {.type = MENU_NODE_VALUE, .title = "Alarma Presion: ", .item = "> Limite Pres.  ",
+							   MENU_FIELD(press_alarm_limit), .unit = "kPa",
+							   .min = PRESS_SETPOINT_MIN, .max = PRESS_SETPOINT_MAX, .step = PRESS_SETPOINT_STEP},
+
+	[MENU_ID_RECIPE]		= {.type = MENU_NODE_LIST, .title = "Recetas:        ", .item = "> Recetas       ",
+							   MENU_CHILDREN(menu_recipe_child_list)},
+	[MENU_ID_RECIPE_1]		= MENU_RECIPE_PAGE(0),
+	[MENU_ID_RECIPE_2]		= MENU_RECIPE_PAGE(1),
+	[MENU_ID_RECIPE_3]		= MENU_RECIPE_PAGE(2),
+	[MENU_ID_RECIPE_4]		= MENU_RECIPE_PAGE(3),
+	// La receta corre aunque se salga del menú
+	[MENU_ID_RECIPE_START]	= {.type = MENU_NODE_ACTION, .item = "> Iniciar       ", .flags = MENU_FLAG_BACK,
+							   .arg = EV_REC_START, .action = menu_recipe_event},
+	[MENU_ID_RECIPE_PAUSE]	= {.type = MENU_NODE_ACTION, .item_fn = menu_recipe_pause_item, .flags = MENU_FLAG_BACK,
+							   .arg = EV_REC_PAUSE, .action = menu_recipe_event},
+	[MENU_ID_RECIPE_ABORT]	= {.type = MENU_NODE_ACTION, .item = "> Abortar       ", .flags = MENU_FLAG_BACK,
+							   .arg = EV_REC_ABORT, .action = menu_recipe_event},
+};
+
 /********************** external data declaration ****************************/
 uint32_t g_task_menu_cnt;
-volatile uint32_t g_task_menu_tick_cnt;
 
 /********************** external functions definition ************************/
 void task_menu_init(void *parameters)
@@ -120,7 +282,7 @@ void task_menu_init(void *parameters)
 	g_task_menu_cnt = G_TASK_MEN_CNT_INI;
 
 	/* Print out: Task execution counter */
-	LOGGER_LOG("   %s = %lu\r\n", GET_NAME(g_task_menu_cnt), g_task_menu_cnt);
+	LOGGER_LOG("   %s = %" PRIu32 "\r\n", GET_NAME(g_task_menu_cnt), g_task_menu_cnt);
 
 	init_queue_event_task_menu();
 
@@ -129,593 +291,502 @@ void task_menu_init(void *parameters)
 
 	/* Print out: Task execution FSM */
 	state = p_task_menu_dta->state;
-	LOGGER_LOG("   %s = %lu", GET_NAME(state), (uint32_t)state);
+	LOGGER_LOG("   %s = %" PRIu32, GET_NAME(state), (uint32_t)state);
 
 	event = p_task_menu_dta->event;
-	LOGGER_LOG("   %s = %lu", GET_NAME(event), (uint32_t)event);
+	LOGGER_LOG("   %s = %" PRIu32, GET_NAME(event), (uint32_t)event);
 
 	b_event = p_task_menu_dta->flag;
 	LOGGER_LOG("   %s = %s\r\n", GET_NAME(b_event), (b_event ? "true" : "false"));
 
 	recover_saved_cfg(&p_task_menu_dta->cfg);
-	p_shared_data->cfg = p_task_menu_dta->cfg;
-
-	g_task_menu_tick_cnt = G_TASK_MEN_TICK_CNT_INI;
+	snapshot_publish(&p_shared_data->cfg, &p_task_menu_dta->cfg);
 }
 
 void task_menu_update(void *parameters)
 {
-	bool b_time_update_required = false;
-
 	/* Update Task Menu Counter */
 	g_task_menu_cnt++;
 
-	/* Protect shared resource (g_task_menu_tick) */
-	__asm("CPSID i");	/* disable interrupts*/
-    if (G_TASK_MEN_TICK_CNT_INI < g_task_menu_tick_cnt)
-    {
-    	g_task_menu_tick_cnt--;
-    	b_time_update_required = true;
-    }
-    __asm("CPSIE i");	/* enable interrupts*/
-
-    while (b_time_update_required)
-    {
-		/* Protect shared resource (g_task_menu_tick) */
-		__asm("CPSID i");	/* disable interrupts*/
-		if (G_TASK_MEN_TICK_CNT_INI < g_task_menu_tick_cnt)
-		{
-			g_task_menu_tick_cnt--;
-			b_time_update_required = true;
-		}
-		else
-		{
-			b_time_update_required = false;
-		}
-		__asm("CPSIE i");	/* enable interrupts*/
-
-		task_menu_statechart((shared_data_type*)parameters);
-	}
+	task_menu_statechart((shared_data_type*)parameters);
 }
 
 void task_menu_statechart(shared_data_type *p_shared_data)
 {
 	task_menu_dta_t *p_task_menu_dta;
+	const menu_node_t *p_node;
 	HAL_StatusTypeDef status;
+	system_config_t cfg;
 
 	/* Update Task Menu Data Pointer */
 	p_task_menu_dta = &task_menu_dta;
 
-	if (DEL_MEN_XX_MIN < p_task_menu_dta->tick)
-	{
-		p_task_menu_dta->tick--;
-	}
-	else
+	/* Configuración vigente. Cada campo confirmado se publica junto con el
+	 * resto, nunca un campo suelto */
+	snapshot_read(&p_shared_data->cfg, &cfg);
+
+	/* Todos los eventos pendientes, apenas llegan: cada uno cambia la página
+	 * y se dibuja una sola vez al final */
+	while (true == any_event_task_menu())
 	{
-		p_task_menu_dta->tick = DEL_MEN_XX_MAX;
+		p_task_menu_dta->flag = true;
+		p_task_menu_dta->event = get_event_task_menu();
 
-		if (true == any_event_task_menu())
+		// El resultado del autoajuste llega en cualquier estado del menú
+		if (EV_MEN_AUTOTUNE_DONE == p_task_menu_dta->event)
 		{
-			p_task_menu_dta->flag = true;
-			p_task_menu_dta->event = get_event_task_menu();
+			const temp_autotune_result_t *p_result = task_temp_autotune_result();
+
+			p_task_menu_dta->flag = false;
+			cfg.temp_kp = p_result->kp;
+			cfg.temp_ki = p_result->ki;
+			cfg.temp_kd = p_result->kd;
+			if (is_in_range(p_result->hysteresis, TEMP_HYSTERESIS_MIN, TEMP_HYSTERESIS_MAX))
+				cfg.temp_hysteresis = p_result->hysteresis;
+			else if (p_result->hysteresis > TEMP_HYSTERESIS_MAX)
+				cfg.temp_hysteresis = TEMP_HYSTERESIS_MAX;
+			snapshot_publish(&p_shared_data->cfg, &cfg);
+
+			p_task_menu_dta->cfg.temp_kp = cfg.temp_kp;
+			p_task_menu_dta->cfg.temp_ki = cfg.temp_ki;
+			p_task_menu_dta->cfg.temp_kd = cfg.temp_kd;
+			p_task_menu_dta->cfg.temp_hysteresis = cfg.temp_hysteresis;
+			p_task_menu_dta->b_dirty = true;
+			menu_save_pending = true;
+		}
+
+		/* La alarma toma el LCD: se descarta la edición en curso y lo ya
+		 * confirmado se graba como si se hubiera salido con ESC */
+		if (EV_MEN_ALARM_EXIT == p_task_menu_dta->event)
+		{
+			p_task_menu_dta->flag = false;
+			if (ST_MEN_IDLE != p_task_menu_dta->state)
+			{
+				p_task_menu_dta->cfg = cfg;
+				p_task_menu_dta->state = ST_MEN_IDLE;
+				menu_save_pending = true;
+			}
 		}
 
 		switch (p_task_menu_dta->state)
 		{
-		// ----------------------------------------------------------------
-		// ESTADO 1: IDLE
-		// ----------------------------------------------------------------
 		case ST_MEN_IDLE:
 			// Si presiona ENTER, va al menú principal
 			if ((true == p_task_menu_dta->flag) && (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event))
 			{
-				p_task_menu_dta->flag = false;
-				p_task_menu_dta->state = ST_MEN_MAIN_SELECT;
+				p_task_menu_dta->state = ST_MEN_BROWSE;
+				p_task_menu_dta->node = MENU_ID_ROOT;
+				p_task_menu_dta->depth = 0;
 				p_task_menu_dta->current_selection = 0;
+				p_task_menu_dta->b_dirty = true;
 			}
 			break;
 
-		// ----------------------------------------------------------------
-		// ESTADO 2: SELECCIÓN PRINCIPAL (Temp / Presion / Alarma)
-		// ----------------------------------------------------------------
-		case ST_MEN_MAIN_SELECT:
-			put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, "Configurar:     ");
-
-			put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-			if (p_task_menu_dta->current_selection == 0)      put_cmd_task_display(CMD_DISP_WRITE_STR, "> Temperatura   ");
-			else if (p_task_menu_dta->current_selection == 1) put_cmd_task_display(CMD_DISP_WRITE_STR, "> Presion       ");
-			else if (p_task_menu_dta->current_selection == 2) put_cmd_task_display(CMD_DISP_WRITE_STR, "> Alarmas       ");
-
+		case ST_MEN_BROWSE:
 			if (true == p_task_menu_dta->flag)
 			{
-				p_task_menu_dta->flag = false;
-				if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-				{
-					// Cíclico: 0 -> 1 -> 2 -> 0
-					p_task_menu_dta->current_selection = (p_task_menu_dta->current_selection + 1) % 3;
-				}
-				else if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-				{
-					if (p_task_menu_dta->current_selection > 0)
-						p_task_menu_dta->current_selection--;
-					else
-						p_task_menu_dta->current_selection = 2;
-				}
-				else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
+				p_node = &menu_node_list[p_task_menu_dta->node];
+				if (MENU_NODE_LIST == p_node->type)
 				{
-					if (p_task_menu_dta->current_selection == 0) p_task_menu_dta->state = ST_MEN_TEMP_SELECT;
-					else if (p_task_menu_dta->current_selection == 1) p_task_menu_dta->state = ST_MEN_PRESS_SELECT;
-					else p_task_menu_dta->state = ST_MEN_ALARM_SELECT;
-
-					p_task_menu_dta->current_selection = 0;
+					menu_list_event(p_task_menu_dta, p_node);
 				}
-				else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
+				else
 				{
-					p_task_menu_dta->state = ST_MEN_SAVING;
+					menu_edit_event(p_task_menu_dta, p_node, &cfg, p_shared_data);
 				}
+				p_task_menu_dta->b_dirty = true;
 			}
 			break;
 
-		case ST_MEN_SAVING:
-			status = eeprom_write_async(MENU_CFG_ADDR,
-										&p_shared_data->cfg,
-										sizeof(p_shared_data->cfg));
-			if (HAL_OK == status)
-			{
-				p_task_menu_dta->state = ST_MEN_IDLE;
-				put_event_task_system(EV_SYS_EXIT_MENU);
-			}
+		default:
 			break;
+		}
 
-		// ----------------------------------------------------------------
-		// RAMA TEMPERATURA: SELECCIÓN (Setpoint vs Histéresis)
-		// ----------------------------------------------------------------
-		case ST_MEN_TEMP_SELECT:
-			put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, "Config. Temp:   ");
+		// Lo que el estado no atiende se descarta, no queda para otro estado
+		p_task_menu_dta->flag = false;
+	}
 
-			put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-			if (p_task_menu_dta->current_selection == 0)      put_cmd_task_display(CMD_DISP_WRITE_STR, "> Setpoint      ");
-			else if (p_task_menu_dta->current_selection == 1) put_cmd_task_display(CMD_DISP_WRITE_STR, "> Histeresis    ");
+	if ((true == menu_save_pending) && (false == eeprom_is_busy()))
+	{
+		menu_saved_cfg = cfg;
+		if (HAL_OK == eeprom_write_async(EEPROM_CFG_ADDR, &menu_saved_cfg, sizeof(menu_saved_cfg)))
+		{
+			menu_save_pending = false;
+		}
+	}
 
-			if (true == p_task_menu_dta->flag)
-			{
-				p_task_menu_dta->flag = false;
-				if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-				{
-					p_task_menu_dta->current_selection = (p_task_menu_dta->current_selection + 1) % 2;
-				} else if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-				{
-					if (p_task_menu_dta->current_selection > 0)
-						p_task_menu_dta->current_selection--;
-					else
-						p_task_menu_dta->current_selection = 1;
-				}
-				else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
-				{
-					if (p_task_menu_dta->current_selection == 0) p_task_menu_dta->state = ST_MEN_MOD_TEMP_SET;
-					else p_task_menu_dta->state = ST_MEN_MOD_TEMP_HYS;
-				}
-				else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
-				{
-					p_task_menu_dta->state = ST_MEN_MAIN_SELECT;
-					p_task_menu_dta->current_selection = 0;
-				}
-			}
-			break;
+	switch (p_task_menu_dta->state)
+	{
+	case ST_MEN_IDLE:
+		break;
+
+	case ST_MEN_BROWSE:
+		p_node = &menu_node_list[p_task_menu_dta->node];
 
-		// ----------------------------------------------------------------
-		// RAMA TEMPERATURA: MODIFICAR SETPOINT
-		// ----------------------------------------------------------------
-		case ST_MEN_MOD_TEMP_SET:
-			put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, "Setpoint Temp:  ");
+		// Sin cambios solo se vuelve a dibujar si muestra algo de otra tarea
+		if (DEL_MEN_XX_MIN < p_task_menu_dta->tick)
+		{
+			p_task_menu_dta->tick -= (TASK_MENU_PERIOD < p_task_menu_dta->tick)
+									 ? TASK_MENU_PERIOD : p_task_menu_dta->tick;
+		}
+		else if (menu_is_live(p_task_menu_dta, p_node))
+		{
+			p_task_menu_dta->b_dirty = true;
+		}
 
-			put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-			// Muestra el valor actual que estamos editando
-			snprintf(menu_str, sizeof(menu_str), "     %2lu \xDF""C      ", p_task_menu_dta->cfg.temp_setpoint);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, menu_str);
+		if (true == p_task_menu_dta->b_dirty)
+		{
+			p_task_menu_dta->b_dirty = false;
+			p_task_menu_dta->tick = DEL_MEN_XX_MAX;
+			menu_render(p_task_menu_dta, p_node);
+		}
+		break;
 
-			if (true == p_task_menu_dta->flag)
+	case ST_MEN_SAVING:
+		if (false == eeprom_is_busy())
+		{
+			menu_saved_cfg = cfg;
+			status = eeprom_write_async(EEPROM_CFG_ADDR,
+										&menu_saved_cfg,
+										sizeof(menu_saved_cfg));
+			if (HAL_OK == status)
 			{
-				p_task_menu_dta->flag = false;
-				if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-				{
-					p_task_menu_dta->cfg.temp_setpoint++;
-					if(p_task_menu_dta->cfg.temp_setpoint > TEMP_SETPOINT_MAX) p_task_menu_dta->cfg.temp_setpoint = TEMP_SETPOINT_MIN;
-				}
-				else if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-				{
-					if (p_task_menu_dta->cfg.temp_setpoint > TEMP_SETPOINT_MIN)
-						p_task_menu_dta->cfg.temp_setpoint--;
-					else
-						p_task_menu_dta->cfg.temp_setpoint = TEMP_SETPOINT_MAX;
-				}
-				else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
-				{
-					// Volvemos y guardamos el valor seteado
-					p_task_menu_dta->state = ST_MEN_TEMP_SELECT;
-					p_shared_data->cfg.temp_setpoint = p_task_menu_dta->cfg.temp_setpoint;
-				}
-				else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
-				{
-					// Volvemos y restauramos el valor anterior
-					p_task_menu_dta->state = ST_MEN_TEMP_SELECT;
-					p_task_menu_dta->cfg.temp_setpoint = p_shared_data->cfg.temp_setpoint;
-				}
+				menu_save_pending = false;
+				p_task_menu_dta->state = ST_MEN_IDLE;
+				put_event_task_system(EV_SYS_EXIT_MENU);
 			}
-			break;
+		}
+		break;
 
-		// ----------------------------------------------------------------
-		// RAMA TEMPERATURA: MODIFICAR HISTÉRESIS
-		// ----------------------------------------------------------------
-		case ST_MEN_MOD_TEMP_HYS:
-			put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, "Histeresis Temp:");
+	default:
 
-			put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-			snprintf(menu_str, sizeof(menu_str), "     %2lu \xDF""C      ", p_task_menu_dta->cfg.temp_hysteresis);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, menu_str);
+		p_task_menu_dta->tick  = DEL_MEN_XX_MAX;
+		p_task_menu_dta->state = ST_MEN_IDLE;
+		p_task_menu_dta->event = EV_MEN_ENT_IDLE;
+		p_task_menu_dta->flag  = false;
 
-			if (true == p_task_menu_dta->flag)
-			{
-				p_task_menu_dta->flag = false;
-				if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-				{
-					p_task_menu_dta->cfg.temp_hysteresis++;
-					if(p_task_menu_dta->cfg.temp_hysteresis > TEMP_HYSTERESIS_MAX) p_task_menu_dta->cfg.temp_hysteresis = TEMP_HYSTERESIS_MIN;
-				}
-				else if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-				{
-					if (p_task_menu_dta->cfg.temp_hysteresis > TEMP_HYSTERESIS_MIN)
-						p_task_menu_dta->cfg.temp_hysteresis--;
-					else
-						p_task_menu_dta->cfg.temp_hysteresis = TEMP_HYSTERESIS_MAX;
-				}
-				else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
-				{
-					// Volvemos y guardamos el valor seteado
-					p_task_menu_dta->state = ST_MEN_TEMP_SELECT;
-					p_shared_data->cfg.temp_hysteresis = p_task_menu_dta->cfg.temp_hysteresis;
-				}
-				else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
-				{
-					// Volvemos y restauramos el valor anterior
-					p_task_menu_dta->state = ST_MEN_TEMP_SELECT;
-					p_task_menu_dta->cfg.temp_hysteresis = p_shared_data->cfg.temp_hysteresis;
-				}
-			}
-			break;
+		break;
+	}
+}
 
-		// ----------------------------------------------------------------
-		// RAMA PRESIÓN: SELECCIÓN (Setpoint vs Histéresis)
-		// ----------------------------------------------------------------
-		case ST_MEN_PRESS_SELECT:
-			put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, "Config. Presion:");
+void recover_saved_cfg(system_config_t *cfg)
+{
+	const menu_node_t *p_node;
+	uint32_t value;
+	uint32_t index;
 
-			put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-			if (p_task_menu_dta->current_selection == 0)      put_cmd_task_display(CMD_DISP_WRITE_STR, "> Setpoint      ");
-			else if (p_task_menu_dta->current_selection == 1) put_cmd_task_display(CMD_DISP_WRITE_STR, "> Histeresis    ");
+	cfg->version = SYSTEM_CONFIG_VERSION;
+	cfg->temp_setpoint = TEMP_SETPOINT_INI;
+	cfg->temp_hysteresis = TEMP_HYSTERESIS_INI;
+	cfg->temp_alarm_limit = TEMP_ALARM_LIMIT_INI;
+	cfg->temp_mode = TEMP_MODE_INI;
+	cfg->temp_kp = TEMP_KP_INI;
+	cfg->temp_ki = TEMP_KI_INI;
+	cfg->temp_kd = TEMP_KD_INI;
+	cfg->press_setpoint = PRESS_SETPOINT_INI;
+	cfg->press_hysteresis = PRESS_HYSTERESIS_INI;
+	cfg->press_alarm_limit = PRESS_ALARM_LIMIT_INI;
+	cfg->alarm_enabled = ALARM_ENABLE_INI;
 
-			if (true == p_task_menu_dta->flag)
-			{
-				p_task_menu_dta->flag = false;
-				if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-				{
-					p_task_menu_dta->current_selection = (p_task_menu_dta->current_selection + 1) % 2;
-				}
-				else if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-				{
-					if (p_task_menu_dta->current_selection > 0)
-						p_task_menu_dta->current_selection--;
-					else
-						p_task_menu_dta->current_selection = 1;
-				}
-				else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
-				{
-					if (p_task_menu_dta->current_selection == 0) p_task_menu_dta->state = ST_MEN_MOD_PRESS_SET;
-					else p_task_menu_dta->state = ST_MEN_MOD_PRESS_HYS;
-				}
-				else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
-				{
-					p_task_menu_dta->state = ST_MEN_MAIN_SELECT;
-					p_task_menu_dta->current_selection = 1;
-				}
-			}
-			break;
+	system_config_t saved_cfg = {0};
+	eeprom_read(EEPROM_CFG_ADDR, (void*)&saved_cfg, sizeof(saved_cfg));
 
-		// ----------------------------------------------------------------
-		// RAMA PRESIÓN: MODIFICAR SETPOINT
-		// ----------------------------------------------------------------
-		case ST_MEN_MOD_PRESS_SET:
-			put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, "Setpoint Pres:  ");
+	// Una configuración de otra versión tiene otro formato o unidades
+	// (por ejemplo grados enteros), no se puede reinterpretar.
+	if (SYSTEM_CONFIG_VERSION != saved_cfg.version)
+		return;
 
-			put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-			// Muestra el valor actual que estamos editando
-			snprintf(menu_str, sizeof(menu_str), "     %3lu kPa   ", p_task_menu_dta->cfg.press_setpoint);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, menu_str);
+	// Solo usamos los datos de la EEPROM si están en el rango que permite
+	// el menú para ese campo. Si no, dejamos el valor por omisión.
+	for (index = 0; MENU_ID_QTY > index; index++)
+	{
+		p_node = &menu_node_list[index];
+		if ((MENU_NODE_VALUE != p_node->type) && (MENU_NODE_CHOICE != p_node->type))
+			continue;
 
-			if (true == p_task_menu_dta->flag)
-			{
-				p_task_menu_dta->flag = false;
-				if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-				{
-					p_task_menu_dta->cfg.press_setpoint++;
-					if(p_task_menu_dta->cfg.press_setpoint > PRESS_SETPOINT_MAX) p_task_menu_dta->cfg.press_setpoint = PRESS_SETPOINT_MIN;
-				}
-				else if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-				{
-					if (p_task_menu_dta->cfg.press_setpoint > PRESS_SETPOINT_MIN)
-						p_task_menu_dta->cfg.press_setpoint--;
-					else
-						p_task_menu_dta->cfg.press_setpoint = PRESS_SETPOINT_MAX;
-				}
-				else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
-				{
-					// Volvemos y guardamos el valor seteado
-					p_task_menu_dta->state = ST_MEN_PRESS_SELECT;
-					p_shared_data->cfg.press_setpoint = p_task_menu_dta->cfg.press_setpoint;
-				}
-				else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
-				{
-					// Volvemos y restauramos el valor anterior
-					p_task_menu_dta->state = ST_MEN_PRESS_SELECT;
-					p_task_menu_dta->cfg.press_setpoint = p_shared_data->cfg.press_setpoint;
-				}
-			}
-			break;
+		value = menu_field_get(&saved_cfg, p_node);
+		if (is_in_range(value, p_node->min, p_node->max))
+			menu_field_set(cfg, p_node, value);
+	}
+}
 
-		// ----------------------------------------------------------------
-		// RAMA PRESIÓN: MODIFICAR HISTÉRESIS
-		// ----------------------------------------------------------------
-		case ST_MEN_MOD_PRESS_HYS:
-			put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, "Histeresis Pres:");
+/********************** internal functions definition ************************/
 
-			put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-			snprintf(menu_str, sizeof(menu_str), "     %3lu kPa   ", p_task_menu_dta->cfg.press_hysteresis);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, menu_str);
+static void menu_render(task_menu_dta_t *p_task_menu_dta, const menu_node_t *p_node)
+{
+	const menu_node_t *p_item;
+	uint32_t value;
 
-			if (true == p_task_menu_dta->flag)
-			{
-				p_task_menu_dta->flag = false;
-				if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-				{
-					p_task_menu_dta->cfg.press_hysteresis++;
-					if (p_task_menu_dta->cfg.press_hysteresis > PRESS_HYSTERESIS_MAX) p_task_menu_dta->cfg.press_hysteresis = PRESS_HYSTERESIS_MIN;
-				}
-				else if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-				{
-					if (p_task_menu_dta->cfg.press_hysteresis > PRESS_HYSTERESIS_MIN)
-						p_task_menu_dta->cfg.press_hysteresis--;
-					else
-						p_task_menu_dta->cfg.press_hysteresis = PRESS_HYSTERESIS_MAX;
-				}
-				else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
-				{
-					// Volvemos y guardamos el valor seteado
-					p_task_menu_dta->state = ST_MEN_PRESS_SELECT;
-					p_shared_data->cfg.press_hysteresis = p_task_menu_dta->cfg.press_hysteresis;
-				}
-				else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
-				{
-					// Volvemos y restauramos el valor anterior
-					p_task_menu_dta->state = ST_MEN_PRESS_SELECT;
-					p_task_menu_dta->cfg.press_hysteresis = p_shared_data->cfg.press_hysteresis;
-				}
-			}
-			break;
+	put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
+	put_cmd_task_display(CMD_DISP_WRITE_STR, (NULL != p_node->title_fn) ? p_node->title_fn(p_node) : p_node->title);
 
-			// ----------------------------------------------------------------
-			// RAMA ALARMAS: SELECCIÓN (Habilitación, Temp, Presión)
-			// ----------------------------------------------------------------
-			case ST_MEN_ALARM_SELECT:
-				put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-				put_cmd_task_display(CMD_DISP_WRITE_STR, "Config. Alarmas:");
+	put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
+	switch (p_node->type)
+	{
+	case MENU_NODE_LIST:
+		p_item = &menu_node_list[p_node->p_child_list[p_task_menu_dta->current_selection]];
+		put_cmd_task_display(CMD_DISP_WRITE_STR, (NULL != p_item->item_fn) ? p_item->item_fn(p_item) : p_item->item);
+		break;
+
+	case MENU_NODE_VALUE:
+		// Muestra el valor que estamos editando, hasta 999.9 y 7 letras
+		// de unidad para no pasar de las 16 columnas
+		value = menu_field_get(&p_task_menu_dta->cfg, p_node);
+		if (MENU_VALUE_DISP_MAX < value)
+		{
+			value = MENU_VALUE_DISP_MAX;
+		}
+		snprintf(menu_str, sizeof(menu_str), "   %3" PRIu32 ".%1" PRIu32 " %-7.7s", value / 10, value % 10, p_node->unit);
+		put_cmd_task_display(CMD_DISP_WRITE_STR, menu_str);
+		break;
 
-				put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-				if (p_task_menu_dta->current_selection == 0)      put_cmd_task_display(CMD_DISP_WRITE_STR, "> Habilitacion  ");
-				else if (p_task_menu_dta->current_selection == 1) put_cmd_task_display(CMD_DISP_WRITE_STR, "> Limite Temp.  ");
-				else if (p_task_menu_dta->current_selection == 2) put_cmd_task_display(CMD_DISP_WRITE_STR, "> Limite Pres.  ");
+	case MENU_NODE_CHOICE:
+		value = menu_field_get(&p_task_menu_dta->cfg, p_node);
+		put_cmd_task_display(CMD_DISP_WRITE_STR, p_node->p_option_list[(p_node->max < value) ? p_node->max : value]);
+		break;
 
-				if (true == p_task_menu_dta->flag)
-				{
-					p_task_menu_dta->flag = false;
-					if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-					{
-						p_task_menu_dta->current_selection = (p_task_menu_dta->current_selection + 1) % 3;
-					}
-					else if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-					{
-						if (p_task_menu_dta->current_selection > 0)
-							p_task_menu_dta->current_selection--;
-						else
-							p_task_menu_dta->current_selection = 2;
-					}
-					else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
-					{
-						if (p_task_menu_dta->current_selection == 0)      p_task_menu_dta->state = ST_MEN_MOD_ALARM_EN;
-						else if (p_task_menu_dta->current_selection == 1) p_task_menu_dta->state = ST_MEN_MOD_ALARM_TLIM;
-						else if (p_task_menu_dta->current_selection == 2) p_task_menu_dta->state = ST_MEN_MOD_ALARM_PLIM;
-					}
-					else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
-					{
-						p_task_menu_dta->state = ST_MEN_MAIN_SELECT;
-						p_task_menu_dta->current_selection = 2;
-					}
-				}
-				break;
+	default:
+		break;
+	}
+}
 
-		// ----------------------------------------------------------------
-		// RAMA ALARMAS: HABILITACIÓN
-		// ----------------------------------------------------------------
-		case ST_MEN_MOD_ALARM_EN:
-			put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-			put_cmd_task_display(CMD_DISP_WRITE_STR, "Alarma activa?  ");
+// La página muestra algo que cambia sin que se toque un botón
+static bool menu_is_live(const task_menu_dta_t *p_task_menu_dta, const menu_node_t *p_node)
+{
+	const menu_node_t *p_item;
 
-			put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-			if (p_task_menu_dta->cfg.alarm_enabled) put_cmd_task_display(CMD_DISP_WRITE_STR, "> SI            ");
-			else                                    put_cmd_task_display(CMD_DISP_WRITE_STR, "> NO            ");
+	if (NULL != p_node->title_fn)
+		return true;
 
-			if (true == p_task_menu_dta->flag)
-			{
-				p_task_menu_dta->flag = false;
-				if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-				{
-					p_task_menu_dta->cfg.alarm_enabled = 1 - p_task_menu_dta->cfg.alarm_enabled;
-				}
-				if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-				{
-					// Toggle bool
-					p_task_menu_dta->cfg.alarm_enabled = 1 - p_task_menu_dta->cfg.alarm_enabled;
-				}
-				else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
-				{
-					// Volvemos y guardamos el valor seteado
-					p_task_menu_dta->state = ST_MEN_ALARM_SELECT;
-					p_shared_data->cfg.alarm_enabled = p_task_menu_dta->cfg.alarm_enabled;
-				}
-				else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
-				{
-					// Volvemos y restauramos el valor anterior
-					p_task_menu_dta->state = ST_MEN_ALARM_SELECT;
-					p_task_menu_dta->cfg.alarm_enabled = p_shared_data->cfg.alarm_enabled;
-				}
-			}
-			break;
+	if (MENU_NODE_LIST != p_node->type)
+		return false;
 
-			// ----------------------------------------------------------------
-			// RAMA ALARMAS: MODIFICAR LÍMITE DE TEMP
-			// ----------------------------------------------------------------
-			case ST_MEN_MOD_ALARM_TLIM:
-				put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-				put_cmd_task_display(CMD_DISP_WRITE_STR, "Alarma Temp:    ");
+	p_item = &menu_node_list[p_node->p_child_list[p_task_menu_dta->current_selection]];
 
-				put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-				snprintf(menu_str, sizeof(menu_str), "     %2lu \xDF""C      ", p_task_menu_dta->cfg.temp_alarm_limit);
-				put_cmd_task_display(CMD_DISP_WRITE_STR, menu_str);
+	return (NULL != p_item->item_fn);
+}
 
-				if (true == p_task_menu_dta->flag)
-				{
-					p_task_menu_dta->flag = false;
-					if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-					{
-						p_task_menu_dta->cfg.temp_alarm_limit++;
-						if (p_task_menu_dta->cfg.temp_alarm_limit > TEMP_SETPOINT_MAX) p_task_menu_dta->cfg.temp_alarm_limit = TEMP_SETPOINT_MIN;
-					}
-					else if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-					{
-						if (p_task_menu_dta->cfg.temp_alarm_limit > TEMP_SETPOINT_MIN)
-							p_task_menu_dta->cfg.temp_alarm_limit--;
-						else
-							p_task_menu_dta->cfg.temp_alarm_limit = TEMP_SETPOINT_MAX;
-					}
-					else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
-					{
-						// Volvemos y guardamos el valor seteado
-						p_task_menu_dta->state = ST_MEN_ALARM_SELECT;
-						p_shared_data->cfg.temp_alarm_limit = p_task_menu_dta->cfg.temp_alarm_limit;
-					}
-					else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
-					{
-						// Volvemos y restauramos el valor anterior
-						p_task_menu_dta->state = ST_MEN_ALARM_SELECT;
-						p_task_menu_dta->cfg.temp_alarm_limit = p_shared_data->cfg.temp_alarm_limit;
-					}
-				}
-				break;
-				// ----------------------------------------------------------------
-				// RAMA ALARMAS: MODIFICAR LÍMITE DE PRES
-				// ----------------------------------------------------------------
-				case ST_MEN_MOD_ALARM_PLIM:
-					put_cmd_task_display(CMD_DISP_TO_LINE_0, NULL);
-					put_cmd_task_display(CMD_DISP_WRITE_STR, "Alarma Presion: ");
-
-					put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
-					snprintf(menu_str, sizeof(menu_str), "     %3lu kPa   ", p_task_menu_dta->cfg.press_alarm_limit);
-					put_cmd_task_display(CMD_DISP_WRITE_STR, menu_str);
-
-					if (true == p_task_menu_dta->flag)
-					{
-						p_task_menu_dta->flag = false;
-						if (EV_MEN_NEX_ACTIVE == p_task_menu_dta->event)
-						{
-							p_task_menu_dta->cfg.press_alarm_limit++;
-							if (p_task_menu_dta->cfg.press_alarm_limit > PRESS_SETPOINT_MAX) p_task_menu_dta->cfg.press_alarm_limit = PRESS_SETPOINT_MIN;
-						}
-						else if (EV_MEN_PRE_ACTIVE == p_task_menu_dta->event)
-						{
-							if (p_task_menu_dta->cfg.press_alarm_limit > PRESS_SETPOINT_MIN)
-								p_task_menu_dta->cfg.press_alarm_limit--;
-							else
-								p_task_menu_dta->cfg.press_alarm_limit = PRESS_SETPOINT_MIN;
-						}
-						else if (EV_MEN_ENT_ACTIVE == p_task_menu_dta->event)
-						{
-							// Volvemos y guardamos el valor seteado
-							p_task_menu_dta->state = ST_MEN_ALARM_SELECT;
-							p_shared_data->cfg.press_alarm_limit = p_task_menu_dta->cfg.press_alarm_limit;
-						}
-						else if (EV_MEN_ESC_ACTIVE == p_task_menu_dta->event)
-						{
-							// Volvemos y restauramos el valor anterior
-							p_task_menu_dta->state = ST_MEN_ALARM_SELECT;
-							p_task_menu_dta->cfg.press_alarm_limit = p_shared_data->cfg.press_alarm_limit;
-						}
-					}
-					break;
+static void menu_list_event(task_menu_dta_t *p_task_menu_dta, const menu_node_t *p_node)
+{
+	uint32_t qty = p_node->child_qty;
+	const menu_node_t *p_child;
+	uint8_t child;
+	uint32_t steps;
 
-		default:
+	// En una lista la repetición acelerada mueve de a un item igual
+	task_menu_ev_t event = menu_event_steps(p_task_menu_dta->event, &steps);
 
-			p_task_menu_dta->tick  = DEL_MEN_XX_MAX;
-			p_task_menu_dta->state = ST_MEN_IDLE;
-			p_task_menu_dta->event = EV_MEN_ENT_IDLE;
-			p_task_menu_dta->flag  = false;
+	if (EV_MEN_NEX_ACTIVE == event)
+	{
+		// Cíclico: 0 -> 1 -> ... -> qty - 1 -> 0
+		p_task_menu_dta->current_selection = (p_task_menu_dta->current_selection + 1) % qty;
+	}
+	else if (EV_MEN_PRE_ACTIVE == event)
+	{
+		if (p_task_menu_dta->current_selection > 0)
+			p_task_menu_dta->current_selection--;
+		else
+			p_task_menu_dta->current_selection = qty - 1;
+	}
+	else if (EV_MEN_ENT_ACTIVE == event)
+	{
+		child = p_node->p_child_list[p_task_menu_dta->current_selection];
+		p_child = &menu_node_list[child];
 
-			break;
+		if (MENU_NODE_ACTION == p_child->type)
+		{
+			p_child->action(p_child);
+			if (0 != (p_child->flags & MENU_FLAG_BACK))
+				menu_back(p_task_menu_dta);
+		}
+		else
+		{
+			menu_enter(p_task_menu_dta, child);
+			if (NULL != p_child->action)
+				p_child->action(p_child);
 		}
 	}
+	else if (EV_MEN_ESC_ACTIVE == event)
+	{
+		if (0 == p_task_menu_dta->depth)
+			p_task_menu_dta->state = ST_MEN_SAVING;
+		else
+			menu_back(p_task_menu_dta);
+	}
 }
 
-void recover_saved_cfg(system_config_t *cfg)
+// Edita la copia del menú. ENT la publica y ESC la vuelve a la vigente.
+static void menu_edit_event(task_menu_dta_t *p_task_menu_dta, const menu_node_t *p_node,
+							system_config_t *p_cfg, shared_data_type *p_shared_data)
 {
-	cfg->temp_setpoint = TEMP_SETPOINT_INI;
-	cfg->temp_hysteresis = TEMP_HYSTERESIS_INI;
-	cfg->press_setpoint = PRESS_SETPOINT_INI;
-	cfg->press_hysteresis = PRESS_HYSTERESIS_INI;
-	cfg->alarm_enabled = ALARM_ENABLE_INI;
+	uint32_t value = menu_field_get(&p_task_menu_dta->cfg, p_node);
+	uint32_t steps;
+	task_menu_ev_t event = menu_event_steps(p_task_menu_dta->event, &steps);
+	uint32_t delta = p_node->step * steps;
 
-	system_config_t saved_cfg = {0};
-	eeprom_read(MENU_CFG_ADDR, (void*)&saved_cfg, sizeof(saved_cfg));
+	// Un paso múltiple se detiene en el extremo, el siguiente da la vuelta
+	if (EV_MEN_NEX_ACTIVE == event)
+	{
+		if (MENU_NODE_CHOICE == p_node->type)
+			value = (p_node->max > value) ? value + 1 : p_node->min;
+		else if (value + delta <= p_node->max)
+			value += delta;
+		else if (value < p_node->max)
+			value = p_node->max;
+		else
+			value = p_node->min;
+	}
+	else if (EV_MEN_PRE_ACTIVE == event)
+	{
+		if (MENU_NODE_CHOICE == p_node->type)
+			value = (p_node->min < value) ? value - 1 : p_node->max;
+		else if (value >= p_node->min + delta)
+			value -= delta;
+		else if (value > p_node->min)
+			value = p_node->min;
+		else
+			value = p_node->max;
+	}
+	else if (EV_MEN_ENT_ACTIVE == event)
+	{
+		// Volvemos y guardamos el valor seteado
+		menu_field_set(p_cfg, p_node, value);
+		snapshot_publish(&p_shared_data->cfg, p_cfg);
+		menu_back(p_task_menu_dta);
+	}
+	else if (EV_MEN_ESC_ACTIVE == event)
+	{
+		// Volvemos y restauramos el valor anterior
+		value = menu_field_get(p_cfg, p_node);
+		menu_back(p_task_menu_dta);
+	}
 
-	// Solo usamos los datos de la EEPROM si tienen valores razonables. Si no, dejamos el valor por omisión.
+	menu_field_set(&p_task_menu_dta->cfg, p_node, value);
+}
 
-	// Temperatura
-	if (is_in_range(saved_cfg.temp_setpoint, TEMP_SETPOINT_MIN, TEMP_SETPOINT_MAX))
-		cfg->temp_setpoint = saved_cfg.temp_setpoint;
+// Las repeticiones aceleradas son NEX o PRE de varios pasos
+static task_menu_ev_t menu_event_steps(task_menu_ev_t event, uint32_t *p_steps)
+{
+	switch (event)
+	{
+	case EV_MEN_NEX_ACTIVE_X5:
+		*p_steps = 5;
+		return EV_MEN_NEX_ACTIVE;
+	case EV_MEN_NEX_ACTIVE_X10:
+		*p_steps = 10;
+		return EV_MEN_NEX_ACTIVE;
+	case EV_MEN_PRE_ACTIVE_X5:
+		*p_steps = 5;
+		return EV_MEN_PRE_ACTIVE;
+	case EV_MEN_PRE_ACTIVE_X10:
+		*p_steps = 10;
+		return EV_MEN_PRE_ACTIVE;
+	default:
+		*p_steps = 1;
+		return event;
+	}
+}
 
-	if (is_in_range(saved_cfg.temp_hysteresis, TEMP_HYSTERESIS_MIN, TEMP_HYSTERESIS_MAX))
-		cfg->temp_hysteresis = saved_cfg.temp_hysteresis;
+static void menu_enter(task_menu_dta_t *p_task_menu_dta, uint8_t node)
+{
+	menu_pos_t *p_pos;
+
+	if (MENU_DEPTH_MAX <= p_task_menu_dta->depth)
+		return;
 
-	if (is_in_range(saved_cfg.temp_alarm_limit, TEMP_SETPOINT_MIN, TEMP_SETPOINT_MAX))
-		cfg->temp_alarm_limit = saved_cfg.temp_alarm_limit;
+	p_pos = &p_task_menu_dta->path[p_task_menu_dta->depth++];
+	p_pos->node = p_task_menu_dta->node;
+	p_pos->selection = (uint8_t)p_task_menu_dta->current_selection;
 
-	// Presión
-	if (is_in_range(saved_cfg.press_setpoint, PRESS_SETPOINT_MIN, PRESS_SETPOINT_MAX))
-		cfg->press_setpoint = saved_cfg.press_setpoint;
+	p_task_menu_dta->node = node;
+	p_task_menu_dta->current_selection = 0;
+}
 
-	if (is_in_range(saved_cfg.press_hysteresis, PRESS_HYSTERESIS_MIN, PRESS_HYSTERESIS_MAX))
-		cfg->press_hysteresis = saved_cfg.press_hysteresis;
+// Vuelve a la página de arriba con la opción por la que se había entrado
+static void menu_back(task_menu_dta_t *p_task_menu_dta)
+{
+	const menu_pos_t *p_pos;
 
-	if (is_in_range(saved_cfg.press_alarm_limit, PRESS_SETPOINT_MIN, PRESS_SETPOINT_MAX))
-		cfg->press_alarm_limit = saved_cfg.press_alarm_limit;
+	if (0 == p_task_menu_dta->depth)
+		return;
+
+	p_pos = &p_task_menu_dta->path[--p_task_menu_dta->depth];
+	p_task_menu_dta->node = p_pos->node;
+	p_task_menu_dta->current_selection = p_pos->selection;
+}
+
+static uint32_t menu_field_get(const system_config_t *p_cfg, const menu_node_t *p_node)
+{
+	const uint8_t *p_field = (const uint8_t*)p_cfg + p_node->field;
+	uint32_t value;
+
+	if (sizeof(uint8_t) == p_node->field_size)
+		return *p_field;
+
+	memcpy(&value, p_field, sizeof(value));
+	return value;
+}
 
-	// Alarma
-	if (is_in_range(saved_cfg.alarm_enabled, 0, 1))
-		cfg->alarm_enabled = saved_cfg.alarm_enabled;
+static void menu_field_set(system_config_t *p_cfg, const menu_node_t *p_node, uint32_t value)
+{
+	uint8_t *p_field = (uint8_t*)p_cfg + p_node->field;
+
+	if (sizeof(uint8_t) == p_node->field_size)
+		*p_field = (uint8_t)value;
+	else
+		memcpy(p_field, &value, sizeof(value));
+}
+
+/* ---------------------------------------------------------------------------
+ * Textos y acciones que dependen de otras tareas
+ * ------------------------------------------------------------------------- */
+
+static const char *menu_autotune_item(const menu_node_t *p_node)
+{
+	return task_temp_autotune_running() ? "> Autoajust. ..." : "> Autoajuste    ";
+}
+
+// Con una receta en curso las acciones van a esa, no a la elegida
+static const char *menu_recipe_title(const menu_node_t *p_node)
+{
+	recipe_status_t recipe_status;
+
+	task_recipe_get_status(&recipe_status);
+	snprintf(menu_str, sizeof(menu_str), "Receta %c:       ", '1' + recipe_status.slot);
+
+	return menu_str;
+}
+
+static const char *menu_recipe_item(const menu_node_t *p_node)
+{
+	snprintf(menu_str, sizeof(menu_str), "> Receta %c %s", '1' + p_node->arg,
+			task_recipe_is_valid(p_node->arg) ? "     " : "vacia");
+
+	return menu_str;
+}
+
+static const char *menu_recipe_pause_item(const menu_node_t *p_node)
+{
+	recipe_status_t recipe_status;
+
+	task_recipe_get_status(&recipe_status);
+
+	return recipe_status.paused ? "> Reanudar      " : "> Pausar        ";
+}
+
+static void menu_autotune_start(const menu_node_t *p_node)
+{
+	put_event_task_temp(EV_TEMP_AUTOTUNE);
+}
+
+static void menu_recipe_select(const menu_node_t *p_node)
+{
+	task_recipe_select(p_node->arg);
+}
+
+static void menu_recipe_event(const menu_node_t *p_node)
+{
+	put_event_task_recipe((task_recipe_ev_t)p_node->arg);
 }
 
 /********************** end of file ******************************************/
@@ -48,6 +48,7 @@
 #include "board.h"
 #include "app.h"
 #include "task_menu_attribute.h"
+#include "spsc_queue.h"
 
 /********************** macros and definitions *******************************/
 #define EVENT_UNDEFINED	(255)
@@ -58,55 +59,33 @@
 /********************** internal functions declaration ***********************/
 
 /********************** internal data definition *****************************/
-struct
-{
-	uint32_t	head;
-	uint32_t	tail;
-	uint32_t	count;
-	task_menu_ev_t	queue[MAX_EVENTS];
-} queue_task_menu;
+SPSC_QUEUE_DEFINE(queue_task_menu, MAX_EVENTS);
 
 /********************** external data declaration ****************************/
 
 /********************** external functions definition ************************/
 void init_queue_event_task_menu(void)
 {
-	uint32_t i;
-
-	queue_task_menu.head = 0;
-	queue_task_menu.tail = 0;
-	queue_task_menu.count = 0;
-
-	for (i = 0; i < MAX_EVENTS; i++)
-		queue_task_menu.queue[i] = EVENT_UNDEFINED;
+	spsc_queue_init(&queue_task_menu);
 }
 
 void put_event_task_menu(task_menu_ev_t event)
 {
-	queue_task_menu.count++;
-	queue_task_menu.queue[queue_task_menu.head++] = event;
-
-	if (MAX_EVENTS == queue_task_menu.head)
-		queue_task_menu.head = 0;
+	spsc_queue_put(&queue_task_menu, (uint8_t)event);
 }
 
 task_menu_ev_t get_event_task_menu(void)
 {
-	task_menu_ev_t event;
-
-	queue_task_menu.count--;
-	event = queue_task_menu.queue[queue_task_menu.tail];
-	queue_task_menu.queue[queue_task_menu.tail++] = EVENT_UNDEFINED;
+	uint8_t event = EVENT_UNDEFINED;
 
-	if (MAX_EVENTS == queue_task_menu.tail)
-		queue_task_menu.tail = 0;
+	spsc_queue_get(&queue_task_menu, &event);
 
-	return event;
+	return (task_menu_ev_t)event;
 }
 
 bool any_event_task_menu(void)
 {
-  return (queue_task_menu.head != queue_task_menu.tail);
+  return spsc_queue_any(&queue_task_menu);
 }
 
 /********************** end of file ******************************************/
@@ -26,7 +26,6 @@
 
 /********************** macros and definitions *******************************/
 #define G_TASK_PRESS_CNT_INI		0ul
-#define G_TASK_PRESS_TICK_CNT_INI	0ul
 
 
 /********************** internal data declaration ****************************/
@@ -43,7 +42,6 @@ const char *p_task_press_ 		= "Non-Blocking & Update By Time Code";
 
 /********************** external data declaration ****************************/
 uint32_t g_task_press_cnt;
-volatile uint32_t g_task_press_tick_cnt;
 
 /********************** external functions definition ************************/
 void task_press_init(void *parameters)
@@ -60,7 +58,7 @@ void task_press_init(void *parameters)
 	g_task_press_cnt = G_TASK_PRESS_CNT_INI;
 
 	/* Print out: Task execution counter */
-	LOGGER_LOG("   %s = %lu\r\n", GET_NAME(g_task_press_cnt), g_task_press_cnt);
+	LOGGER_LOG("   %s = %" PRIu32 "\r\n", GET_NAME(g_task_press_cnt), g_task_press_cnt);
 
 	init_queue_event_task_press();
 
@@ -69,15 +67,13 @@ void task_press_init(void *parameters)
 
 	/* Print out: Task execution FSM */
 	state = p_task_press_dta->state;
-	LOGGER_LOG("   %s = %lu", GET_NAME(state), (uint32_t)state);
+	LOGGER_LOG("   %s = %" PRIu32, GET_NAME(state), (uint32_t)state);
 
 	event = p_task_press_dta->event;
-	LOGGER_LOG("   %s = %lu", GET_NAME(event), (uint32_t)event);
+	LOGGER_LOG("   %s = %" PRIu32, GET_NAME(event), (uint32_t)event);
 
 	b_event = p_task_press_dta->flag;
 	LOGGER_LOG("   %s = %s\r\n", GET_NAME(b_event), (b_event ? "true" : "false"));
-
-	g_task_press_tick_cnt = G_TASK_PRESS_TICK_CNT_INI;
 }
 
 void task_press_update(void *parameters)
@@ -85,109 +81,103 @@ void task_press_update(void *parameters)
 	shared_data_type *shared_data = (shared_data_type*)parameters;
 
 	task_press_dta_t *p_task_press_dta;
-	bool b_time_update_required = false;
 
-	uint32_t press = press_raw_to_kPa(shared_data->pressure_raw);
+	sensor_frame_t frame;
+	system_config_t cfg;
+	setpoint_frame_t setpoint;
+	uint32_t press;
+
+	/* Medición y configuración consistentes para toda la ejecución */
+	snapshot_read(&shared_data->sensor, &frame);
+	snapshot_read(&shared_data->cfg, &cfg);
+	snapshot_read(&shared_data->setpoint, &setpoint);
+	press = frame.press;
+
+	/* Con una receta en curso manda su setpoint */
+	if (setpoint.active)
+	{
+		cfg.press_setpoint = setpoint.press;
+	}
 
 	/* Update Task System Counter */
 	g_task_press_cnt++;
 
-	/* Protect shared resource (g_task_press_tick) */
-	__asm("CPSID i");	/* disable interrupts*/
-    if (G_TASK_PRESS_TICK_CNT_INI < g_task_press_tick_cnt)
-    {
-    	g_task_press_tick_cnt--;
-    	b_time_update_required = true;
-    }
-    __asm("CPSIE i");	/* enable interrupts*/
-
-    while (b_time_update_required)
-    {
-		/* Protect shared resource (g_task_press_tick) */
-		__asm("CPSID i");	/* disable interrupts*/
-		if (G_TASK_PRESS_TICK_CNT_INI < g_task_press_tick_cnt)
+	/* Update Task Press Data Pointer */
+	p_task_press_dta = &task_press_dta;
+
+	if (true == any_event_task_press())
+	{
+		p_task_press_dta->flag = true;
+		p_task_press_dta->event = get_event_task_press();
+	}
+
+	task_press_statechart(p_task_press_dta, &cfg, press);
+}
+
+void task_press_statechart(task_press_dta_t *p_task_press_dta, const system_config_t *p_cfg, uint32_t press)
+{
+	switch (p_task_press_dta->state)
+	{
+	case ST_PRESS_OFF:
+		if ((true == p_task_press_dta->flag) && (EV_PRESS_ENABLE_ON == p_task_press_dta->event))
+		{
+			p_task_press_dta->flag = false;
+			p_task_press_dta->state = ST_PRESS_IDLE;
+			put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_VALVE);
+		}
+		break;
+
+	case ST_PRESS_IDLE:
+		if ((true == p_task_press_dta->flag) && (EV_PRESS_ENABLE_OFF == p_task_press_dta->event))
 		{
-			g_task_press_tick_cnt--;
-			b_time_update_required = true;
+			p_task_press_dta->flag = false;
+			p_task_press_dta->state = ST_PRESS_OFF;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_VALVE);
 		}
-		else
+		// Equivalente a (press < setpoint - hist) pero evita underflow si (hist > setpoint)
+		else if (press + p_cfg->press_hysteresis < p_cfg->press_setpoint)
 		{
-			b_time_update_required = false;
+			p_task_press_dta->state = ST_PRESS_RELEASE;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_VALVE);
 		}
-		__asm("CPSIE i");	/* enable interrupts*/
-
-    	/* Update Task Press Data Pointer */
-		p_task_press_dta = &task_press_dta;
+		else if (press > p_cfg->press_setpoint + p_cfg->press_hysteresis)
+		{
+			p_task_press_dta->state = ST_PRESS_VACUUM;
+			put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_PUMP);
+		}
+		break;
 
-		if (true == any_event_task_press())
+	case ST_PRESS_RELEASE:
+		if ((true == p_task_press_dta->flag) && (EV_PRESS_ENABLE_OFF == p_task_press_dta->event))
 		{
-			p_task_press_dta->flag = true;
-			p_task_press_dta->event = get_event_task_press();
+			p_task_press_dta->flag = false;
+			p_task_press_dta->state = ST_PRESS_OFF;
+			// No hace falta cerrar la válvula, tiene que quedar abierta
 		}
+		else if (press > p_cfg->press_setpoint)
+		{
+			p_task_press_dta->state = ST_PRESS_IDLE;
+			put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_VALVE);
+		}
+		break;
 
-		switch (p_task_press_dta->state)
+	case ST_PRESS_VACUUM:
+		if ((true == p_task_press_dta->flag) && (EV_PRESS_ENABLE_OFF == p_task_press_dta->event))
 		{
-		case ST_PRESS_OFF:
-			if ((true == p_task_press_dta->flag) && (EV_PRESS_ENABLE_ON == p_task_press_dta->event))
-			{
-				p_task_press_dta->flag = false;
-				p_task_press_dta->state = ST_PRESS_IDLE;
-				put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_VALVE);
-			}
-			break;
-
-		case ST_PRESS_IDLE:
-			if ((true == p_task_press_dta->flag) && (EV_PRESS_ENABLE_OFF == p_task_press_dta->event))
-			{
-				p_task_press_dta->flag = false;
-				p_task_press_dta->state = ST_PRESS_OFF;
-				put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_VALVE);
-			}
-			// Equivalente a (press < setpoint - hist) pero evita underflow si (hist > setpoint)
-			else if (press + shared_data->cfg.press_hysteresis < shared_data->cfg.press_setpoint)
-			{
-				p_task_press_dta->state = ST_PRESS_RELEASE;
-				put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_VALVE);
-			}
-			else if (press > shared_data->cfg.press_setpoint + shared_data->cfg.press_hysteresis)
-			{
-				p_task_press_dta->state = ST_PRESS_VACUUM;
-				put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_PUMP);
-			}
-			break;
-
-		case ST_PRESS_RELEASE:
-			if ((true == p_task_press_dta->flag) && (EV_PRESS_ENABLE_OFF == p_task_press_dta->event))
-			{
-				p_task_press_dta->flag = false;
-				p_task_press_dta->state = ST_PRESS_OFF;
-				// No hace falta cerrar la válvula, tiene que quedar abierta
-			}
-			else if (press > shared_data->cfg.press_setpoint)
-			{
-				p_task_press_dta->state = ST_PRESS_IDLE;
-				put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_VALVE);
-			}
-			break;
-
-		case ST_PRESS_VACUUM:
-			if ((true == p_task_press_dta->flag) && (EV_PRESS_ENABLE_OFF == p_task_press_dta->event))
-			{
-				p_task_press_dta->flag = false;
-				p_task_press_dta->state = ST_PRESS_OFF;
-				put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_PUMP);
-				put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_VALVE);
-			}
-			else if (press < shared_data->cfg.press_setpoint)
-			{
-				p_task_press_dta->state = ST_PRESS_IDLE;
-				put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_PUMP);
-			}
-			break;
-
-		default:
-			break;
+			p_task_press_dta->flag = false;
+			p_task_press_dta->state = ST_PRESS_OFF;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_PUMP);
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_VALVE);
 		}
+		else if (press < p_cfg->press_setpoint)
+		{
+			p_task_press_dta->state = ST_PRESS_IDLE;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_PUMP);
+		}
+		break;
+
+	default:
+		break;
 	}
 }
 
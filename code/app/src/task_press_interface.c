@@ -17,6 +17,7 @@
 #include "board.h"
 #include "app.h"
 #include "task_press_attribute.h"
+#include "spsc_queue.h"
 
 /********************** macros and definitions *******************************/
 #define EVENT_UNDEFINED	(255)
@@ -27,56 +28,33 @@
 /********************** internal functions declaration ***********************/
 
 /********************** internal data definition *****************************/
-struct
-{
-	uint32_t	head;
-	uint32_t	tail;
-	uint32_t	count;
-	task_press_ev_t	queue[MAX_EVENTS];
-} queue_task_press;
+SPSC_QUEUE_DEFINE(queue_task_press, MAX_EVENTS);
 
 /********************** external data declaration ****************************/
 
 /********************** external functions definition ************************/
 void init_queue_event_task_press(void)
 {
-	uint32_t i;
-
-	queue_task_press.head = 0;
-	queue_task_press.tail = 0;
-	queue_task_press.count = 0;
-
-	for (i = 0; i < MAX_EVENTS; i++)
-		queue_task_press.queue[i] = EVENT_UNDEFINED;
+	spsc_queue_init(&queue_task_press);
 }
 
 void put_event_task_press(task_press_ev_t event)
 {
-	queue_task_press.count++;
-	queue_task_press.queue[queue_task_press.head++] = event;
-
-	if (MAX_EVENTS == queue_task_press.head)
-		queue_task_press.head = 0;
+	spsc_queue_put(&queue_task_press, (uint8_t)event);
 }
 
 task_press_ev_t get_event_task_press(void)
-
 {
-	task_press_ev_t event;
-
-	queue_task_press.count--;
-	event = queue_task_press.queue[queue_task_press.tail];
-	queue_task_press.queue[queue_task_press.tail++] = EVENT_UNDEFINED;
+	uint8_t event = EVENT_UNDEFINED;
 
-	if (MAX_EVENTS == queue_task_press.tail)
-		queue_task_press.tail = 0;
+	spsc_queue_get(&queue_task_press, &event);
 
-	return event;
+	return (task_press_ev_t)event;
 }
 
 bool any_event_task_press(void)
 {
-  return (queue_task_press.head != queue_task_press.tail);
+  return spsc_queue_any(&queue_task_press);
 }
 
 /********************** end of file ******************************************/
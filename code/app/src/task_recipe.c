@@ -0,0 +1,370 @@
+/*
+ * @file   : task_recipe.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+/* Project includes. */
+#include "main.h"
+
+/* Demo includes. */
+#include "logger.h"
+#include "dwt.h"
+
+/* Application & Tasks includes. */
+#include "board.h"
+#include "app.h"
+#include "task_recipe.h"
+#include "task_recipe_attribute.h"
+#include "task_recipe_interface.h"
+#include "task_system.h"
+#include "eeprom.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+/********************** macros and definitions *******************************/
+#define G_TASK_REC_CNT_INI			0ul
+
+#define MS_PER_MIN					60000ul
+
+/* Margen para dar por alcanzado el final de un segmento */
+#define RECIPE_TEMP_BAND			10ul	// 1.0 celsius
+#define RECIPE_PRESS_BAND			10ul	// 1.0 kPa
+
+_Static_assert(sizeof(recipe_t) <= EEPROM_RECIPE_SLOT_SIZE,
+			   "recipe_t does not fit in its EEPROM slot");
+
+/********************** internal data declaration ****************************/
+task_recipe_dta_t task_recipe_dta =
+	{ST_REC_IDLE, EV_REC_ABORT, false, ST_REC_IDLE, 0, 0, 0, 0, 0, 0, {false, 0, 0}};
+
+#define RECIPE_DTA_QTY	(sizeof(task_recipe_dta)/sizeof(task_recipe_dta_t))
+
+/********************** internal functions declaration ***********************/
+static bool recipe_is_valid(const recipe_t *p_recipe);
+static void recipe_segment_begin(task_recipe_dta_t *p_task_recipe_dta);
+static void recipe_segment_next(task_recipe_dta_t *p_task_recipe_dta);
+static void recipe_ramp(task_recipe_dta_t *p_task_recipe_dta, uint32_t elapsed);
+
+/********************** internal data definition *****************************/
+const char *p_task_recipe 		= "Task Recipe (Setpoint profiles)";
+const char *p_task_recipe_ 		= "Non-Blocking & Update By Time Code";
+
+/* Copia en RAM de las recetas de la EEPROM, se leen una sola vez al inicio */
+static recipe_t recipe_list[RECIPE_SLOT_QTY];
+
+/* Receta de ejemplo para una EEPROM sin recetas: bajar a 10 kPa a 25 °C,
+ * después 3 vueltas de rampa a 70 °C a 2 °C/min, 4 h, y vuelta a 25 °C */
+static const recipe_t recipe_default = {
+	RECIPE_MAGIC, 3, 3, 1,
+	{
+		{250, 100,  0,   0},
+		{700, 100, 20, 240},
+		{250, 100, 20,  30},
+	}
+};
+
+/* La receta de ejemplo se graba cuando la EEPROM se libera */
+static bool recipe_default_save_pending = false;
+
+/********************** external data declaration ****************************/
+uint32_t g_task_recipe_cnt;
+
+/********************** external functions definition ************************/
+void task_recipe_init(void *parameters)
+{
+	task_recipe_dta_t *p_task_recipe_dta;
+	task_recipe_st_t	state;
+	task_recipe_ev_t	event;
+	bool b_event;
+	uint32_t slot;
+
+	shared_data_type *p_shared_data = (shared_data_type *)parameters;
+
+	/* Print out: Task Initialized */
+	LOGGER_LOG("  %s is running - %s\r\n", GET_NAME(task_recipe_init), p_task_recipe);
+	LOGGER_LOG("  %s is a %s\r\n", GET_NAME(task_recipe), p_task_recipe_);
+
+	g_task_recipe_cnt = G_TASK_REC_CNT_INI;
+
+	/* Print out: Task execution counter */
+	LOGGER_LOG("   %s = %" PRIu32 "\r\n", GET_NAME(g_task_recipe_cnt), g_task_recipe_cnt);
+
+	init_queue_event_task_recipe();
+
+	/* Update Task Recipe Data Pointer */
+	p_task_recipe_dta = &task_recipe_dta;
+
+	/* Print out: Task execution FSM */
+	state = p_task_recipe_dta->state;
+	LOGGER_LOG("   %s = %" PRIu32, GET_NAME(state), (uint32_t)state);
+
+	event = p_task_recipe_dta->event;
+	LOGGER_LOG("   %s = %" PRIu32, GET_NAME(event), (uint32_t)event);
+
+	b_event = p_task_recipe_dta->flag;
+	LOGGER_LOG("   %s = %s\r\n", GET_NAME(b_event), (b_event ? "true" : "false"));
+
+	// Lectura bloqueante, como la de la configuración, solo al inicio
+	for (slot = 0; RECIPE_SLOT_QTY > slot; slot++)
+	{
+		eeprom_read(EEPROM_RECIPE_ADDR + slot * EEPROM_RECIPE_SLOT_SIZE,
+					&recipe_list[slot], sizeof(recipe_t));
+	}
+
+	if (false == recipe_is_valid(&recipe_list[0]))
+	{
+		recipe_list[0] = recipe_default;
+		recipe_default_save_pending = true;
+	}
+
+	snapshot_publish(&p_shared_data->setpoint, &p_task_recipe_dta->setpoint);
+}
+
+void task_recipe_update(void *parameters)
+{
+	shared_data_type *p_shared_data = (shared_data_type *)parameters;
+	task_recipe_dta_t *p_task_recipe_dta;
+	const recipe_segment_t *p_segment;
+	sensor_frame_t frame;
+	uint32_t elapsed;
+	bool b_publish = false;
+
+	/* Update Task Recipe Counter */
+	g_task_recipe_cnt++;
+
+	/* Update Task Recipe Data Pointer */
+	p_task_recipe_dta = &task_recipe_dta;
+
+	if ((true == recipe_default_save_pending)
+			&& (HAL_OK == eeprom_write_async(EEPROM_RECIPE_ADDR, &recipe_list[0], sizeof(recipe_t))))
+	{
+		recipe_default_save_pending = false;
+	}
+
+	if (true == any_event_task_recipe())
+	{
+		p_task_recipe_dta->flag = true;
+		p_task_recipe_dta->event = get_event_task_recipe();
+	}
+
+	/* El tiempo se mide con g_app_tick para no perder las ejecuciones que
+	 * el scheduler saltea. En pausa no se acumula, y tampoco con el sistema
+	 * deshabilitado: los controles no siguen el setpoint, así que la rampa
+	 * y la meseta esperan a que se vuelva a habilitar. */
+	elapsed = g_app_tick - p_task_recipe_dta->last_tick;
+	p_task_recipe_dta->last_tick = g_app_tick;
+	if (false == task_system_is_enabled())
+	{
+		elapsed = 0;
+	}
+
+	p_segment = &recipe_list[p_task_recipe_dta->slot].segment[p_task_recipe_dta->segment];
+
+	switch (p_task_recipe_dta->state)
+	{
+	case ST_REC_IDLE:
+		if ((true == p_task_recipe_dta->flag) && (EV_REC_START == p_task_recipe_dta->event))
+		{
+			p_task_recipe_dta->flag = false;
+			if (recipe_is_valid(&recipe_list[p_task_recipe_dta->slot]))
+			{
+				/* La primera rampa arranca desde la temperatura medida */
+				snapshot_read(&p_shared_data->sensor, &frame);
+				p_task_recipe_dta->segment = 0;
+				p_task_recipe_dta->cycle = 0;
+				p_task_recipe_dta->setpoint.temp = frame.temp;
+				p_task_recipe_dta->setpoint.active = true;
+				recipe_segment_begin(p_task_recipe_dta);
+				b_publish = true;
+			}
+		}
+		else
+		{
+			p_task_recipe_dta->flag = false;
+		}
+		break;
+
+	case ST_REC_RAMP:
+	case ST_REC_WAIT:
+	case ST_REC_SOAK:
+		if ((true == p_task_recipe_dta->flag) && (EV_REC_PAUSE == p_task_recipe_dta->event))
+		{
+			p_task_recipe_dta->flag = false;
+			p_task_recipe_dta->paused_state = p_task_recipe_dta->state;
+			p_task_recipe_dta->state = ST_REC_PAUSED;
+		}
+		else if ((true == p_task_recipe_dta->flag) && (EV_REC_ABORT == p_task_recipe_dta->event))
+		{
+			p_task_recipe_dta->flag = false;
+			p_task_recipe_dta->state = ST_REC_IDLE;
+			p_task_recipe_dta->setpoint.active = false;
+			b_publish = true;
+		}
+		else if (ST_REC_RAMP == p_task_recipe_dta->state)
+		{
+			recipe_ramp(p_task_recipe_dta, elapsed);
+			b_publish = true;
+		}
+		else if (ST_REC_WAIT == p_task_recipe_dta->state)
+		{
+			snapshot_read(&p_shared_data->sensor, &frame);
+			if ((frame.temp + RECIPE_TEMP_BAND >= p_segment->temp)
+					&& (frame.temp <= p_segment->temp + RECIPE_TEMP_BAND)
+					&& (frame.press + RECIPE_PRESS_BAND >= p_segment->press)
+					&& (frame.press <= p_segment->press + RECIPE_PRESS_BAND))
+			{
+				p_task_recipe_dta->elapsed = 0;
+				p_task_recipe_dta->state = ST_REC_SOAK;
+			}
+		}
+		else
+		{
+			p_task_recipe_dta->elapsed += elapsed;
+			if (p_task_recipe_dta->elapsed >= p_segment->soak * MS_PER_MIN)
+			{
+				recipe_segment_next(p_task_recipe_dta);
+				b_publish = true;
+			}
+		}
+
+		// Lo que el estado no atiende se descarta, un START no queda
+		// pendiente hasta que la receta termine
+		p_task_recipe_dta->flag = false;
+		break;
+
+	case ST_REC_PAUSED:
+		// Los setpoints quedan donde estaban hasta reanudar
+		if ((true == p_task_recipe_dta->flag) && (EV_REC_PAUSE == p_task_recipe_dta->event))
+		{
+			p_task_recipe_dta->flag = false;
+			p_task_recipe_dta->state = p_task_recipe_dta->paused_state;
+		}
+		else if ((true == p_task_recipe_dta->flag) && (EV_REC_ABORT == p_task_recipe_dta->event))
+		{
+			p_task_recipe_dta->flag = false;
+			p_task_recipe_dta->state = ST_REC_IDLE;
+			p_task_recipe_dta->setpoint.active = false;
+			b_publish = true;
+		}
+
+		p_task_recipe_dta->flag = false;
+		break;
+
+	default:
+		break;
+	}
+
+	if (b_publish)
+	{
+		snapshot_publish(&p_shared_data->setpoint, &p_task_recipe_dta->setpoint);
+	}
+}
+
+// Solo se puede cambiar de receta con el motor detenido
+void task_recipe_select(uint8_t slot)
+{
+	if ((RECIPE_SLOT_QTY > slot) && (ST_REC_IDLE == task_recipe_dta.state))
+	{
+		task_recipe_dta.slot = slot;
+	}
+}
+
+bool task_recipe_is_valid(uint8_t slot)
+{
+	return (RECIPE_SLOT_QTY > slot) && recipe_is_valid(&recipe_list[slot]);
+}
+
+void task_recipe_get_status(recipe_status_t *p_status)
+{
+	p_status->running = (ST_REC_IDLE != task_recipe_dta.state);
+	p_status->paused = (ST_REC_PAUSED == task_recipe_dta.state);
+	p_status->slot = task_recipe_dta.slot;
+	p_status->segment = task_recipe_dta.segment;
+	p_status->segment_qty = recipe_list[task_recipe_dta.slot].segment_qty;
+	p_status->cycle = task_recipe_dta.cycle;
+}
+
+static bool recipe_is_valid(const recipe_t *p_recipe)
+{
+	return (RECIPE_MAGIC == p_recipe->magic)
+			&& (0 < p_recipe->segment_qty) && (RECIPE_SEGMENT_MAX >= p_recipe->segment_qty)
+			&& (0 < p_recipe->cycles)
+			&& (p_recipe->segment_qty > p_recipe->loop_first);
+}
+
+// La rampa sale del setpoint actual, así un segmento encadena con el anterior
+static void recipe_segment_begin(task_recipe_dta_t *p_task_recipe_dta)
+{
+	const recipe_segment_t *p_segment =
+			&recipe_list[p_task_recipe_dta->slot].segment[p_task_recipe_dta->segment];
+
+	p_task_recipe_dta->elapsed = 0;
+	p_task_recipe_dta->ramp_from = p_task_recipe_dta->setpoint.temp;
+	p_task_recipe_dta->setpoint.press = p_segment->press;
+
+	if (0 == p_segment->rate)
+	{
+		p_task_recipe_dta->setpoint.temp = p_segment->temp;
+		p_task_recipe_dta->state = ST_REC_WAIT;
+	}
+	else
+	{
+		p_task_recipe_dta->state = ST_REC_RAMP;
+	}
+}
+
+static void recipe_segment_next(task_recipe_dta_t *p_task_recipe_dta)
+{
+	const recipe_t *p_recipe = &recipe_list[p_task_recipe_dta->slot];
+
+	p_task_recipe_dta->segment++;
+	if (p_recipe->segment_qty <= p_task_recipe_dta->segment)
+	{
+		p_task_recipe_dta->cycle++;
+		if (p_recipe->cycles <= p_task_recipe_dta->cycle)
+		{
+			/* Terminada: vuelven a valer los setpoints de la configuración */
+			p_task_recipe_dta->segment = 0;
+			p_task_recipe_dta->state = ST_REC_IDLE;
+			p_task_recipe_dta->setpoint.active = false;
+			return;
+		}
+		p_task_recipe_dta->segment = p_recipe->loop_first;
+	}
+
+	recipe_segment_begin(p_task_recipe_dta);
+}
+
+// rate * elapsed no desborda: con la rampa más lenta el segmento termina
+// mucho antes de que el producto pase de 32 bits
+static void recipe_ramp(task_recipe_dta_t *p_task_recipe_dta, uint32_t elapsed)
+{
+	const recipe_segment_t *p_segment =
+			&recipe_list[p_task_recipe_dta->slot].segment[p_task_recipe_dta->segment];
+	uint32_t from = p_task_recipe_dta->ramp_from;
+	uint32_t span = (p_segment->temp > from) ? (p_segment->temp - from) : (from - p_segment->temp);
+	uint32_t delta;
+
+	p_task_recipe_dta->elapsed += elapsed;
+	delta = (p_segment->rate * p_task_recipe_dta->elapsed) / MS_PER_MIN;
+
+	if (delta >= span)
+	{
+		p_task_recipe_dta->setpoint.temp = p_segment->temp;
+		p_task_recipe_dta->state = ST_REC_WAIT;
+	}
+	else if (p_segment->temp > from)
+	{
+		p_task_recipe_dta->setpoint.temp = (uint16_t)(from + delta);
+	}
+	else
+	{
+		p_task_recipe_dta->setpoint.temp = (uint16_t)(from - delta);
+	}
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,60 @@
+/*
+ * @file   : task_recipe_interface.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+/* Project includes. */
+#include "main.h"
+
+/* Demo includes. */
+#include "logger.h"
+#include "dwt.h"
+
+/* Application & Tasks includes. */
+#include "board.h"
+#include "app.h"
+#include "task_recipe_attribute.h"
+#include "spsc_queue.h"
+
+/********************** macros and definitions *******************************/
+#define EVENT_UNDEFINED	(255)
+#define MAX_EVENTS		(4)
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+
+/********************** internal data definition *****************************/
+SPSC_QUEUE_DEFINE(queue_task_recipe, MAX_EVENTS);
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+void init_queue_event_task_recipe(void)
+{
+	spsc_queue_init(&queue_task_recipe);
+}
+
+void put_event_task_recipe(task_recipe_ev_t event)
+{
+	spsc_queue_put(&queue_task_recipe, (uint8_t)event);
+}
+
+task_recipe_ev_t get_event_task_recipe(void)
+{
+	uint8_t event = EVENT_UNDEFINED;
+
+	spsc_queue_get(&queue_task_recipe, &event);
+
+	return (task_recipe_ev_t)event;
+}
+
+bool any_event_task_recipe(void)
+{
+  return spsc_queue_any(&queue_task_recipe);
+}
+
+/********************** end of file ******************************************/
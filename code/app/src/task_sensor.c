@@ -47,47 +47,61 @@
 /* Application & Tasks includes. */
 #include "board.h"
 #include "app.h"
-#include "task_sensor_attribute.h"
 #include "task_system_attribute.h"
+#include "task_sensor_attribute.h"
 #include "task_system_interface.h"
 
 /********************** macros and definitions *******************************/
 #define G_TASK_SEN_CNT_INIT			0ul
-#define G_TASK_SEN_TICK_CNT_INI		0ul
 
 #define DEL_BTN_XX_MIN				0ul
 #define DEL_BTN_XX_MED				25ul
 #define DEL_BTN_XX_MAX				50ul
 
+/* Mantener apretado repite el evento a período fijo: arranca a un paso por
+ * evento y pasa a eventos de 5 y 10 pasos */
+#define DEL_BTN_REPEAT_DELAY		500ul
+#define DEL_BTN_REPEAT_PERIOD		200ul
+#define DEL_BTN_REPEAT_NONE			0ul
+
 /********************** internal data declaration ****************************/
 const task_sensor_cfg_t task_sensor_cfg_list[] = {
     {ID_BTN_A,  BTN_ENT_PORT,  BTN_ENT_PIN,  BTN_ENT_PRESSED, DEL_BTN_XX_MAX,
-     EV_SYS_ENT_IDLE,  EV_SYS_ENT_ACTIVE},
+     EV_SYS_ENT_IDLE,  EV_SYS_ENT_ACTIVE,  DEL_BTN_REPEAT_NONE, DEL_BTN_REPEAT_NONE,
+     {EV_SYS_ENT_ACTIVE, EV_SYS_ENT_ACTIVE, EV_SYS_ENT_ACTIVE}},
     {ID_BTN_B,  BTN_PRE_PORT,  BTN_PRE_PIN,  BTN_PRE_PRESSED, DEL_BTN_XX_MAX,
-     EV_SYS_PRE_IDLE,  EV_SYS_PRE_ACTIVE},
+     EV_SYS_PRE_IDLE,  EV_SYS_PRE_ACTIVE,  DEL_BTN_REPEAT_DELAY, DEL_BTN_REPEAT_PERIOD,
+     {EV_SYS_PRE_ACTIVE, EV_SYS_PRE_ACTIVE_X5, EV_SYS_PRE_ACTIVE_X10}},
 	{ID_BTN_C,  BTN_NEX_PORT,  BTN_NEX_PIN,  BTN_NEX_PRESSED, DEL_BTN_XX_MAX,
-	 EV_SYS_NEX_IDLE,  EV_SYS_NEX_ACTIVE},
+	 EV_SYS_NEX_IDLE,  EV_SYS_NEX_ACTIVE,  DEL_BTN_REPEAT_DELAY, DEL_BTN_REPEAT_PERIOD,
+	 {EV_SYS_NEX_ACTIVE, EV_SYS_NEX_ACTIVE_X5, EV_SYS_NEX_ACTIVE_X10}},
 	{ID_BTN_D,  BTN_ESC_PORT,  BTN_ESC_PIN,  BTN_ESC_PRESSED, DEL_BTN_XX_MAX,
-	 EV_SYS_ESC_IDLE,  EV_SYS_ESC_ACTIVE},
+	 EV_SYS_ESC_IDLE,  EV_SYS_ESC_ACTIVE,  DEL_BTN_REPEAT_NONE, DEL_BTN_REPEAT_NONE,
+	 {EV_SYS_ESC_ACTIVE, EV_SYS_ESC_ACTIVE, EV_SYS_ESC_ACTIVE}},
 	{ID_BTN_E,  SW_ENABLE_PORT,  SW_ENABLE_PIN,  SW_ENABLE_ON, DEL_BTN_XX_MAX,
-	 EV_SYS_ENABLE_IDLE,  EV_SYS_ENABLE_ACTIVE},
+	 EV_SYS_ENABLE_IDLE,  EV_SYS_ENABLE_ACTIVE,  DEL_BTN_REPEAT_NONE, DEL_BTN_REPEAT_NONE,
+	 {EV_SYS_ENABLE_ACTIVE, EV_SYS_ENABLE_ACTIVE, EV_SYS_ENABLE_ACTIVE}},
 };
 
 #define SENSOR_CFG_QTY	(sizeof(task_sensor_cfg_list)/sizeof(task_sensor_cfg_t))
 
 task_sensor_dta_t task_sensor_dta_list[] = {
-	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP},
-	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP},
-	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP},
-	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP},
-	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP},
+	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP, 0},
+	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP, 0},
+	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP, 0},
+	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP, 0},
+	{DEL_BTN_XX_MIN, ST_BTN_XX_UP, EV_BTN_XX_UP, 0},
 };
 
+/* Hasta qué repetición dura cada nivel de signal_repeat, el último no termina */
+static const uint32_t sensor_repeat_until_list[SENSOR_REPEAT_LEVEL_QTY] = {5ul, 30ul, 0ul};
+
 #define SENSOR_DTA_QTY	(sizeof(task_sensor_dta_list)/sizeof(task_sensor_dta_t))
 
 /********************** internal functions declaration ***********************/
 
 void task_sensor_statechart();
+static uint32_t sensor_repeat_level(const task_sensor_dta_t *p_task_sensor_dta);
 
 /********************** internal data definition *****************************/
 const char *p_task_sensor 		= "Task Sensor (Sensor Statechart)";
@@ -95,7 +109,6 @@ const char *p_task_sensor_ 		= "Non-Blocking & Update By Time Code";
 
 /********************** external data declaration ****************************/
 uint32_t g_task_sensor_cnt;
-volatile uint32_t g_task_sensor_tick_cnt;
 
 /********************** external functions definition ************************/
 void task_sensor_init(void *parameters)
@@ -112,7 +125,7 @@ void task_sensor_init(void *parameters)
 	g_task_sensor_cnt = G_TASK_SEN_CNT_INIT;
 
 	/* Print out: Task execution counter */
-	LOGGER_LOG("   %s = %lu\r\n", GET_NAME(g_task_sensor_cnt), g_task_sensor_cnt);
+	LOGGER_LOG("   %s = %" PRIu32 "\r\n", GET_NAME(g_task_sensor_cnt), g_task_sensor_cnt);
 
 	for (index = 0; SENSOR_DTA_QTY > index; index++)
 	{
@@ -120,51 +133,23 @@ void task_sensor_init(void *parameters)
 		p_task_sensor_dta = &task_sensor_dta_list[index];
 
 		/* Print out: Index & Task execution FSM */
-		LOGGER_LOG("   %s = %lu", GET_NAME(index), index);
+		LOGGER_LOG("   %s = %" PRIu32, GET_NAME(index), index);
 
 		state = p_task_sensor_dta->state;
-		LOGGER_LOG("   %s = %lu", GET_NAME(state), (uint32_t)state);
+		LOGGER_LOG("   %s = %" PRIu32, GET_NAME(state), (uint32_t)state);
 
 		event = p_task_sensor_dta->event;
-		LOGGER_LOG("   %s = %lu\r\n", GET_NAME(event), (uint32_t)event);
+		LOGGER_LOG("   %s = %" PRIu32 "\r\n", GET_NAME(event), (uint32_t)event);
 	}
-	g_task_sensor_tick_cnt = G_TASK_SEN_TICK_CNT_INI;
 }
 
 
 void task_sensor_update(void *parameters)
 {
-	bool b_time_update_required = false;
-
 	/* Update Task Sensor Counter */
 	g_task_sensor_cnt++;
 
-	/* Protect shared resource (g_task_sensor_tick_cnt) */
-	__asm("CPSID i");	/* disable interrupts*/
-    if (G_TASK_SEN_TICK_CNT_INI < g_task_sensor_tick_cnt)
-    {
-    	g_task_sensor_tick_cnt--;
-    	b_time_update_required = true;
-    }
-    __asm("CPSIE i");	/* enable interrupts*/
-
-    while (b_time_update_required)
-    {
-		/* Protect shared resource (g_task_sensor_tick_cnt) */
-		__asm("CPSID i");	/* disable interrupts*/
-		if (G_TASK_SEN_TICK_CNT_INI < g_task_sensor_tick_cnt)
-		{
-			g_task_sensor_tick_cnt--;
-			b_time_update_required = true;
-		}
-		else
-		{
-			b_time_update_required = false;
-		}
-		__asm("CPSIE i");	/* enable interrupts*/
-
-		task_sensor_statechart();
-    }
+	task_sensor_statechart();
 }
 
 void task_sensor_statechart()
@@ -208,6 +193,8 @@ void task_sensor_statechart()
 				{
 					put_event_task_system(p_task_sensor_cfg->signal_down);
 					p_task_sensor_dta->state = ST_BTN_XX_DOWN;
+					p_task_sensor_dta->tick = p_task_sensor_cfg->repeat_delay;
+					p_task_sensor_dta->repeat_cnt = 0;
 				}
 			}
 			else if (EV_BTN_XX_UP == p_task_sensor_dta->event)
@@ -231,6 +218,20 @@ void task_sensor_statechart()
 				p_task_sensor_dta->state = ST_BTN_XX_RISING;
 				p_task_sensor_dta->tick = p_task_sensor_cfg->tick_max;
 			}
+			else if (DEL_BTN_REPEAT_NONE != p_task_sensor_cfg->repeat_delay)
+			{
+				if (p_task_sensor_dta->tick > 0)
+				{
+					p_task_sensor_dta->tick--;
+				}
+				else
+				{
+					put_event_task_system(p_task_sensor_cfg->signal_repeat[sensor_repeat_level(p_task_sensor_dta)]);
+					p_task_sensor_dta->repeat_cnt++;
+					// tick cuenta hasta 0 inclusive
+					p_task_sensor_dta->tick = p_task_sensor_cfg->repeat_period - 1;
+				}
+			}
 			break;
 
 		case ST_BTN_XX_RISING:
@@ -244,6 +245,8 @@ void task_sensor_statechart()
 				{
 					put_event_task_system(p_task_sensor_cfg->signal_down);
 					p_task_sensor_dta->state = ST_BTN_XX_DOWN;
+					p_task_sensor_dta->tick = p_task_sensor_cfg->repeat_delay;
+					p_task_sensor_dta->repeat_cnt = 0;
 				}
 			}
 			else if (EV_BTN_XX_UP == p_task_sensor_dta->event)
@@ -266,4 +269,19 @@ void task_sensor_statechart()
 	}
 }
 
+static uint32_t sensor_repeat_level(const task_sensor_dta_t *p_task_sensor_dta)
+{
+	uint32_t level;
+
+	for (level = 0; (SENSOR_REPEAT_LEVEL_QTY - 1) > level; level++)
+	{
+		if (p_task_sensor_dta->repeat_cnt < sensor_repeat_until_list[level])
+		{
+			break;
+		}
+	}
+
+	return level;
+}
+
 /********************** end of file ******************************************/
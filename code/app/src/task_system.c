@@ -47,14 +47,19 @@
 /* Application & Tasks includes. */
 #include "board.h"
 #include "app.h"
+#include "task_system.h"
 #include "task_system_attribute.h"
 #include "task_system_interface.h"
 #include "task_menu_interface.h"
 #include "task_menu_attribute.h"
 #include "task_actuator_attribute.h"
 #include "task_actuator_interface.h"
+#include "task_actuator.h"
+#include "task_adc.h"
 #include "task_temp_interface.h"
+#include "task_temp.h"
 #include "task_press_interface.h"
+#include "task_recipe.h"
 #include "task_display_interface.h"
 #include "utils.h"
 
@@ -62,25 +67,26 @@
 
 /********************** macros and definitions *******************************/
 #define G_TASK_SYS_CNT_INI			0ul
-#define G_TASK_SYS_TICK_CNT_INI		0ul
 
 #define DEL_SYS_XX_MIN				0ul
-#define DEL_SYS_XX_MED				50ul
-#define DEL_SYS_XX_MAX				500ul
+#define DEL_SYS_XX_MED				(50ul / TASK_SYSTEM_PERIOD)
+#define DEL_SYS_XX_MAX				(500ul / TASK_SYSTEM_PERIOD)
 
 /********************** internal data declaration ****************************/
 task_system_dta_t task_system_dta =
-	{DEL_SYS_XX_MIN, ST_SYS_MENU_MODE, EV_SYS_ENABLE_IDLE, false, false};
+	{DEL_SYS_XX_MIN, ST_SYS_MENU_MODE, EV_SYS_ENABLE_IDLE, false, false, false, 0, 0};
 
 #define SYSTEM_DTA_QTY	(sizeof(task_system_dta)/sizeof(task_system_dta_t))
 
 static char system_str[17];
+static char recipe_str[9];
 
 /********************** internal functions declaration ***********************/
 
 static bool is_menu_button_event(task_system_ev_t event);
 static task_menu_ev_t system_event_to_menu_event(task_system_ev_t system_ev);
 static void task_system_statechart(shared_data_type *p_shared_data);
+static void system_awd_update(task_system_dta_t *p_task_system_dta, const system_config_t *p_cfg);
 
 /********************** internal data definition *****************************/
 const char *p_task_system 		= "Task System (System Statechart)";
@@ -88,7 +94,6 @@ const char *p_task_system_ 		= "Non-Blocking & Update By Time Code";
 
 /********************** external data declaration ****************************/
 uint32_t g_task_system_cnt;
-volatile uint32_t g_task_system_tick_cnt;
 
 /********************** external functions definition ************************/
 void task_system_init(void *parameters)
@@ -105,7 +110,7 @@ void task_system_init(void *parameters)
 	g_task_system_cnt = G_TASK_SYS_CNT_INI;
 
 	/* Print out: Task execution counter */
-	LOGGER_LOG("   %s = %lu\r\n", GET_NAME(g_task_system_cnt), g_task_system_cnt);
+	LOGGER_LOG("   %s = %" PRIu32 "\r\n", GET_NAME(g_task_system_cnt), g_task_system_cnt);
 
 	init_queue_event_task_system();
 
@@ -114,50 +119,21 @@ void task_system_init(void *parameters)
 
 	/* Print out: Task execution FSM */
 	state = p_task_system_dta->state;
-	LOGGER_LOG("   %s = %lu", GET_NAME(state), (uint32_t)state);
+	LOGGER_LOG("   %s = %" PRIu32, GET_NAME(state), (uint32_t)state);
 
 	event = p_task_system_dta->event;
-	LOGGER_LOG("   %s = %lu", GET_NAME(event), (uint32_t)event);
+	LOGGER_LOG("   %s = %" PRIu32, GET_NAME(event), (uint32_t)event);
 
 	b_event = p_task_system_dta->flag;
 	LOGGER_LOG("   %s = %s\r\n", GET_NAME(b_event), (b_event ? "true" : "false"));
-
-	g_task_system_tick_cnt = G_TASK_SYS_TICK_CNT_INI;
 }
 
 void task_system_update(void *parameters)
 {
-	bool b_time_update_required = false;
-
 	/* Update Task System Counter */
 	g_task_system_cnt++;
 
-	/* Protect shared resource (g_task_system_tick) */
-	__asm("CPSID i");	/* disable interrupts*/
-    if (G_TASK_SYS_TICK_CNT_INI < g_task_system_tick_cnt)
-    {
-    	g_task_system_tick_cnt--;
-    	b_time_update_required = true;
-    }
-    __asm("CPSIE i");	/* enable interrupts*/
-
-    while (b_time_update_required)
-    {
-		/* Protect shared resource (g_task_system_tick) */
-		__asm("CPSID i");	/* disable interrupts*/
-		if (G_TASK_SYS_TICK_CNT_INI < g_task_system_tick_cnt)
-		{
-			g_task_system_tick_cnt--;
-			b_time_update_required = true;
-		}
-		else
-		{
-			b_time_update_required = false;
-		}
-		__asm("CPSIE i");	/* enable interrupts*/
-
-		task_system_statechart((shared_data_type *)parameters);
-	}
+	task_system_statechart((shared_data_type *)parameters);
 }
 
 static void task_system_statechart(shared_data_type *p_shared_data) {
@@ -165,9 +141,17 @@ static void task_system_statechart(shared_data_type *p_shared_data) {
 
 	bool b_display_update_required = false;
 
-	uint32_t temp = temp_raw_to_celsius(p_shared_data->temp_raw);
-	uint32_t press = press_raw_to_kPa(p_shared_data->pressure_raw);
+	sensor_frame_t frame;
+	system_config_t cfg;
+	uint32_t temp;
+	uint32_t press;
 	bool b_is_alarm_set = false;
+	recipe_status_t recipe_status;
+
+	snapshot_read(&p_shared_data->sensor, &frame);
+	snapshot_read(&p_shared_data->cfg, &cfg);
+	temp = frame.temp;
+	press = frame.press;
 
 	/* Update Task System Data Pointer */
 	p_task_system_dta = &task_system_dta;
@@ -188,10 +172,24 @@ static void task_system_statechart(shared_data_type *p_shared_data) {
 		p_task_system_dta->event = get_event_task_system();
 	}
 
+	system_awd_update(p_task_system_dta, &cfg);
+
 	switch (p_task_system_dta->state)
 	{
 	case ST_SYS_MENU_MODE:
 		if ((true == p_task_system_dta->flag)
+				&& (EV_SYS_ALARM_TRIP == p_task_system_dta->event))
+		{
+			/* El watchdog sigue armado con el menú abierto: el disparo se
+			 * atiende igual que en modo normal y además cierra el menú */
+			p_task_system_dta->flag = false;
+			p_task_system_dta->state = ST_SYS_ALARM_MODE;
+			put_event_task_temp(EV_TEMP_ENABLE_OFF);
+			put_event_task_press(EV_PRESS_ENABLE_OFF);
+			put_event_task_actuator(EV_ACT_XX_BLINK, ID_ACT_BUZZER);
+			put_event_task_menu(EV_MEN_ALARM_EXIT);
+		}
+		else if ((true == p_task_system_dta->flag)
 				&& is_menu_button_event(p_task_system_dta->event))
 		{
 			p_task_system_dta->flag = false;
@@ -201,14 +199,20 @@ static void task_system_statechart(shared_data_type *p_shared_data) {
 		else if ((true == p_task_system_dta->flag)
 				&& (EV_SYS_ENABLE_ACTIVE == p_task_system_dta->event))
 		{
+			/* Los controles siguen la llave también con el menú abierto, así
+			 * enabled dice si puede haber salidas encendidas */
 			p_task_system_dta->flag = false;
 			p_task_system_dta->enabled = true;
+			put_event_task_temp(EV_TEMP_ENABLE_ON);
+			put_event_task_press(EV_PRESS_ENABLE_ON);
 		}
 		else if ((true == p_task_system_dta->flag)
 				&& (EV_SYS_ENABLE_IDLE == p_task_system_dta->event))
 		{
 			p_task_system_dta->flag = false;
 			p_task_system_dta->enabled = false;
+			put_event_task_temp(EV_TEMP_ENABLE_OFF);
+			put_event_task_press(EV_PRESS_ENABLE_OFF);
 		}
 		else if ((true == p_task_system_dta->flag)
 				&& (EV_SYS_EXIT_MENU == p_task_system_dta->event))
@@ -229,28 +233,53 @@ static void task_system_statechart(shared_data_type *p_shared_data) {
 			put_cmd_task_display(CMD_DISP_WRITE_STR, system_str);
 			put_cmd_task_display(CMD_DISP_TO_LINE_1, NULL);
 			put_cmd_task_display(CMD_DISP_WRITE_STR, "Estado: ");
-			put_cmd_task_display(CMD_DISP_WRITE_STR,
-					(p_task_system_dta->enabled) ? "on      " : "off     ");
+			task_recipe_get_status(&recipe_status);
+			if (task_temp_autotune_running())
+				put_cmd_task_display(CMD_DISP_WRITE_STR, "autoajus");
+			else if (recipe_status.paused)
+				put_cmd_task_display(CMD_DISP_WRITE_STR, "pausa   ");
+			else if (recipe_status.running)
+			{
+				// Segmento en curso sobre el total de la receta. Son de un
+				// dígito (RECIPE_SEGMENT_MAX), la línea queda en 16 columnas
+				snprintf(recipe_str, sizeof(recipe_str), "rec %c/%c ",
+						 '1' + recipe_status.segment, '0' + recipe_status.segment_qty);
+				put_cmd_task_display(CMD_DISP_WRITE_STR, recipe_str);
+			}
+			else
+				put_cmd_task_display(CMD_DISP_WRITE_STR,
+						(p_task_system_dta->enabled) ? "on      " : "off     ");
 		}
 
-		if (p_task_system_dta->enabled && p_shared_data->cfg.alarm_enabled)
+		if (p_task_system_dta->enabled && cfg.alarm_enabled)
 		{
-			if (p_shared_data->cfg.temp_alarm_limit
-					> p_shared_data->cfg.temp_setpoint)
-				b_is_alarm_set |= (temp > p_shared_data->cfg.temp_alarm_limit);
+			if (cfg.temp_alarm_limit
+					> cfg.temp_setpoint)
+				b_is_alarm_set |= (temp > cfg.temp_alarm_limit);
 			else
-				b_is_alarm_set |= (temp < p_shared_data->cfg.temp_alarm_limit);
+				b_is_alarm_set |= (temp < cfg.temp_alarm_limit);
 
-			if (p_shared_data->cfg.press_alarm_limit
-					> p_shared_data->cfg.press_setpoint)
+			if (cfg.press_alarm_limit
+					> cfg.press_setpoint)
 				b_is_alarm_set |=
-						(press > p_shared_data->cfg.press_alarm_limit);
+						(press > cfg.press_alarm_limit);
 			else
 				b_is_alarm_set |=
-						(press < p_shared_data->cfg.press_alarm_limit);
+						(press < cfg.press_alarm_limit);
 		}
 
-		if (b_is_alarm_set)
+		if ((true == p_task_system_dta->flag)
+				&& (EV_SYS_ALARM_TRIP == p_task_system_dta->event))
+		{
+			/* Disparo por hardware: las salidas ya se apagaron en la ISR,
+			 * se detienen los controles para que no vuelvan a encenderlas */
+			p_task_system_dta->flag = false;
+			p_task_system_dta->state = ST_SYS_ALARM_MODE;
+			put_event_task_temp(EV_TEMP_ENABLE_OFF);
+			put_event_task_press(EV_PRESS_ENABLE_OFF);
+			put_event_task_actuator(EV_ACT_XX_BLINK, ID_ACT_BUZZER);
+		}
+		else if (b_is_alarm_set)
 		{
 			p_task_system_dta->state = ST_SYS_ALARM_MODE;
 			put_event_task_actuator(EV_ACT_XX_BLINK, ID_ACT_BUZZER);
@@ -299,6 +328,7 @@ static void task_system_statechart(shared_data_type *p_shared_data) {
 			put_event_task_temp(EV_TEMP_ENABLE_OFF);
 			put_event_task_press(EV_PRESS_ENABLE_OFF);
 			put_event_task_actuator(EV_ACT_XX_NOT_BLINK, ID_ACT_BUZZER);
+			task_actuator_release_safe();
 		}
 		break;
 
@@ -307,6 +337,65 @@ static void task_system_statechart(shared_data_type *p_shared_data) {
 	}
 }
 
+// La llave de habilitación, también con el menú abierto o en alarma
+bool task_system_is_enabled(void)
+{
+	return task_system_dta.enabled;
+}
+
+/* Solo hay un watchdog analógico, vigila la temperatura. La presión queda
+ * con la comparación por software del statechart.
+ * Queda armado en todos los modos mientras pueda haber salidas encendidas:
+ * habilitado, con alarma y sin el estado seguro trabado por un disparo. Se
+ * vuelve a armar solo si el menú confirma otra ventana. */
+static void system_awd_update(task_system_dta_t *p_task_system_dta, const system_config_t *p_cfg)
+{
+	uint16_t limit_raw;
+	uint16_t low_raw;
+	uint16_t high_raw;
+
+	if (p_task_system_dta->enabled && p_cfg->alarm_enabled
+			&& (false == task_actuator_is_safe()))
+	{
+		limit_raw = temp_deci_celsius_to_adc(p_cfg->temp_alarm_limit);
+		if (p_cfg->temp_alarm_limit > p_cfg->temp_setpoint)
+		{
+			low_raw = 0;
+			high_raw = limit_raw;
+		}
+		else
+		{
+			low_raw = limit_raw;
+			high_raw = ADC_RAW_MAX_VALUE;
+		}
+
+		if ((false == p_task_system_dta->awd_armed)
+				|| (low_raw != p_task_system_dta->awd_low)
+				|| (high_raw != p_task_system_dta->awd_high))
+		{
+			task_adc_temp_watchdog_arm(low_raw, high_raw);
+			p_task_system_dta->awd_armed = true;
+			p_task_system_dta->awd_low = low_raw;
+			p_task_system_dta->awd_high = high_raw;
+		}
+	}
+	else if (true == p_task_system_dta->awd_armed)
+	{
+		task_adc_temp_watchdog_disarm();
+		p_task_system_dta->awd_armed = false;
+	}
+}
+
+/* Corre en el contexto de la interrupción del ADC */
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc)
+{
+	/* Un solo disparo, el statechart lo vuelve a armar */
+	__HAL_ADC_DISABLE_IT(hadc, ADC_IT_AWD);
+
+	task_actuator_force_safe();
+	put_event_task_system_isr(EV_SYS_ALARM_TRIP);
+}
+
 static bool is_menu_button_event(task_system_ev_t event)
 {
 	switch (event)
@@ -319,6 +408,10 @@ static bool is_menu_button_event(task_system_ev_t event)
 	case EV_SYS_PRE_ACTIVE:
 	case EV_SYS_ESC_IDLE:
 	case EV_SYS_ESC_ACTIVE:
+	case EV_SYS_NEX_ACTIVE_X5:
+	case EV_SYS_NEX_ACTIVE_X10:
+	case EV_SYS_PRE_ACTIVE_X5:
+	case EV_SYS_PRE_ACTIVE_X10:
 		return true;
 	default:
 		return false;
@@ -354,6 +447,18 @@ static task_menu_ev_t system_event_to_menu_event(task_system_ev_t system_ev)
 	case EV_SYS_ESC_ACTIVE:
 		menu_ev = EV_MEN_ESC_ACTIVE;
 		break;
+	case EV_SYS_NEX_ACTIVE_X5:
+		menu_ev = EV_MEN_NEX_ACTIVE_X5;
+		break;
+	case EV_SYS_NEX_ACTIVE_X10:
+		menu_ev = EV_MEN_NEX_ACTIVE_X10;
+		break;
+	case EV_SYS_PRE_ACTIVE_X5:
+		menu_ev = EV_MEN_PRE_ACTIVE_X5;
+		break;
+	case EV_SYS_PRE_ACTIVE_X10:
+		menu_ev = EV_MEN_PRE_ACTIVE_X10;
+		break;
 	default:
 		// No debería ocurrir
 		__builtin_unreachable();
@@ -48,66 +48,59 @@
 #include "board.h"
 #include "app.h"
 #include "task_system_attribute.h"
+#include "spsc_queue.h"
 
 /********************** macros and definitions *******************************/
 #define EVENT_UNDEFINED	(255)
 #define MAX_EVENTS		(16)
+#define MAX_ISR_EVENTS	(4)
 
 /********************** internal data declaration ****************************/
 
 /********************** internal functions declaration ***********************/
 
 /********************** internal data definition *****************************/
-struct
-{
-	uint32_t	head;
-	uint32_t	tail;
-	uint32_t	count;
-	task_system_ev_t	queue[MAX_EVENTS];
-} queue_task_a;
+SPSC_QUEUE_DEFINE(queue_task_system, MAX_EVENTS);
+
+// Las ISRs tienen su propia cola, así cada cola sigue teniendo un único productor
+SPSC_QUEUE_DEFINE(queue_task_system_isr, MAX_ISR_EVENTS);
 
 /********************** external data declaration ****************************/
 
 /********************** external functions definition ************************/
 void init_queue_event_task_system(void)
 {
-	uint32_t i;
-
-	queue_task_a.head = 0;
-	queue_task_a.tail = 0;
-	queue_task_a.count = 0;
-
-	for (i = 0; i < MAX_EVENTS; i++)
-		queue_task_a.queue[i] = EVENT_UNDEFINED;
+	spsc_queue_init(&queue_task_system);
+	spsc_queue_init(&queue_task_system_isr);
 }
 
 void put_event_task_system(task_system_ev_t event)
 {
-	queue_task_a.count++;
-	queue_task_a.queue[queue_task_a.head++] = event;
+	spsc_queue_put(&queue_task_system, (uint8_t)event);
+}
 
-	if (MAX_EVENTS == queue_task_a.head)
-		queue_task_a.head = 0;
+// Solo para usar desde interrupciones
+void put_event_task_system_isr(task_system_ev_t event)
+{
+	spsc_queue_put(&queue_task_system_isr, (uint8_t)event);
 }
 
 task_system_ev_t get_event_task_system(void)
-
 {
-	task_system_ev_t event;
-
-	queue_task_a.count--;
-	event = queue_task_a.queue[queue_task_a.tail];
-	queue_task_a.queue[queue_task_a.tail++] = EVENT_UNDEFINED;
+	uint8_t event = EVENT_UNDEFINED;
 
-	if (MAX_EVENTS == queue_task_a.tail)
-		queue_task_a.tail = 0;
+	// Los eventos de las ISRs (alarmas) se atienden primero
+	if (false == spsc_queue_get(&queue_task_system_isr, &event))
+	{
+		spsc_queue_get(&queue_task_system, &event);
+	}
 
-	return event;
+	return (task_system_ev_t)event;
 }
 
 bool any_event_task_system(void)
 {
-  return (queue_task_a.head != queue_task_a.tail);
+  return spsc_queue_any(&queue_task_system_isr) || spsc_queue_any(&queue_task_system);
 }
 
 /********************** end of file ******************************************/
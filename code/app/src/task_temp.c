@@ -16,26 +16,43 @@
 /* Application & Tasks includes. */
 #include "board.h"
 #include "app.h"
+#include "task_temp.h"
 #include "task_temp_attribute.h"
 #include "task_temp_interface.h"
 #include "task_actuator_attribute.h"
 #include "task_actuator_interface.h"
+#include "task_actuator.h"
 #include "utils.h"
+#include "pwm.h"
+#include "task_menu_attribute.h"
+#include "task_menu_interface.h"
 
 #include <stdbool.h>
 
 /********************** macros and definitions *******************************/
 #define G_TASK_TEMP_CNT_INI			0ul
-#define G_TASK_TEMP_TICK_CNT_INI	0ul
+
+/* Ensayo de relé: el calefactor va al 100 % debajo de setpoint - banda y se
+ * apaga arriba de setpoint + banda. La amplitud de la salida es la mitad
+ * del recorrido del PWM. */
+#define AUTOTUNE_BAND				5ul					// 0.5 celsius
+#define AUTOTUNE_RELAY_AMPLITUDE	(PWM_DUTY_MAX / 2)	// [0.1 %]
+#define AUTOTUNE_CYCLES				4ul					// El primero se descarta
+#define AUTOTUNE_TIMEOUT			(2ul * 60ul * 60ul * 1000ul)	// 2 h [ms]
+
+#define PI_X1000					3142ul
 
 
 /********************** internal data declaration ****************************/
 task_temp_dta_t task_temp_dta =
-	{ST_TEMP_OFF, EV_TEMP_ENABLE_OFF, false};
+	{ST_TEMP_OFF, EV_TEMP_ENABLE_OFF, false, {0}, {0}};
 
 #define TEMP_DTA_QTY	(sizeof(task_temp_dta)/sizeof(task_temp_dta_t))
 
 /********************** internal functions declaration ***********************/
+static void temp_autotune_start(task_temp_dta_t *p_task_temp_dta, uint32_t temp, uint32_t setpoint, uint32_t now);
+static bool temp_autotune_step(task_temp_dta_t *p_task_temp_dta, uint32_t temp, uint32_t setpoint, uint32_t now);
+static void temp_autotune_finish(task_temp_dta_t *p_task_temp_dta, uint32_t hysteresis);
 
 /********************** internal data definition *****************************/
 const char *p_task_temp 		= "Task Temp (Temperature control)";
@@ -43,7 +60,6 @@ const char *p_task_temp_ 		= "Non-Blocking & Update By Time Code";
 
 /********************** external data declaration ****************************/
 uint32_t g_task_temp_cnt;
-volatile uint32_t g_task_temp_tick_cnt;
 
 /********************** external functions definition ************************/
 void task_temp_init(void *parameters)
@@ -60,7 +76,7 @@ void task_temp_init(void *parameters)
 	g_task_temp_cnt = G_TASK_TEMP_CNT_INI;
 
 	/* Print out: Task execution counter */
-	LOGGER_LOG("   %s = %lu\r\n", GET_NAME(g_task_temp_cnt), g_task_temp_cnt);
+	LOGGER_LOG("   %s = %" PRIu32 "\r\n", GET_NAME(g_task_temp_cnt), g_task_temp_cnt);
 
 	init_queue_event_task_temp();
 
@@ -69,15 +85,13 @@ void task_temp_init(void *parameters)
 
 	/* Print out: Task execution FSM */
 	state = p_task_temp_dta->state;
-	LOGGER_LOG("   %s = %lu", GET_NAME(state), (uint32_t)state);
+	LOGGER_LOG("   %s = %" PRIu32, GET_NAME(state), (uint32_t)state);
 
 	event = p_task_temp_dta->event;
-	LOGGER_LOG("   %s = %lu", GET_NAME(event), (uint32_t)event);
+	LOGGER_LOG("   %s = %" PRIu32, GET_NAME(event), (uint32_t)event);
 
 	b_event = p_task_temp_dta->flag;
 	LOGGER_LOG("   %s = %s\r\n", GET_NAME(b_event), (b_event ? "true" : "false"));
-
-	g_task_temp_tick_cnt = G_TASK_TEMP_TICK_CNT_INI;
 }
 
 void task_temp_update(void *parameters)
@@ -85,107 +99,297 @@ void task_temp_update(void *parameters)
 	shared_data_type *shared_data = (shared_data_type*)parameters;
 
 	task_temp_dta_t *p_task_temp_dta;
-	bool b_time_update_required = false;
 
-	uint32_t temp = temp_raw_to_celsius(shared_data->temp_raw);
+	sensor_frame_t frame;
+	system_config_t cfg;
+	setpoint_frame_t setpoint;
+	uint32_t temp;
+
+	/* Medición y configuración consistentes para toda la ejecución */
+	snapshot_read(&shared_data->sensor, &frame);
+	snapshot_read(&shared_data->cfg, &cfg);
+	snapshot_read(&shared_data->setpoint, &setpoint);
+	temp = frame.temp;
+
+	/* Con una receta en curso manda su setpoint */
+	if (setpoint.active)
+	{
+		cfg.temp_setpoint = setpoint.temp;
+	}
 
 	/* Update Task System Counter */
 	g_task_temp_cnt++;
 
-	/* Protect shared resource (g_task_temp_tick) */
-	__asm("CPSID i");	/* disable interrupts*/
-    if (G_TASK_TEMP_TICK_CNT_INI < g_task_temp_tick_cnt)
-    {
-    	g_task_temp_tick_cnt--;
-    	b_time_update_required = true;
-    }
-    __asm("CPSIE i");	/* enable interrupts*/
+	/* Update Task System Data Pointer */
+	p_task_temp_dta = &task_temp_dta;
+
+	if (true == any_event_task_temp())
+	{
+		p_task_temp_dta->flag = true;
+		p_task_temp_dta->event = get_event_task_temp();
+	}
+
+	task_temp_statechart(p_task_temp_dta, &cfg, temp, g_app_tick);
+
+	shared_data->pwm_active = (uint16_t)pwm_get_duty(PWM_ID_HEATER);
+}
+
+// Todo el estado está en la instancia: el firmware usa task_temp_dta y el
+// barrido de sim/ corre una por simulación
+void task_temp_statechart(task_temp_dta_t *p_task_temp_dta, const system_config_t *p_cfg,
+						  uint32_t temp, uint32_t now)
+{
+	pid_cfg_t pid_cfg;
+
+	switch (p_task_temp_dta->state)
+	{
+	case ST_TEMP_OFF:
+		if ((true == p_task_temp_dta->flag) && (EV_TEMP_ENABLE_ON == p_task_temp_dta->event))
+		{
+			p_task_temp_dta->flag = false;
+			p_task_temp_dta->state = ST_TEMP_IDLE;
+		}
+		break;
+
+	case ST_TEMP_IDLE:
+		if ((true == p_task_temp_dta->flag) && (EV_TEMP_ENABLE_OFF == p_task_temp_dta->event))
+		{
+			p_task_temp_dta->flag = false;
+			p_task_temp_dta->state = ST_TEMP_OFF;
+		}
+		else if ((true == p_task_temp_dta->flag) && (EV_TEMP_AUTOTUNE == p_task_temp_dta->event))
+		{
+			p_task_temp_dta->flag = false;
+			temp_autotune_start(p_task_temp_dta, temp, p_cfg->temp_setpoint, now);
+		}
+		else if (CTRL_MODE_PID == p_cfg->temp_mode)
+		{
+			p_task_temp_dta->state = ST_TEMP_PID;
+			pid_reset(&p_task_temp_dta->pid);
+		}
+		// Equivalente a (temp < setpoint - hist) pero evita underflow si (hist > setpoint)
+		else if (temp + p_cfg->temp_hysteresis < p_cfg->temp_setpoint)
+		{
+			p_task_temp_dta->state = ST_TEMP_HEATING;
+			put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_HEATER);
+		}
+		else if (temp > p_cfg->temp_setpoint + p_cfg->temp_hysteresis)
+		{
+			p_task_temp_dta->state = ST_TEMP_COOLING;
+			put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_COOLER);
+		}
+		break;
+
+	case ST_TEMP_HEATING:
+		if ((true == p_task_temp_dta->flag) && (EV_TEMP_ENABLE_OFF == p_task_temp_dta->event))
+		{
+			p_task_temp_dta->flag = false;
+			p_task_temp_dta->state = ST_TEMP_OFF;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
+		}
+		else if ((true == p_task_temp_dta->flag) && (EV_TEMP_AUTOTUNE == p_task_temp_dta->event))
+		{
+			p_task_temp_dta->flag = false;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
+			temp_autotune_start(p_task_temp_dta, temp, p_cfg->temp_setpoint, now);
+		}
+		else if (temp > p_cfg->temp_setpoint)
+		{
+			p_task_temp_dta->state = ST_TEMP_IDLE;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
+		}
+		break;
+
+	case ST_TEMP_COOLING:
+		if ((true == p_task_temp_dta->flag) && (EV_TEMP_ENABLE_OFF == p_task_temp_dta->event))
+		{
+			p_task_temp_dta->flag = false;
+			p_task_temp_dta->state = ST_TEMP_OFF;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_COOLER);
+		}
+		else if ((true == p_task_temp_dta->flag) && (EV_TEMP_AUTOTUNE == p_task_temp_dta->event))
+		{
+			p_task_temp_dta->flag = false;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_COOLER);
+			temp_autotune_start(p_task_temp_dta, temp, p_cfg->temp_setpoint, now);
+		}
+		else if (temp < p_cfg->temp_setpoint)
+		{
+			p_task_temp_dta->state = ST_TEMP_IDLE;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_COOLER);
+		}
+		break;
 
-    while (b_time_update_required)
-    {
-		/* Protect shared resource (g_task_temp_tick) */
-		__asm("CPSID i");	/* disable interrupts*/
-		if (G_TASK_TEMP_TICK_CNT_INI < g_task_temp_tick_cnt)
+	case ST_TEMP_PID:
+		if ((true == p_task_temp_dta->flag) && (EV_TEMP_ENABLE_OFF == p_task_temp_dta->event))
+		{
+			p_task_temp_dta->flag = false;
+			p_task_temp_dta->state = ST_TEMP_OFF;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
+		}
+		else if (CTRL_MODE_PID != p_cfg->temp_mode)
 		{
-			g_task_temp_tick_cnt--;
-			b_time_update_required = true;
+			p_task_temp_dta->state = ST_TEMP_IDLE;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
+		}
+		// El actuador ya apagó y trabó el calefactor: el PID no integra y
+		// arranca de cero cuando se libera el estado seguro
+		else if (true == task_actuator_is_safe())
+		{
+			pid_reset(&p_task_temp_dta->pid);
+		}
+		else if ((true == p_task_temp_dta->flag) && (EV_TEMP_AUTOTUNE == p_task_temp_dta->event))
+		{
+			p_task_temp_dta->flag = false;
+			temp_autotune_start(p_task_temp_dta, temp, p_cfg->temp_setpoint, now);
+		}
+		// El PID solo calienta, el enfriador sigue con la histéresis
+		else if (temp > p_cfg->temp_setpoint + p_cfg->temp_hysteresis)
+		{
+			p_task_temp_dta->state = ST_TEMP_COOLING;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
+			put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_COOLER);
 		}
 		else
 		{
-			b_time_update_required = false;
-		}
-		__asm("CPSIE i");	/* enable interrupts*/
-
-    	/* Update Task System Data Pointer */
-		p_task_temp_dta = &task_temp_dta;
-
-		if (true == any_event_task_temp())
-		{
-			p_task_temp_dta->flag = true;
-			p_task_temp_dta->event = get_event_task_temp();
-		}
-
-		switch (p_task_temp_dta->state)
-		{
-		case ST_TEMP_OFF:
-			if ((true == p_task_temp_dta->flag) && (EV_TEMP_ENABLE_ON == p_task_temp_dta->event))
-			{
-				p_task_temp_dta->flag = false;
-				p_task_temp_dta->state = ST_TEMP_IDLE;
-			}
-			break;
-
-		case ST_TEMP_IDLE:
-			if ((true == p_task_temp_dta->flag) && (EV_TEMP_ENABLE_OFF == p_task_temp_dta->event))
-			{
-				p_task_temp_dta->flag = false;
-				p_task_temp_dta->state = ST_TEMP_OFF;
-			}
-			// Equivalente a (temp < setpoint - hist) pero evita underflow si (hist > setpoint)
-			else if (temp + shared_data->cfg.temp_hysteresis < shared_data->cfg.temp_setpoint)
-			{
-				p_task_temp_dta->state = ST_TEMP_HEATING;
-				put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_HEATER);
-			}
-			else if (temp > shared_data->cfg.temp_setpoint + shared_data->cfg.temp_hysteresis)
-			{
-				p_task_temp_dta->state = ST_TEMP_COOLING;
-				put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_COOLER);
-			}
-			break;
-
-		case ST_TEMP_HEATING:
-			if ((true == p_task_temp_dta->flag) && (EV_TEMP_ENABLE_OFF == p_task_temp_dta->event))
-			{
-				p_task_temp_dta->flag = false;
-				p_task_temp_dta->state = ST_TEMP_OFF;
-				put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
-			}
-			else if (temp > shared_data->cfg.temp_setpoint)
-			{
-				p_task_temp_dta->state = ST_TEMP_IDLE;
-				put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
-			}
-			break;
-
-		case ST_TEMP_COOLING:
-			if ((true == p_task_temp_dta->flag) && (EV_TEMP_ENABLE_OFF == p_task_temp_dta->event))
-			{
-				p_task_temp_dta->flag = false;
-				p_task_temp_dta->state = ST_TEMP_OFF;
-				put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_COOLER);
-			}
-			else if (temp < shared_data->cfg.temp_setpoint)
-			{
-				p_task_temp_dta->state = ST_TEMP_IDLE;
-				put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_COOLER);
-			}
-			break;
-
-		default:
-			break;
+			pid_cfg.kp = p_cfg->temp_kp;
+			pid_cfg.ki = p_cfg->temp_ki;
+			pid_cfg.kd = p_cfg->temp_kd;
+			pid_cfg.dt_ms = TASK_TEMP_PERIOD;
+			pid_cfg.out_max = PWM_DUTY_MAX;
+			put_duty_task_actuator(pid_update(&p_task_temp_dta->pid, &pid_cfg,
+											  (int32_t)p_cfg->temp_setpoint, (int32_t)temp),
+								   ID_ACT_HEATER);
+		}
+		break;
+
+	case ST_TEMP_AUTOTUNE:
+		if ((true == p_task_temp_dta->flag) && (EV_TEMP_ENABLE_OFF == p_task_temp_dta->event))
+		{
+			p_task_temp_dta->flag = false;
+			p_task_temp_dta->state = ST_TEMP_OFF;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
+		}
+		// Una alarma o el tiempo máximo cancelan el ensayo sin tocar la configuración
+		else if ((true == task_actuator_is_safe())
+				|| ((now - p_task_temp_dta->autotune.start_tick) > AUTOTUNE_TIMEOUT))
+		{
+			p_task_temp_dta->state = ST_TEMP_IDLE;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
 		}
+		else if (true == temp_autotune_step(p_task_temp_dta, temp, p_cfg->temp_setpoint, now))
+		{
+			p_task_temp_dta->state = ST_TEMP_IDLE;
+			put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
+			temp_autotune_finish(p_task_temp_dta, p_cfg->temp_hysteresis);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+bool task_temp_autotune_running(void)
+{
+	return (ST_TEMP_AUTOTUNE == task_temp_dta.state);
+}
+
+const temp_autotune_result_t *task_temp_autotune_result(void)
+{
+	return &task_temp_dta.autotune.result;
+}
+
+static void temp_autotune_start(task_temp_dta_t *p_task_temp_dta, uint32_t temp, uint32_t setpoint, uint32_t now)
+{
+	task_temp_autotune_t *p_at = &p_task_temp_dta->autotune;
+
+	p_at->start_tick = now;
+	p_at->on_tick = now;
+	p_at->cycles = 0;
+	p_at->period_sum = 0;
+	p_at->amplitude_sum = 0;
+	p_at->max = temp;
+	p_at->min = temp;
+	p_at->relay_on = (temp < setpoint);
+
+	put_event_task_actuator(p_at->relay_on ? EV_ACT_XX_ON : EV_ACT_XX_OFF, ID_ACT_HEATER);
+	p_task_temp_dta->state = ST_TEMP_AUTOTUNE;
+}
+
+// Un ciclo va de un encendido del relé al siguiente: de ahí sale el período
+// y, con los extremos vistos en el medio, la amplitud. Devuelve true cuando
+// ya se midieron los ciclos pedidos.
+static bool temp_autotune_step(task_temp_dta_t *p_task_temp_dta, uint32_t temp, uint32_t setpoint, uint32_t now)
+{
+	task_temp_autotune_t *p_at = &p_task_temp_dta->autotune;
+
+	if (temp > p_at->max) p_at->max = temp;
+	if (temp < p_at->min) p_at->min = temp;
+
+	if ((true == p_at->relay_on) && (temp > setpoint + AUTOTUNE_BAND))
+	{
+		p_at->relay_on = false;
+		put_event_task_actuator(EV_ACT_XX_OFF, ID_ACT_HEATER);
+	}
+	else if ((false == p_at->relay_on) && (temp + AUTOTUNE_BAND < setpoint))
+	{
+		p_at->relay_on = true;
+		put_event_task_actuator(EV_ACT_XX_ON, ID_ACT_HEATER);
+
+		/* El primer ciclo arranca desde donde estaba la cámara, no cuenta */
+		if (0 < p_at->cycles)
+		{
+			p_at->period_sum += now - p_at->on_tick;
+			p_at->amplitude_sum += p_at->max - p_at->min;
+		}
+		p_at->cycles++;
+		p_at->on_tick = now;
+		p_at->max = temp;
+		p_at->min = temp;
+	}
+
+	return (AUTOTUNE_CYCLES < p_at->cycles);
+}
+
+// Ku = 4 d / (pi a) y Ziegler-Nichols: Kp = 0.6 Ku, Ti = Tu / 2, Td = Tu / 8.
+// Con d en 0.1 %, a (amplitud, media del pico a pico) en 0.1 °C y las
+// ganancias en décimas queda kp = 24 d / (pi a).
+static void temp_autotune_finish(task_temp_dta_t *p_task_temp_dta, uint32_t hysteresis)
+{
+	task_temp_autotune_t *p_at = &p_task_temp_dta->autotune;
+	temp_autotune_result_t *p_result = &p_at->result;
+	uint32_t measured = p_at->cycles - 1;
+	uint32_t tu_ms = p_at->period_sum / measured;
+	uint32_t amplitude = p_at->amplitude_sum / (2 * measured);
+	uint32_t kp;
+
+	if (0 == amplitude)
+	{
+		amplitude = 1;
+	}
+	if (0 == tu_ms)
+	{
+		tu_ms = 1;
+	}
+
+	kp = (24ul * AUTOTUNE_RELAY_AMPLITUDE * 1000ul) / (PI_X1000 * amplitude);
+	if (PID_GAIN_MAX < kp)
+	{
+		kp = PID_GAIN_MAX;
 	}
+	p_result->kp = kp;
+	p_result->ki = (2ul * kp * 1000ul) / tu_ms;
+	p_result->kd = (kp * (tu_ms / 8ul)) / 1000ul;
+	if (PID_GAIN_MAX < p_result->ki) p_result->ki = PID_GAIN_MAX;
+	if (PID_GAIN_MAX < p_result->kd) p_result->kd = PID_GAIN_MAX;
+
+	/* Lo que la temperatura pasa de la banda del relé es retardo de la
+	 * cámara: una histéresis más chica no achica el ripple y solo hace
+	 * conmutar más seguido al relé */
+	p_result->hysteresis = (amplitude > AUTOTUNE_BAND) ? (amplitude - AUTOTUNE_BAND) : hysteresis;
+
+	put_event_task_menu(EV_MEN_AUTOTUNE_DONE);
 }
 
 /********************** end of file ******************************************/
@@ -17,6 +17,7 @@
 #include "board.h"
 #include "app.h"
 #include "task_temp_attribute.h"
+#include "spsc_queue.h"
 
 /********************** macros and definitions *******************************/
 #define EVENT_UNDEFINED	(255)
@@ -27,56 +28,33 @@
 /********************** internal functions declaration ***********************/
 
 /********************** internal data definition *****************************/
-struct
-{
-	uint32_t	head;
-	uint32_t	tail;
-	uint32_t	count;
-	task_temp_ev_t	queue[MAX_EVENTS];
-} queue_task_temp;
+SPSC_QUEUE_DEFINE(queue_task_temp, MAX_EVENTS);
 
 /********************** external data declaration ****************************/
 
 /********************** external functions definition ************************/
 void init_queue_event_task_temp(void)
 {
-	uint32_t i;
-
-	queue_task_temp.head = 0;
-	queue_task_temp.tail = 0;
-	queue_task_temp.count = 0;
-
-	for (i = 0; i < MAX_EVENTS; i++)
-		queue_task_temp.queue[i] = EVENT_UNDEFINED;
+	spsc_queue_init(&queue_task_temp);
 }
 
 void put_event_task_temp(task_temp_ev_t event)
 {
-	queue_task_temp.count++;
-	queue_task_temp.queue[queue_task_temp.head++] = event;
-
-	if (MAX_EVENTS == queue_task_temp.head)
-		queue_task_temp.head = 0;
+	spsc_queue_put(&queue_task_temp, (uint8_t)event);
 }
 
 task_temp_ev_t get_event_task_temp(void)
-
 {
-	task_temp_ev_t event;
-
-	queue_task_temp.count--;
-	event = queue_task_temp.queue[queue_task_temp.tail];
-	queue_task_temp.queue[queue_task_temp.tail++] = EVENT_UNDEFINED;
+	uint8_t event = EVENT_UNDEFINED;
 
-	if (MAX_EVENTS == queue_task_temp.tail)
-		queue_task_temp.tail = 0;
+	spsc_queue_get(&queue_task_temp, &event);
 
-	return event;
+	return (task_temp_ev_t)event;
 }
 
 bool any_event_task_temp(void)
 {
-  return (queue_task_temp.head != queue_task_temp.tail);
+  return spsc_queue_any(&queue_task_temp);
 }
 
 /********************** end of file ******************************************/
@@ -17,6 +17,16 @@
 #define TEMP_SENSOR_MAX		100		// celsius
 #define PRESS_SENSOR_MAX	110		// kPa
 
+/* Factores de conversión en Q16: décimas de unidad por cuenta del ADC.
+ * Se calculan en compilación, así cada muestra se convierte con una
+ * multiplicación y un shift en lugar de una división. */
+#define CONV_Q16_SHIFT		16
+#define CONV_Q16_ROUND		(1ul << (CONV_Q16_SHIFT - 1))
+#define TEMP_DECI_PER_RAW_Q16	\
+	((((TEMP_SENSOR_MAX * 10ul) << CONV_Q16_SHIFT) + (ADC_MAX_VALUE / 2)) / ADC_MAX_VALUE)
+#define PRESS_DECI_PER_RAW_Q16	\
+	((((PRESS_SENSOR_MAX * 10ul) << CONV_Q16_SHIFT) + (ADC_MAX_VALUE / 2)) / ADC_MAX_VALUE)
+
 /********************** internal data declaration ****************************/
 
 /********************** internal functions declaration ***********************/
@@ -45,7 +55,7 @@ const char tens_lut[128] = { '0', '0', '0', '0', '0', '0', '0', '0', '0', '0',
 		'0', '0', '1', '1', '1', '1', '1', '1', '1', '1', '1', '1', '2', '2',
 		'2', '2', '2', '2', '2', '2', };
 
-const char status_msg[17] = "   \xDF""C |     kPa ";
+const char status_msg[17] = "   . \xDF""C|   . kPa";
 
 /********************** external data declaration ****************************/
 
@@ -56,25 +66,47 @@ bool is_in_range(uint32_t value, uint32_t min, uint32_t max)
 	return (value >= min) && (value <= max);
 }
 
-uint32_t temp_raw_to_celsius(uint32_t temp_raw)
+// Devuelve décimas de °C
+uint32_t temp_raw_to_deci_celsius(uint32_t temp_raw)
+{
+	return (temp_raw * TEMP_DECI_PER_RAW_Q16 + CONV_Q16_ROUND) >> CONV_Q16_SHIFT;
+}
+
+// Devuelve décimas de kPa
+uint32_t press_raw_to_deci_kPa(uint32_t press_raw)
 {
-	return (temp_raw * TEMP_SENSOR_MAX) / ADC_MAX_VALUE;
+	return (press_raw * PRESS_DECI_PER_RAW_Q16 + CONV_Q16_ROUND) >> CONV_Q16_SHIFT;
 }
 
-uint32_t press_raw_to_kPa(uint32_t press_raw)
+// Inversa de temp_raw_to_deci_celsius, en cuentas crudas de 12 bits como
+// las compara el watchdog analógico. No se usa por muestra, puede dividir.
+uint16_t temp_deci_celsius_to_adc(uint32_t temp)
 {
-	return (press_raw * PRESS_SENSOR_MAX) / ADC_MAX_VALUE;
+	uint32_t raw = (temp * ADC_RAW_MAX_VALUE + (TEMP_SENSOR_MAX * 10ul) / 2)
+					/ (TEMP_SENSOR_MAX * 10ul);
+
+	return (raw > ADC_RAW_MAX_VALUE) ? ADC_RAW_MAX_VALUE : (uint16_t)raw;
 }
 
+// temp y press en décimas, se muestran como "nn.n" y "nnn.n"
 void build_status_bar(char out_str[17], uint32_t temp, uint32_t press) {
+	uint32_t temp_int = temp / 10;
+	uint32_t press_int = press / 10;
+
 	memcpy(out_str, status_msg, sizeof(status_msg));
-	out_str[1] = tens_lut[temp];
-	out_str[2] = units_lut[temp];
-	if (press >= 100)
+	if (temp_int >= 100)
+		out_str[0] = '1';
+
+	out_str[1] = tens_lut[temp_int];
+	out_str[2] = units_lut[temp_int];
+	out_str[4] = units_lut[temp % 10];
+
+	if (press_int >= 100)
 		out_str[8] = '1';
 
-	out_str[9] = tens_lut[press];
-	out_str[10] = units_lut[press];
+	out_str[9] = tens_lut[press_int];
+	out_str[10] = units_lut[press_int];
+	out_str[12] = units_lut[press % 10];
 }
 
 /********************** end of file ******************************************/
@@ -0,0 +1,56 @@
+/*
+ * @file   : main.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ *
+ * Reemplazo de Core/Inc/main.h para el simulador. Los pines son los mismos
+ * que genera CubeMX, así board.h y las tablas de actuadores no cambian.
+ */
+
+#ifndef SIM_INC_MAIN_H_
+#define SIM_INC_MAIN_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include "stm32f1xx_hal.h"
+
+/********************** macros ***********************************************/
+#define B1_Pin GPIO_PIN_13
+#define B1_GPIO_Port GPIOC
+#define D13_Pin GPIO_PIN_5
+#define D13_GPIO_Port GPIOA
+#define D12_Pin GPIO_PIN_6
+#define D12_GPIO_Port GPIOA
+#define D11_Pin GPIO_PIN_7
+#define D11_GPIO_Port GPIOA
+#define D9_Pin GPIO_PIN_7
+#define D9_GPIO_Port GPIOC
+#define D7_Pin GPIO_PIN_8
+#define D7_GPIO_Port GPIOA
+#define D8_Pin GPIO_PIN_9
+#define D8_GPIO_Port GPIOA
+#define D2_Pin GPIO_PIN_10
+#define D2_GPIO_Port GPIOA
+#define D5_Pin GPIO_PIN_4
+#define D5_GPIO_Port GPIOB
+#define D4_Pin GPIO_PIN_5
+#define D4_GPIO_Port GPIOB
+#define D10_Pin GPIO_PIN_6
+#define D10_GPIO_Port GPIOB
+
+/********************** external functions declaration ***********************/
+void Error_Handler(void);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_INC_MAIN_H_ */
+
+/********************** end of file ******************************************/
@@ -0,0 +1,79 @@
+/*
+ * @file   : plant.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+#ifndef SIM_INC_PLANT_H_
+#define SIM_INC_PLANT_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/********************** typedef **********************************************/
+
+/* Parámetros de la cámara. Térmico de primer orden: una capacidad que pierde
+ * calor hacia el ambiente, por radiación y por convección, que cae con la
+ * presión. Vacío: un volumen con bomba, fuga y válvula de venteo. */
+typedef struct
+{
+	double t_amb;			// Temperatura ambiente [°C]
+	double heat_cap;		// Capacidad térmica [J/K]
+	double r_th;			// Resistencia térmica a presión atmosférica [K/W]
+	double conv_frac;		// Parte de la pérdida que es convección [0..1]
+	double heater_w;		// Potencia del calefactor al 100 % [W]
+	double cooler_w;		// Potencia que extrae el enfriador [W]
+
+	double volume;			// Volumen de la cámara [L]
+	double p_atm;			// Presión atmosférica [kPa]
+	double p_ult;			// Presión última de la bomba [kPa]
+	double pump_speed;		// Velocidad de bombeo [L/s]
+	double leak_rate;		// Fuga [kPa.L/s]
+	double valve_cond;		// Conductancia de la válvula de venteo [L/s]
+
+	double temp_noise;		// Desvío del ruido del sensor [°C]
+	double press_noise;		// Desvío del ruido del sensor [kPa]
+} plant_cfg_t;
+
+/* Entradas: lo que manejan los actuadores */
+typedef struct
+{
+	double heater;			// Fracción de potencia [0..1]
+	bool cooler;
+	bool pump;
+	bool vent;				// Válvula de venteo abierta
+} plant_input_t;
+
+typedef struct
+{
+	double temp;			// [°C]
+	double press;			// [kPa]
+	uint64_t rng;			// Estado del generador de ruido, uno por planta
+} plant_state_t;
+
+/********************** external functions declaration ***********************/
+void plant_default_cfg(plant_cfg_t *p_cfg);
+void plant_init(plant_state_t *p_state, const plant_cfg_t *p_cfg, uint64_t seed);
+void plant_step(plant_state_t *p_state, const plant_cfg_t *p_cfg, const plant_input_t *p_in, double dt);
+
+/* Lecturas de los sensores en cuentas de 12 bits, con ruido */
+uint16_t plant_temp_raw(plant_state_t *p_state, const plant_cfg_t *p_cfg);
+uint16_t plant_press_raw(plant_state_t *p_state, const plant_cfg_t *p_cfg);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_INC_PLANT_H_ */
+
+/********************** end of file ******************************************/
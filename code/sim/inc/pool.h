@@ -0,0 +1,52 @@
+/*
+ * @file   : pool.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ *
+ * Pool de hilos con robo de trabajo para correr muchas simulaciones
+ * independientes. Cada hilo arranca con un rango contiguo de índices y,
+ * cuando se le acaba, le roba la mitad del rango que le queda a otro.
+ */
+
+#ifndef SIM_INC_POOL_H_
+#define SIM_INC_POOL_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+#define POOL_WORKER_MAX		(256u)
+
+/********************** typedef **********************************************/
+
+/* Un trabajo, index va de 0 a qty - 1. worker identifica al hilo, sirve
+ * para estado por hilo sin locks */
+typedef void (*pool_job_t)(uint32_t index, uint32_t worker, void *p_arg);
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+/* Corre job para cada índice en worker_qty hilos y vuelve cuando terminaron
+ * todos. Devuelve false si no se pudo crear algún hilo; los que arrancaron
+ * igual terminan todo el trabajo. */
+bool pool_run(uint32_t qty, uint32_t worker_qty, pool_job_t job, void *p_arg);
+
+/* Trabajos que cada hilo le robó a otro en la última pool_run */
+uint32_t pool_steal_count(uint32_t worker);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_INC_POOL_H_ */
+
+/********************** end of file ******************************************/
@@ -0,0 +1,79 @@
+/*
+ * @file   : sim.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ *
+ * Lado del simulador del HAL: avanza el tiempo, alimenta el ADC y expone las
+ * salidas y el display para que sim_main.c cierre el lazo con la planta.
+ */
+
+#ifndef SIM_INC_SIM_H_
+#define SIM_INC_SIM_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include "main.h"
+
+/********************** macros ***********************************************/
+#define SIM_LCD_COLS		(16)
+#define SIM_LCD_ROWS		(2)
+
+#define SIM_EEPROM_SIZE		(65536ul)
+
+/********************** typedef **********************************************/
+
+/********************** external data declaration ****************************/
+
+/* Handles que en el firmware define el main.c de CubeMX */
+extern ADC_HandleTypeDef hadc1;
+extern TIM_HandleTypeDef htim3;
+extern TIM_HandleTypeDef htim4;
+extern I2C_HandleTypeDef hi2c1;
+extern I2C_HandleTypeDef hi2c2;
+extern UART_HandleTypeDef huart2;
+
+/* Salida de los mensajes de LOGGER_LOG y de la UART, NULL las descarta */
+extern FILE *sim_log_out;
+extern FILE *sim_uart_out;
+
+/********************** external functions declaration ***********************/
+
+/* Deja los periféricos como después del reset, con la EEPROM borrada y las
+ * entradas en reposo (pull-up) */
+void sim_hal_init(void);
+
+/* Avanza 1 ms: un scan del ADC (TIM3 TRGO), 10 cuentas de TIM4 (PWM del
+ * calefactor), las transferencias I2C que terminan en ese lapso y el
+ * SysTick. Se llama antes de app_update(). */
+void sim_hal_tick(uint16_t temp_raw, uint16_t press_raw);
+
+uint32_t sim_time_ms(void);
+
+/* Entradas y salidas digitales */
+void sim_input_set(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState sim_output_get(GPIO_TypeDef *port, uint16_t pin);
+
+/* Un byte recibido por la consola */
+void sim_uart_rx(uint8_t byte);
+
+/* Contenido del LCD, SIM_LCD_COLS caracteres terminados en '\0' */
+const char *sim_lcd_line(uint8_t row);
+
+/* Imagen de la EEPROM en un archivo, para conservar la configuración y las
+ * recetas entre corridas */
+bool sim_eeprom_load(const char *path);
+bool sim_eeprom_save(const char *path);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_INC_SIM_H_ */
+
+/********************** end of file ******************************************/
@@ -0,0 +1,270 @@
+/*
+ * @file   : stm32f1xx_hal.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ *
+ * Reemplazo del HAL para compilar app/ en Linux. Declara solo lo que usa la
+ * aplicación: los registros son variables del simulador y las funciones
+ * están en hal_shim.c.
+ */
+
+#ifndef SIM_INC_STM32F1XX_HAL_H_
+#define SIM_INC_STM32F1XX_HAL_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/********************** macros ***********************************************/
+
+/* Instrucciones de Cortex-M que no tienen sentido en el host. El scheduler
+ * corre en un solo hilo, así que deshabilitar interrupciones no hace falta */
+#define __asm(...)					((void)0)
+#define __DMB()						__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __DSB()						__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define __CLZ(x)					((0u == (x)) ? 32u : (uint32_t)__builtin_clz(x))
+#define __disable_irq()				((void)0)
+#define __enable_irq()				((void)0)
+
+#define ENABLE						(1u)
+#define DISABLE						(0u)
+
+/* GPIO */
+#define GPIO_PIN_0					((uint16_t)0x0001)
+#define GPIO_PIN_1					((uint16_t)0x0002)
+#define GPIO_PIN_2					((uint16_t)0x0004)
+#define GPIO_PIN_3					((uint16_t)0x0008)
+#define GPIO_PIN_4					((uint16_t)0x0010)
+#define GPIO_PIN_5					((uint16_t)0x0020)
+#define GPIO_PIN_6					((uint16_t)0x0040)
+#define GPIO_PIN_7					((uint16_t)0x0080)
+#define GPIO_PIN_8					((uint16_t)0x0100)
+#define GPIO_PIN_9					((uint16_t)0x0200)
+#define GPIO_PIN_10					((uint16_t)0x0400)
+#define GPIO_PIN_11					((uint16_t)0x0800)
+#define GPIO_PIN_12					((uint16_t)0x1000)
+#define GPIO_PIN_13					((uint16_t)0x2000)
+#define GPIO_PIN_14					((uint16_t)0x4000)
+#define GPIO_PIN_15					((uint16_t)0x8000)
+
+#define GPIOA						(&sim_gpio[0])
+#define GPIOB						(&sim_gpio[1])
+#define GPIOC						(&sim_gpio[2])
+#define GPIOD						(&sim_gpio[3])
+#define SIM_GPIO_QTY				(4)
+
+/* Instancias de periféricos, solo se comparan por dirección */
+#define ADC1						(&sim_adc1)
+#define TIM3						(&sim_tim3)
+#define TIM4						(&sim_tim4)
+#define I2C1						(&sim_i2c[0])
+#define I2C2						(&sim_i2c[1])
+#define USART2						(&sim_usart2)
+
+/* ADC */
+#define ADC_CHANNEL_0				(0u)
+#define ADC_CHANNEL_1				(1u)
+#define ADC_ANALOGWATCHDOG_NONE			(0u)
+#define ADC_ANALOGWATCHDOG_SINGLE_REG	(1u)
+#define ADC_FLAG_AWD				(0x01u)
+#define ADC_IT_AWD					(0x40u)
+
+#define __HAL_ADC_ENABLE_IT(__HANDLE__, __IT__)		((__HANDLE__)->Instance->CR1 |= (__IT__))
+#define __HAL_ADC_DISABLE_IT(__HANDLE__, __IT__)	((__HANDLE__)->Instance->CR1 &= ~(__IT__))
+#define __HAL_ADC_CLEAR_FLAG(__HANDLE__, __FLAG__)	((__HANDLE__)->Instance->SR &= ~(__FLAG__))
+
+/* TIM */
+#define TIM_CHANNEL_1				(0x00u)
+#define TIM_CHANNEL_2				(0x04u)
+#define TIM_CHANNEL_3				(0x08u)
+#define TIM_CHANNEL_4				(0x0Cu)
+#define HAL_TIM_ACTIVE_CHANNEL_1	(0x01u)
+#define HAL_TIM_ACTIVE_CHANNEL_CLEARED	(0x00u)
+
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__) \
+	((__HANDLE__)->Instance->CCR[(__CHANNEL__) >> 2] = (__COMPARE__))
+#define __HAL_TIM_GET_COMPARE(__HANDLE__, __CHANNEL__) \
+	((__HANDLE__)->Instance->CCR[(__CHANNEL__) >> 2])
+#define TIM_CCMR1_OC1PE				(0x08u)
+#define __HAL_TIM_ENABLE_OCxPRELOAD(__HANDLE__, __CHANNEL__) \
+	((__HANDLE__)->Instance->CCMR[(__CHANNEL__) >> 3] |= TIM_CCMR1_OC1PE << (((__CHANNEL__) & 0x04u) * 2u))
+#define __HAL_TIM_GET_AUTORELOAD(__HANDLE__)	((__HANDLE__)->Instance->ARR)
+#define __HAL_TIM_SET_AUTORELOAD(__HANDLE__, __AUTORELOAD__) \
+	((__HANDLE__)->Instance->ARR = (__AUTORELOAD__))
+
+/* I2C */
+#define I2C_MEMADD_SIZE_8BIT		(1u)
+#define I2C_MEMADD_SIZE_16BIT		(2u)
+
+/* Núcleo: SysTick y DWT */
+#define SysTick						(sim_systick())
+#define DWT							(&sim_dwt)
+#define CoreDebug					(&sim_core_debug)
+#define CoreDebug_DEMCR_TRCENA_Msk	(1ul << 24)
+#define DWT_CTRL_CYCCNTENA_Msk		(1ul << 0)
+
+/********************** typedef **********************************************/
+typedef enum
+{
+	HAL_OK       = 0x00U,
+	HAL_ERROR    = 0x01U,
+	HAL_BUSY     = 0x02U,
+	HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+	GPIO_PIN_RESET = 0u,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+	volatile uint32_t IDR;
+	volatile uint32_t ODR;
+	volatile uint32_t BSRR;
+} GPIO_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t SR;
+	volatile uint32_t CR1;
+} ADC_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t CR1;
+	volatile uint32_t DIER;
+	volatile uint32_t CNT;
+	volatile uint32_t ARR;
+	volatile uint32_t CCR[4];		// Con OCxPE es el de preload
+	volatile uint32_t CCMR[2];
+	uint32_t sim_ccr_active[4];		// Solo del shim: el que compara la cuenta
+} TIM_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t SR1;
+} I2C_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t SR;
+} USART_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t VAL;
+} SysTick_Type;
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+typedef struct
+{
+	uint32_t WatchdogMode;
+	uint32_t Channel;
+	uint32_t ITMode;
+	uint32_t HighThreshold;
+	uint32_t LowThreshold;
+} ADC_AnalogWDGConfTypeDef;
+
+typedef struct
+{
+	ADC_TypeDef *Instance;
+} ADC_HandleTypeDef;
+
+typedef struct
+{
+	TIM_TypeDef *Instance;
+	uint32_t Channel;
+} TIM_HandleTypeDef;
+
+typedef struct
+{
+	I2C_TypeDef *Instance;
+} I2C_HandleTypeDef;
+
+typedef enum
+{
+	HAL_UART_STATE_RESET = 0x00U,
+	HAL_UART_STATE_READY = 0x20U,
+	HAL_UART_STATE_BUSY_TX = 0x21U,
+} HAL_UART_StateTypeDef;
+
+typedef struct
+{
+	USART_TypeDef *Instance;
+	volatile HAL_UART_StateTypeDef gState;
+} UART_HandleTypeDef;
+
+/********************** external data declaration ****************************/
+extern uint32_t SystemCoreClock;
+
+extern GPIO_TypeDef sim_gpio[SIM_GPIO_QTY];
+extern ADC_TypeDef sim_adc1;
+extern TIM_TypeDef sim_tim3;
+extern TIM_TypeDef sim_tim4;
+extern I2C_TypeDef sim_i2c[2];
+extern USART_TypeDef sim_usart2;
+extern DWT_Type sim_dwt;
+extern CoreDebug_Type sim_core_debug;
+
+/********************** external functions declaration ***********************/
+SysTick_Type *sim_systick(void);
+
+uint32_t HAL_GetTick(void);
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef *hadc, ADC_AnalogWDGConfTypeDef *AnalogWDGConfig);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc);
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim);
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_INC_STM32F1XX_HAL_H_ */
+
+/********************** end of file ******************************************/
@@ -0,0 +1,91 @@
+/*
+ * @file   : sweep.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ *
+ * Una corrida del barrido: los statecharts de task_temp.c y task_press.c,
+ * cada uno con su propia instancia, contra una planta propia. Las salidas
+ * van a un contexto por hilo, así que corren muchas en paralelo.
+ */
+
+#ifndef SIM_INC_SWEEP_H_
+#define SIM_INC_SWEEP_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************** macros ***********************************************/
+
+/********************** typedef **********************************************/
+
+/* Parámetros que varían entre corridas, en las unidades de la planta o las
+ * que muestra el menú */
+typedef enum
+{
+	SWEEP_VAR_HEATER_W,			// [W]
+	SWEEP_VAR_HEAT_CAP,			// [J/K]
+	SWEEP_VAR_LEAK_RATE,		// [kPa.L/s]
+	SWEEP_VAR_TEMP_NOISE,		// Desvío por muestra [°C]
+	SWEEP_VAR_PRESS_NOISE,		// [kPa]
+	SWEEP_VAR_TEMP_HYST,		// [°C]
+	SWEEP_VAR_PRESS_HYST,		// [kPa]
+	SWEEP_VAR_KP,				// Como en el menú, ver pid.h
+	SWEEP_VAR_KI,
+	SWEEP_VAR_KD,
+	SWEEP_VAR_QTY
+} sweep_var_t;
+
+/* Escenario: arranque en frío y a presión atmosférica, control habilitado
+ * en t = 0 con un escalón a los setpoints */
+typedef struct
+{
+	double value[SWEEP_VAR_QTY];
+	bool b_pid;					// Temperatura por PID en vez de histéresis
+	double temp_setpoint;		// [°C]
+	double press_setpoint;		// [kPa]
+	double temp_alarm;			// Límites como los de la configuración
+	double press_alarm;
+	double temp_band;			// Banda de asentamiento [°C]
+	double press_band;			// [kPa]
+	uint32_t duration_ms;
+	uint64_t seed;				// Ruido de los sensores
+} sweep_param_t;
+
+/* Tiempos en s, -1 si al final de la corrida seguía fuera de la banda.
+ * Temperatura y presión son las de la planta, no las medidas. */
+typedef struct
+{
+	double temp_overshoot;		// Máximo sobre el setpoint [°C]
+	double temp_settle_s;
+	double temp_final;			// [°C]
+	double press_undershoot;	// Máximo debajo del setpoint [kPa]
+	double press_settle_s;
+	double press_final;			// [kPa]
+	uint32_t heater_starts;		// Pasajes de apagado a encendido
+	uint32_t cooler_starts;
+	uint32_t pump_starts;
+	uint32_t valve_starts;
+	uint32_t alarm_trips;		// Entradas a la condición de alarma
+} sweep_result_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+void sweep_run(const sweep_param_t *p_param, sweep_result_t *p_result);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_INC_SWEEP_H_ */
+
+/********************** end of file ******************************************/
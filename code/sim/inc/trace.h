@@ -0,0 +1,86 @@
+/*
+ * @file   : trace.h
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ *
+ * Grabación y reproducción de trazas de entradas y salidas. Un archivo de
+ * texto, un evento por línea, en orden de tiempo:
+ *
+ *   # comentario
+ *   <ms> A <temp_raw> <press_raw>	scan del ADC, vale hasta la próxima línea A
+ *   <ms> I <ent|nex|pre|esc|sw> <0|1>	nivel de un pin de entrada
+ *   <ms> O <pump|valve|cooler|buzzer> <0|1>	nivel de un pin de salida
+ *   <ms> O heater <duty>			PWM del calefactor [0.1 %]
+ *   <ms> C rec <ranura>			arranca la receta 1..n, como el menú
+ *   <ms> C <pause|abort> 0		pausa o reanuda, o aborta la receta
+ *   <ms> C rx <byte>			byte recibido por la consola
+ *   <ms> D <fila> "<texto>"		línea del LCD, no imprimibles como \xHH
+ *   <ms> E					fin de la traza
+ *
+ * Al reproducir, las líneas A e I alimentan al HAL, las C se ejecutan de
+ * nuevo y las O y D son lo que se espera que la aplicación produzca, en el
+ * mismo ms y en el mismo orden.
+ */
+
+#ifndef SIM_INC_TRACE_H_
+#define SIM_INC_TRACE_H_
+
+/********************** CPP guard ********************************************/
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************** inclusions *******************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/********************** macros ***********************************************/
+
+/********************** typedef **********************************************/
+
+/* Comandos que no entran por un pin, mismo orden que los nombres de trace.c */
+typedef enum {
+	TRACE_CMD_RECIPE,			// value: ranura desde 1
+	TRACE_CMD_PAUSE,
+	TRACE_CMD_ABORT,
+	TRACE_CMD_UART_RX,			// value: el byte
+	TRACE_CMD_QTY
+} trace_cmd_t;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions declaration ***********************/
+
+/* Graba las entradas y salidas de la corrida en path */
+bool trace_record_open(const char *path);
+
+/* Carga la traza de path para reproducirla. p_end_ms es el tiempo de la
+ * línea E, hasta donde hay que simular. */
+bool trace_replay_open(const char *path, uint32_t *p_end_ms);
+
+/* Antes de sim_hal_tick(): al grabar anota los pines de entrada y las
+ * lecturas del ADC que cambiaron; al reproducir aplica las de este ms y
+ * devuelve en *p_temp_raw y *p_press_raw las vigentes */
+void trace_inputs(uint32_t now, uint16_t *p_temp_raw, uint16_t *p_press_raw);
+
+/* Ejecuta un comando y, si se está grabando, lo anota. Se llama antes de
+ * trace_inputs() del mismo ms; al reproducir los ejecuta trace_inputs() */
+void trace_command(uint32_t now, trace_cmd_t cmd, uint32_t value);
+
+/* Después de app_update(): anota o compara las salidas que cambiaron */
+void trace_outputs(uint32_t now);
+
+/* Cierra la grabación o informa en p_out el resultado de la comparación.
+ * Devuelve false si hubo un error de escritura o diferencias. */
+bool trace_close(uint32_t now, FILE *p_out);
+
+/********************** End of CPP guard *************************************/
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_INC_TRACE_H_ */
+
+/********************** end of file ******************************************/
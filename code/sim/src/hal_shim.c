@@ -0,0 +1,612 @@
+/*
+ * @file   : hal_shim.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+#include "main.h"
+#include "sim.h"
+#include "logger.h"
+
+#include <stdlib.h>
+
+/********************** macros and definitions *******************************/
+
+/* SysTick a 8 MHz: cada lectura de VAL avanza 1 us, alcanza para DELAY_US */
+#define SIM_CORE_CLOCK			8000000ul
+#define SIM_CYCLES_PER_MS		(SIM_CORE_CLOCK / 1000ul)
+#define SIM_SYSTICK_STEP		(SIM_CORE_CLOCK / 1000000ul)
+
+/* I2C a 100 kHz: 9 bits por byte, incluidos el ACK y la dirección */
+#define SIM_I2C_US_PER_BYTE		90ul
+#define SIM_I2C_BUS_QTY			(2)
+
+/* TIM4 como lo configura MX_TIM4_Init: 8 MHz / 800 = 10 kHz */
+#define SIM_TIM4_TICKS_PER_MS	10ul
+#define SIM_TIM_CR1_CEN			(0x01u)
+#define SIM_TIM_DIER_UIE		(0x01u)
+#define SIM_TIM_DIER_CC1IE		(0x02u)
+
+/* PCF8574 del LCD */
+#define LCD_BIT_RS				(0x01u)
+#define LCD_BIT_EN				(0x04u)
+
+typedef enum {
+	SIM_I2C_IDLE,
+	SIM_I2C_MASTER_TX,
+	SIM_I2C_MEM_TX,
+} sim_i2c_xfer_t;
+
+typedef struct {
+	I2C_HandleTypeDef *hi2c;
+	sim_i2c_xfer_t xfer;
+	uint32_t remaining_us;		// Tiempo de bus que falta para el callback
+} sim_i2c_bus_t;
+
+typedef struct {
+	char ddram[SIM_LCD_ROWS][SIM_LCD_COLS + 1];
+	uint8_t addr;
+	uint8_t prev;				// Último byte del expansor, para ver el flanco de EN
+	uint8_t high;
+	bool b_high;				// Ya llegó el nibble alto
+} sim_lcd_t;
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+static void sim_lcd_write(const uint8_t *p_data, uint16_t size);
+static void sim_lcd_exec(uint8_t value, bool b_data);
+static sim_i2c_bus_t *sim_i2c_bus(I2C_HandleTypeDef *hi2c);
+static void sim_i2c_advance(uint32_t budget_us);
+static void sim_adc_scan(uint16_t temp_raw, uint16_t press_raw);
+static void sim_tim_advance(TIM_HandleTypeDef *htim, uint32_t ticks);
+
+/********************** internal data definition *****************************/
+static uint32_t sim_tick;
+static SysTick_Type sim_systick_regs;
+
+static volatile uint16_t *sim_adc_dma;
+static uint32_t sim_adc_dma_len;
+static uint32_t sim_adc_dma_pos;
+static ADC_AnalogWDGConfTypeDef sim_adc_awd;
+
+static sim_i2c_bus_t sim_i2c_bus_list[SIM_I2C_BUS_QTY];
+static sim_lcd_t sim_lcd;
+static uint8_t sim_eeprom[SIM_EEPROM_SIZE];
+
+static uint8_t *sim_uart_rx_ptr;
+
+/********************** external data declaration ****************************/
+uint32_t SystemCoreClock = SIM_CORE_CLOCK;
+
+GPIO_TypeDef sim_gpio[SIM_GPIO_QTY];
+ADC_TypeDef sim_adc1;
+TIM_TypeDef sim_tim3;
+TIM_TypeDef sim_tim4;
+I2C_TypeDef sim_i2c[2];
+USART_TypeDef sim_usart2;
+DWT_Type sim_dwt;
+CoreDebug_Type sim_core_debug;
+
+/* Los handles que define el main.c de CubeMX */
+ADC_HandleTypeDef hadc1 = {ADC1};
+TIM_HandleTypeDef htim3 = {TIM3, HAL_TIM_ACTIVE_CHANNEL_CLEARED};
+TIM_HandleTypeDef htim4 = {TIM4, HAL_TIM_ACTIVE_CHANNEL_CLEARED};
+I2C_HandleTypeDef hi2c1 = {I2C1};
+I2C_HandleTypeDef hi2c2 = {I2C2};
+UART_HandleTypeDef huart2 = {USART2, HAL_UART_STATE_READY};
+
+FILE *sim_log_out;
+FILE *sim_uart_out;
+
+/* El scheduler cuenta los ticks en este callback, está en app.c */
+extern void HAL_SYSTICK_Callback(void);
+
+/********************** external functions definition ************************/
+
+void sim_hal_init(void)
+{
+	uint32_t index;
+
+	sim_tick = 0;
+	sim_systick_regs.VAL = SIM_CYCLES_PER_MS - 1;
+	memset(&sim_dwt, 0, sizeof(sim_dwt));
+
+	/* Entradas con pull-up: botones sueltos y llave apagada */
+	for (index = 0; SIM_GPIO_QTY > index; index++)
+	{
+		sim_gpio[index].IDR = 0xFFFFu;
+		sim_gpio[index].ODR = 0;
+	}
+
+	memset(&sim_adc1, 0, sizeof(sim_adc1));
+	sim_adc_dma = NULL;
+	sim_adc_dma_len = 0;
+	sim_adc_dma_pos = 0;
+	memset(&sim_adc_awd, 0, sizeof(sim_adc_awd));
+
+	/* TIM3 como lo configura MX_TIM3_Init: 8 MHz / 8000 = 1 kHz */
+	memset(&sim_tim3, 0, sizeof(sim_tim3));
+	sim_tim3.ARR = 7999;
+	memset(&sim_tim4, 0, sizeof(sim_tim4));
+	sim_tim4.ARR = 19999;
+	htim4.Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+
+	memset(sim_i2c_bus_list, 0, sizeof(sim_i2c_bus_list));
+	memset(&sim_lcd, 0, sizeof(sim_lcd));
+	memset(sim_lcd.ddram, ' ', sizeof(sim_lcd.ddram));
+	sim_lcd.ddram[0][SIM_LCD_COLS] = '\0';
+	sim_lcd.ddram[1][SIM_LCD_COLS] = '\0';
+	memset(sim_eeprom, 0xFF, sizeof(sim_eeprom));
+
+	huart2.gState = HAL_UART_STATE_READY;
+	sim_uart_rx_ptr = NULL;
+
+	sim_log_out = stderr;
+	sim_uart_out = stderr;
+}
+
+void sim_hal_tick(uint16_t temp_raw, uint16_t press_raw)
+{
+	sim_tick++;
+	if (sim_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk)
+	{
+		sim_dwt.CYCCNT += SIM_CYCLES_PER_MS;
+	}
+
+	sim_adc_scan(temp_raw, press_raw);
+	sim_tim_advance(&htim4, SIM_TIM4_TICKS_PER_MS);
+	sim_i2c_advance(1000ul);
+
+	HAL_SYSTICK_Callback();
+}
+
+uint32_t sim_time_ms(void)
+{
+	return sim_tick;
+}
+
+void sim_input_set(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state)
+{
+	if (GPIO_PIN_SET == state)
+	{
+		port->IDR |= pin;
+	}
+	else
+	{
+		port->IDR &= ~(uint32_t)pin;
+	}
+}
+
+GPIO_PinState sim_output_get(GPIO_TypeDef *port, uint16_t pin)
+{
+	return (port->ODR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void sim_uart_rx(uint8_t byte)
+{
+	if (NULL != sim_uart_rx_ptr)
+	{
+		*sim_uart_rx_ptr = byte;
+		sim_uart_rx_ptr = NULL;
+		HAL_UART_RxCpltCallback(&huart2);
+	}
+}
+
+const char *sim_lcd_line(uint8_t row)
+{
+	return sim_lcd.ddram[row % SIM_LCD_ROWS];
+}
+
+bool sim_eeprom_load(const char *path)
+{
+	FILE *p_file = fopen(path, "rb");
+	size_t len;
+
+	if (NULL == p_file)
+	{
+		return false;
+	}
+	len = fread(sim_eeprom, 1, sizeof(sim_eeprom), p_file);
+	fclose(p_file);
+
+	return 0 < len;
+}
+
+bool sim_eeprom_save(const char *path)
+{
+	FILE *p_file = fopen(path, "wb");
+	size_t len;
+
+	if (NULL == p_file)
+	{
+		return false;
+	}
+	len = fwrite(sim_eeprom, 1, sizeof(sim_eeprom), p_file);
+	fclose(p_file);
+
+	return sizeof(sim_eeprom) == len;
+}
+
+/* ---------------------------------------------------------------------------
+ * Núcleo
+ * ------------------------------------------------------------------------- */
+
+SysTick_Type *sim_systick(void)
+{
+	if (sim_systick_regs.VAL < SIM_SYSTICK_STEP)
+	{
+		sim_systick_regs.VAL += SIM_CYCLES_PER_MS;
+	}
+	sim_systick_regs.VAL -= SIM_SYSTICK_STEP;
+
+	return &sim_systick_regs;
+}
+
+// Arranca en 100 ms para que la espera de encendido del LCD no se cuelgue:
+// el tiempo simulado solo avanza entre updates
+uint32_t HAL_GetTick(void)
+{
+	return sim_tick + 100ul;
+}
+
+void Error_Handler(void)
+{
+	fprintf(stderr, "sim: Error_Handler at %lu ms\n", (unsigned long)sim_tick);
+	abort();
+}
+
+// Reemplaza a logger.c, que escribe por semihosting
+void logger_log_print_(char* const msg)
+{
+	if (NULL != sim_log_out)
+	{
+		fputs(msg, sim_log_out);
+	}
+}
+
+static char logger_msg_buffer_[LOGGER_CONFIG_MAXLEN];
+char* const logger_msg = logger_msg_buffer_;
+int logger_msg_len;
+
+/* ---------------------------------------------------------------------------
+ * GPIO
+ * ------------------------------------------------------------------------- */
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	return (GPIOx->IDR & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	if (GPIO_PIN_SET == PinState)
+	{
+		GPIOx->ODR |= GPIO_Pin;
+	}
+	else
+	{
+		GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+	}
+}
+
+/* ---------------------------------------------------------------------------
+ * ADC con DMA circular y watchdog analógico
+ * ------------------------------------------------------------------------- */
+
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *pData, uint32_t Length)
+{
+	/* El DMA transfiere medias palabras aunque la firma diga uint32_t */
+	sim_adc_dma = (volatile uint16_t *)pData;
+	sim_adc_dma_len = Length;
+	sim_adc_dma_pos = 0;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_AnalogWDGConfig(ADC_HandleTypeDef *hadc, ADC_AnalogWDGConfTypeDef *AnalogWDGConfig)
+{
+	sim_adc_awd = *AnalogWDGConfig;
+
+	return HAL_OK;
+}
+
+// Un scan de CH0 (temperatura) y CH1 (presión), como en el orden de rangos
+static void sim_adc_scan(uint16_t temp_raw, uint16_t press_raw)
+{
+	if ((NULL == sim_adc_dma) || (2 > sim_adc_dma_len))
+	{
+		return;
+	}
+
+	sim_adc_dma[sim_adc_dma_pos++] = temp_raw;
+	sim_adc_dma[sim_adc_dma_pos++] = press_raw;
+
+	if ((ADC_ANALOGWATCHDOG_SINGLE_REG == sim_adc_awd.WatchdogMode)
+			&& (ADC_CHANNEL_0 == sim_adc_awd.Channel)
+			&& ((temp_raw > sim_adc_awd.HighThreshold) || (temp_raw < sim_adc_awd.LowThreshold)))
+	{
+		sim_adc1.SR |= ADC_FLAG_AWD;
+		if (sim_adc1.CR1 & ADC_IT_AWD)
+		{
+			HAL_ADC_LevelOutOfWindowCallback(&hadc1);
+		}
+	}
+
+	if (sim_adc_dma_len / 2 == sim_adc_dma_pos)
+	{
+		HAL_ADC_ConvHalfCpltCallback(&hadc1);
+	}
+	else if (sim_adc_dma_len <= sim_adc_dma_pos)
+	{
+		sim_adc_dma_pos = 0;
+		HAL_ADC_ConvCpltCallback(&hadc1);
+	}
+}
+
+/* ---------------------------------------------------------------------------
+ * TIM
+ * ------------------------------------------------------------------------- */
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim)
+{
+	htim->Instance->DIER |= SIM_TIM_DIER_UIE;
+	htim->Instance->CR1 |= SIM_TIM_CR1_CEN;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_OC_Start_IT(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+	if (TIM_CHANNEL_1 == Channel)
+	{
+		htim->Instance->DIER |= SIM_TIM_DIER_CC1IE;
+	}
+	htim->Instance->CR1 |= SIM_TIM_CR1_CEN;
+	return HAL_OK;
+}
+
+/* Cuenta de a un tick. Como en HAL_TIM_IRQHandler, la comparación se atiende
+ * antes que el update cuando coinciden en la misma cuenta. Con OC1PE el CCR1
+ * pasa al registro activo recién con el update. */
+static void sim_tim_advance(TIM_HandleTypeDef *htim, uint32_t ticks)
+{
+	TIM_TypeDef *p_tim = htim->Instance;
+	bool b_update;
+
+	if (!(p_tim->CR1 & SIM_TIM_CR1_CEN))
+	{
+		return;
+	}
+
+	while (0 < ticks--)
+	{
+		b_update = (p_tim->ARR <= p_tim->CNT);
+		p_tim->CNT = b_update ? 0 : p_tim->CNT + 1;
+
+		if (b_update || !(p_tim->CCMR[0] & TIM_CCMR1_OC1PE))
+		{
+			p_tim->sim_ccr_active[0] = p_tim->CCR[0];
+		}
+
+		if ((p_tim->DIER & SIM_TIM_DIER_CC1IE) && (p_tim->sim_ccr_active[0] == p_tim->CNT))
+		{
+			htim->Channel = HAL_TIM_ACTIVE_CHANNEL_1;
+			HAL_TIM_OC_DelayElapsedCallback(htim);
+			htim->Channel = HAL_TIM_ACTIVE_CHANNEL_CLEARED;
+		}
+		if (b_update && (p_tim->DIER & SIM_TIM_DIER_UIE))
+		{
+			HAL_TIM_PeriodElapsedCallback(htim);
+		}
+	}
+}
+
+/* ---------------------------------------------------------------------------
+ * I2C: el bus 1 tiene la EEPROM y el bus 2 el LCD. Las transferencias por
+ * interrupción terminan cuando pasa su tiempo de bus simulado.
+ * ------------------------------------------------------------------------- */
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	if (I2C2 == hi2c->Instance)
+	{
+		sim_lcd_write(pData, Size);
+	}
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	sim_i2c_bus_t *p_bus = sim_i2c_bus(hi2c);
+
+	if (SIM_I2C_IDLE != p_bus->xfer)
+	{
+		return HAL_BUSY;
+	}
+
+	if (I2C2 == hi2c->Instance)
+	{
+		sim_lcd_write(pData, Size);
+	}
+
+	p_bus->hi2c = hi2c;
+	p_bus->xfer = SIM_I2C_MASTER_TX;
+	p_bus->remaining_us = (1ul + Size) * SIM_I2C_US_PER_BYTE;
+
+	return HAL_OK;
+}
+
+// Para el bus da lo mismo quién mueve los bytes: mismo tiempo y callback
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_DMA(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData, uint16_t Size)
+{
+	return HAL_I2C_Master_Transmit_IT(hi2c, DevAddress, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size)
+{
+	sim_i2c_bus_t *p_bus = sim_i2c_bus(hi2c);
+	uint32_t index;
+
+	if (SIM_I2C_IDLE != p_bus->xfer)
+	{
+		return HAL_BUSY;
+	}
+
+	if (I2C1 == hi2c->Instance)
+	{
+		for (index = 0; Size > index; index++)
+		{
+			sim_eeprom[(MemAddress + index) % SIM_EEPROM_SIZE] = pData[index];
+		}
+	}
+
+	p_bus->hi2c = hi2c;
+	p_bus->xfer = SIM_I2C_MEM_TX;
+	p_bus->remaining_us = (1ul + MemAddSize + Size) * SIM_I2C_US_PER_BYTE;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress, uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	uint32_t index;
+
+	if (I2C1 != hi2c->Instance)
+	{
+		return HAL_ERROR;
+	}
+
+	for (index = 0; Size > index; index++)
+	{
+		pData[index] = sim_eeprom[(MemAddress + index) % SIM_EEPROM_SIZE];
+	}
+
+	return HAL_OK;
+}
+
+static sim_i2c_bus_t *sim_i2c_bus(I2C_HandleTypeDef *hi2c)
+{
+	return &sim_i2c_bus_list[(I2C1 == hi2c->Instance) ? 0 : 1];
+}
+
+// Un callback puede arrancar la transferencia siguiente, que sigue
+// consumiendo el mismo presupuesto de tiempo
+static void sim_i2c_advance(uint32_t budget_us)
+{
+	uint32_t index;
+	uint32_t left;
+	sim_i2c_bus_t *p_bus;
+
+	for (index = 0; SIM_I2C_BUS_QTY > index; index++)
+	{
+		p_bus = &sim_i2c_bus_list[index];
+		left = budget_us;
+
+		while ((SIM_I2C_IDLE != p_bus->xfer) && (p_bus->remaining_us <= left))
+		{
+			left -= p_bus->remaining_us;
+
+			if (SIM_I2C_MASTER_TX == p_bus->xfer)
+			{
+				p_bus->xfer = SIM_I2C_IDLE;
+				HAL_I2C_MasterTxCpltCallback(p_bus->hi2c);
+			}
+			else
+			{
+				p_bus->xfer = SIM_I2C_IDLE;
+				HAL_I2C_MemTxCpltCallback(p_bus->hi2c);
+			}
+		}
+
+		if (SIM_I2C_IDLE != p_bus->xfer)
+		{
+			p_bus->remaining_us -= left;
+		}
+	}
+}
+
+// El HD44780 toma el nibble en el flanco de bajada de EN, en modo 4 bits
+static void sim_lcd_write(const uint8_t *p_data, uint16_t size)
+{
+	uint16_t index;
+	uint8_t byte;
+
+	for (index = 0; size > index; index++)
+	{
+		byte = p_data[index];
+
+		if ((sim_lcd.prev & LCD_BIT_EN) && !(byte & LCD_BIT_EN))
+		{
+			if (false == sim_lcd.b_high)
+			{
+				sim_lcd.high = byte & 0xF0u;
+				sim_lcd.b_high = true;
+			}
+			else
+			{
+				sim_lcd.b_high = false;
+				sim_lcd_exec(sim_lcd.high | (byte >> 4), byte & LCD_BIT_RS);
+			}
+		}
+
+		sim_lcd.prev = byte;
+	}
+}
+
+static void sim_lcd_exec(uint8_t value, bool b_data)
+{
+	uint8_t row;
+	uint8_t col;
+
+	if (b_data)
+	{
+		row = (sim_lcd.addr & 0x40u) ? 1 : 0;
+		col = sim_lcd.addr & 0x3Fu;
+		if (SIM_LCD_COLS > col)
+		{
+			sim_lcd.ddram[row][col] = (char)value;
+		}
+		sim_lcd.addr++;
+	}
+	else if (value & 0x80u)
+	{
+		sim_lcd.addr = value & 0x7Fu;
+	}
+	else if (0x01u == value)
+	{
+		memset(sim_lcd.ddram[0], ' ', SIM_LCD_COLS);
+		memset(sim_lcd.ddram[1], ' ', SIM_LCD_COLS);
+		sim_lcd.addr = 0;
+	}
+	else if (0x02u == (value & 0xFEu))
+	{
+		sim_lcd.addr = 0;
+	}
+}
+
+/* ---------------------------------------------------------------------------
+ * UART de la consola
+ * ------------------------------------------------------------------------- */
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+	sim_uart_rx_ptr = pData;
+
+	return HAL_OK;
+}
+
+// Termina en el acto, la consola no espera el callback de transmisión
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *pData, uint16_t Size)
+{
+	if (NULL != sim_uart_out)
+	{
+		fwrite(pData, 1, Size, sim_uart_out);
+	}
+
+	return HAL_OK;
+}
+
+/********************** end of file ******************************************/
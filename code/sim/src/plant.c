@@ -0,0 +1,147 @@
+/*
+ * @file   : plant.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+#include "plant.h"
+
+#include <math.h>
+
+/********************** macros and definitions *******************************/
+
+/* Escala de los sensores, la misma que asume utils.c */
+#define SENSOR_TEMP_MAX			100.0	// °C
+#define SENSOR_PRESS_MAX		110.0	// kPa
+#define SENSOR_RAW_MAX			4095.0
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+static double plant_rand_uniform(plant_state_t *p_state);
+static double plant_rand_normal(plant_state_t *p_state);
+static uint16_t plant_to_raw(double value, double full_scale);
+
+/********************** internal data definition *****************************/
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+
+// Cámara chica: tau térmica de ~17 min y ~50 s de bombeo
+void plant_default_cfg(plant_cfg_t *p_cfg)
+{
+	p_cfg->t_amb = 25.0;
+	p_cfg->heat_cap = 2000.0;
+	p_cfg->r_th = 0.5;
+	p_cfg->conv_frac = 0.6;
+	p_cfg->heater_w = 200.0;
+	p_cfg->cooler_w = 80.0;
+
+	p_cfg->volume = 100.0;
+	p_cfg->p_atm = 101.3;
+	p_cfg->p_ult = 0.5;
+	p_cfg->pump_speed = 2.0;
+	p_cfg->leak_rate = 0.05;
+	p_cfg->valve_cond = 1.0;
+
+	p_cfg->temp_noise = 0.1;
+	p_cfg->press_noise = 0.1;
+}
+
+void plant_init(plant_state_t *p_state, const plant_cfg_t *p_cfg, uint64_t seed)
+{
+	p_state->temp = p_cfg->t_amb;
+	p_state->press = p_cfg->p_atm;
+	p_state->rng = seed ? seed : 1;
+}
+
+// Euler explícito: con dt de 1 ms y constantes de tiempo de segundos alcanza
+void plant_step(plant_state_t *p_state, const plant_cfg_t *p_cfg, const plant_input_t *p_in, double dt)
+{
+	double g_loss;
+	double power;
+	double flow;
+
+	/* La convección escala con la presión, la radiación no */
+	g_loss = (1.0 - p_cfg->conv_frac + p_cfg->conv_frac * p_state->press / p_cfg->p_atm) / p_cfg->r_th;
+
+	power = p_in->heater * p_cfg->heater_w
+			- (p_in->cooler ? p_cfg->cooler_w : 0.0)
+			- g_loss * (p_state->temp - p_cfg->t_amb);
+	p_state->temp += power * dt / p_cfg->heat_cap;
+
+	flow = p_cfg->leak_rate;
+	if (p_in->pump)
+	{
+		flow -= p_cfg->pump_speed * (p_state->press - p_cfg->p_ult);
+	}
+	if (p_in->vent)
+	{
+		flow += p_cfg->valve_cond * (p_cfg->p_atm - p_state->press);
+	}
+	p_state->press += flow * dt / p_cfg->volume;
+
+	if (p_state->press < 0.0)
+	{
+		p_state->press = 0.0;
+	}
+}
+
+uint16_t plant_temp_raw(plant_state_t *p_state, const plant_cfg_t *p_cfg)
+{
+	return plant_to_raw(p_state->temp + p_cfg->temp_noise * plant_rand_normal(p_state),
+						SENSOR_TEMP_MAX);
+}
+
+uint16_t plant_press_raw(plant_state_t *p_state, const plant_cfg_t *p_cfg)
+{
+	return plant_to_raw(p_state->press + p_cfg->press_noise * plant_rand_normal(p_state),
+						SENSOR_PRESS_MAX);
+}
+
+/********************** internal functions definition ************************/
+
+// xorshift64*, el estado vive en la planta para poder correr varias a la vez
+static double plant_rand_uniform(plant_state_t *p_state)
+{
+	p_state->rng ^= p_state->rng >> 12;
+	p_state->rng ^= p_state->rng << 25;
+	p_state->rng ^= p_state->rng >> 27;
+
+	return ((p_state->rng * 2685821657736338717ull) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Box-Muller, se descarta el segundo valor
+static double plant_rand_normal(plant_state_t *p_state)
+{
+	double u1 = plant_rand_uniform(p_state);
+	double u2 = plant_rand_uniform(p_state);
+
+	if (u1 < 1e-300)
+	{
+		u1 = 1e-300;
+	}
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static uint16_t plant_to_raw(double value, double full_scale)
+{
+	double raw = value * SENSOR_RAW_MAX / full_scale + 0.5;
+
+	if (raw < 0.0)
+	{
+		return 0;
+	}
+	if (raw > SENSOR_RAW_MAX)
+	{
+		return (uint16_t)SENSOR_RAW_MAX;
+	}
+
+	return (uint16_t)raw;
+}
+
+/********************** end of file ******************************************/
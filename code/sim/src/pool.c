@@ -0,0 +1,183 @@
+/*
+ * @file   : pool.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+#include "pool.h"
+
+#include <pthread.h>
+
+/********************** macros and definitions *******************************/
+
+/* Rango de índices pendientes de un hilo: el dueño toma de tail, los demás
+ * roban desde head. Como los trabajos no generan trabajos nuevos alcanza con
+ * un rango y un mutex. */
+typedef struct
+{
+	pthread_mutex_t lock;
+	uint32_t head;
+	uint32_t tail;
+	uint32_t steal_cnt;
+} pool_deque_t;
+
+typedef struct
+{
+	uint32_t worker;
+	pthread_t thread;
+} pool_worker_t;
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+static bool pool_pop(pool_deque_t *p_deque, uint32_t *p_index);
+static bool pool_steal(uint32_t worker);
+static void *pool_worker(void *p_arg);
+
+/********************** internal data definition *****************************/
+static pool_deque_t pool_deque_list[POOL_WORKER_MAX];
+static pool_worker_t pool_worker_list[POOL_WORKER_MAX];
+static uint32_t pool_worker_qty;
+static pool_job_t pool_job;
+static void *p_pool_arg;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+
+bool pool_run(uint32_t qty, uint32_t worker_qty, pool_job_t job, void *p_arg)
+{
+	uint32_t worker;
+	uint32_t started;
+	bool b_ok = true;
+
+	if (0 == worker_qty)
+	{
+		worker_qty = 1;
+	}
+	if (POOL_WORKER_MAX < worker_qty)
+	{
+		worker_qty = POOL_WORKER_MAX;
+	}
+
+	pool_worker_qty = worker_qty;
+	pool_job = job;
+	p_pool_arg = p_arg;
+
+	/* Reparto inicial en bloques contiguos de igual tamaño */
+	for (worker = 0; worker_qty > worker; worker++)
+	{
+		pthread_mutex_init(&pool_deque_list[worker].lock, NULL);
+		pool_deque_list[worker].head = (uint32_t)(((uint64_t)qty * worker) / worker_qty);
+		pool_deque_list[worker].tail = (uint32_t)(((uint64_t)qty * (worker + 1)) / worker_qty);
+		pool_deque_list[worker].steal_cnt = 0;
+		pool_worker_list[worker].worker = worker;
+	}
+
+	/* El hilo que llama es el worker 0, así siempre hay al menos uno */
+	for (started = 1; worker_qty > started; started++)
+	{
+		if (0 != pthread_create(&pool_worker_list[started].thread, NULL,
+								pool_worker, &pool_worker_list[started]))
+		{
+			b_ok = false;
+			break;
+		}
+	}
+
+	pool_worker(&pool_worker_list[0]);
+
+	for (worker = 1; started > worker; worker++)
+	{
+		pthread_join(pool_worker_list[worker].thread, NULL);
+	}
+	for (worker = 0; worker_qty > worker; worker++)
+	{
+		pthread_mutex_destroy(&pool_deque_list[worker].lock);
+	}
+
+	return b_ok;
+}
+
+uint32_t pool_steal_count(uint32_t worker)
+{
+	return (pool_worker_qty > worker) ? pool_deque_list[worker].steal_cnt : 0;
+}
+
+/********************** internal functions definition ************************/
+
+static bool pool_pop(pool_deque_t *p_deque, uint32_t *p_index)
+{
+	bool b_ok = false;
+
+	pthread_mutex_lock(&p_deque->lock);
+	if (p_deque->head < p_deque->tail)
+	{
+		p_deque->tail--;
+		*p_index = p_deque->tail;
+		b_ok = true;
+	}
+	pthread_mutex_unlock(&p_deque->lock);
+
+	return b_ok;
+}
+
+// Recorre a los demás empezando por el siguiente y se lleva la mitad
+// (redondeada para arriba) del primer rango no vacío que encuentra
+static bool pool_steal(uint32_t worker)
+{
+	pool_deque_t *p_own = &pool_deque_list[worker];
+	pool_deque_t *p_victim;
+	uint32_t offset;
+	uint32_t head = 0;
+	uint32_t qty = 0;
+
+	for (offset = 1; (pool_worker_qty > offset) && (0 == qty); offset++)
+	{
+		p_victim = &pool_deque_list[(worker + offset) % pool_worker_qty];
+
+		pthread_mutex_lock(&p_victim->lock);
+		if (p_victim->head < p_victim->tail)
+		{
+			qty = (p_victim->tail - p_victim->head + 1) / 2;
+			head = p_victim->head;
+			p_victim->head += qty;
+		}
+		pthread_mutex_unlock(&p_victim->lock);
+	}
+
+	if (0 == qty)
+	{
+		return false;
+	}
+
+	pthread_mutex_lock(&p_own->lock);
+	p_own->head = head;
+	p_own->tail = head + qty;
+	p_own->steal_cnt += qty;
+	pthread_mutex_unlock(&p_own->lock);
+
+	return true;
+}
+
+// Sin trabajos nuevos, una vuelta entera sin nada para robar quiere decir
+// que lo que queda ya lo tiene tomado otro hilo
+static void *pool_worker(void *p_arg)
+{
+	uint32_t worker = ((pool_worker_t *)p_arg)->worker;
+	uint32_t index;
+
+	do
+	{
+		while (true == pool_pop(&pool_deque_list[worker], &index))
+		{
+			pool_job(index, worker, p_pool_arg);
+		}
+	} while (true == pool_steal(worker));
+
+	return NULL;
+}
+
+/********************** end of file ******************************************/
@@ -0,0 +1,432 @@
+/*
+ * @file   : sim_main.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ *
+ * Corre la aplicación sin cambios contra el HAL simulado y la planta, más
+ * rápido que el tiempo real. Escribe una traza CSV por stdout.
+ *
+ * También graba las entradas y salidas de una corrida (-w) y las reproduce
+ * (-R): en vez de la planta y el guion, el ADC y los pines salen de la
+ * traza y las salidas de la aplicación se comparan con las grabadas.
+ */
+
+/********************** inclusions *******************************************/
+#include "main.h"
+#include "sim.h"
+#include "plant.h"
+#include "trace.h"
+
+#include "board.h"
+#include "pwm.h"
+#include "app.h"
+#include "task_recipe.h"
+#include "task_recipe_attribute.h"
+#include "task_recipe_interface.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+/********************** macros and definitions *******************************/
+#define SIM_DURATION_DEF_S		60ul
+#define SIM_TRACE_PERIOD_DEF_S	10ul
+#define SIM_BUTTON_HOLD_MS		200ul
+#define SIM_KEY_MAX				64
+
+/* La llave se prende después de salir del menú inicial, la receta después */
+#define SIM_SCRIPT_DEF			"300:esc,1000:on"
+#define SIM_RECIPE_START_MS		1500ul
+
+typedef struct {
+	uint32_t ms;
+	uint32_t hold_ms;
+	char key[8];
+} sim_key_t;
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+static void sim_usage(const char *p_name);
+static bool sim_script_parse(const char *p_script);
+static void sim_script_run(uint32_t now);
+static void sim_trace_header(bool b_lcd);
+static void sim_trace(const plant_state_t *p_plant, bool b_lcd);
+static void sim_realtime_wait(const struct timespec *p_start, uint32_t now);
+
+/********************** internal data definition *****************************/
+static sim_key_t sim_key_list[SIM_KEY_MAX];
+static uint32_t sim_key_qty;
+
+/* Botones con su hora de suelta, 0 si no están apretados */
+static struct {
+	const char *name;
+	GPIO_TypeDef *port;
+	uint16_t pin;
+	uint32_t release_ms;
+} sim_button_list[] = {
+	{"ent", BTN_ENT_PORT, BTN_ENT_PIN, 0},
+	{"nex", BTN_NEX_PORT, BTN_NEX_PIN, 0},
+	{"pre", BTN_PRE_PORT, BTN_PRE_PIN, 0},
+	{"esc", BTN_ESC_PORT, BTN_ESC_PIN, 0},
+};
+
+#define SIM_BUTTON_QTY	(sizeof(sim_button_list)/sizeof(sim_button_list[0]))
+
+/********************** external data declaration ****************************/
+extern shared_data_type shared_data;
+
+/********************** external functions definition ************************/
+
+int main(int argc, char *argv[])
+{
+	plant_cfg_t plant_cfg;
+	plant_state_t plant;
+	plant_input_t input;
+	uint64_t duration_ms = SIM_DURATION_DEF_S * 1000ul;
+	uint32_t trace_ms = SIM_TRACE_PERIOD_DEF_S * 1000ul;
+	const char *p_eeprom = NULL;
+	const char *p_record = NULL;
+	const char *p_replay = NULL;
+	uint32_t replay_end_ms;
+	struct timespec start;
+	uint16_t temp_raw;
+	uint16_t press_raw;
+	bool b_realtime = false;
+	bool b_ok = true;
+	uint64_t seed = 1;
+	bool b_verbose = false;
+	bool b_lcd = false;
+	char script[512] = SIM_SCRIPT_DEF;
+	char recipe_key[24];
+	uint32_t now;
+	int opt;
+
+	while (-1 != (opt = getopt(argc, argv, "d:p:r:e:s:k:w:R:xlvh")))
+	{
+		switch (opt)
+		{
+		case 'd':
+			duration_ms = strtoull(optarg, NULL, 10) * 1000ull;
+			break;
+		case 'p':
+			trace_ms = (uint32_t)(strtod(optarg, NULL) * 1000.0);
+			break;
+		case 'r':
+			snprintf(recipe_key, sizeof(recipe_key), ",%lu:rec%s", SIM_RECIPE_START_MS, optarg);
+			strncat(script, recipe_key, sizeof(script) - strlen(script) - 1);
+			break;
+		case 'e':
+			p_eeprom = optarg;
+			break;
+		case 's':
+			seed = strtoull(optarg, NULL, 10);
+			break;
+		case 'k':
+			snprintf(script, sizeof(script), "%s", optarg);
+			break;
+		case 'w':
+			p_record = optarg;
+			break;
+		case 'R':
+			p_replay = optarg;
+			break;
+		case 'x':
+			b_realtime = true;
+			break;
+		case 'l':
+			b_lcd = true;
+			break;
+		case 'v':
+			b_verbose = true;
+			break;
+		default:
+			sim_usage(argv[0]);
+			return (opt == 'h') ? 0 : 1;
+		}
+	}
+
+	/* Al reproducir las entradas y los comandos son los de la traza */
+	if (NULL != p_replay)
+	{
+		script[0] = '\0';
+	}
+
+	if (false == sim_script_parse(script))
+	{
+		fprintf(stderr, "sim: bad key script '%s'\n", script);
+		return 1;
+	}
+
+	sim_hal_init();
+	if (false == b_verbose)
+	{
+		sim_log_out = NULL;
+	}
+	if ((NULL != p_eeprom) && (false == sim_eeprom_load(p_eeprom)))
+	{
+		fprintf(stderr, "sim: %s not found, starting with a blank EEPROM\n", p_eeprom);
+	}
+
+	if ((NULL != p_record) && (false == trace_record_open(p_record)))
+	{
+		fprintf(stderr, "sim: could not create %s\n", p_record);
+		return 1;
+	}
+	if (NULL != p_replay)
+	{
+		if (false == trace_replay_open(p_replay, &replay_end_ms))
+		{
+			fprintf(stderr, "sim: could not load %s\n", p_replay);
+			return 1;
+		}
+		duration_ms = replay_end_ms;
+	}
+
+	plant_default_cfg(&plant_cfg);
+	plant_init(&plant, &plant_cfg, seed);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	app_init();
+
+	sim_trace_header(b_lcd);
+
+	for (now = 0; duration_ms > now; now++)
+	{
+		sim_script_run(now);
+
+		/* Salidas activas en bajo, como en la tabla de actuadores; el
+		 * calefactor se ve por el pin que conmuta TIM4. La válvula
+		 * energizada cierra el venteo. */
+		input.heater = (GPIO_PIN_RESET == sim_output_get(D4_GPIO_Port, D4_Pin));
+		input.cooler = (GPIO_PIN_RESET == sim_output_get(D5_GPIO_Port, D5_Pin));
+		input.pump = (GPIO_PIN_RESET == sim_output_get(D7_GPIO_Port, D7_Pin));
+		input.vent = (GPIO_PIN_SET == sim_output_get(D8_GPIO_Port, D8_Pin));
+		plant_step(&plant, &plant_cfg, &input, 0.001);
+
+		temp_raw = plant_temp_raw(&plant, &plant_cfg);
+		press_raw = plant_press_raw(&plant, &plant_cfg);
+		trace_inputs(now, &temp_raw, &press_raw);
+		sim_hal_tick(temp_raw, press_raw);
+
+		app_update();
+		app_idle();
+		trace_outputs(now);
+
+		if (b_realtime)
+		{
+			sim_realtime_wait(&start, now);
+		}
+
+		if ((0 != trace_ms) && (0 == (now % trace_ms)))
+		{
+			sim_trace(&plant, b_lcd);
+		}
+	}
+
+	if ((NULL != p_eeprom) && (false == sim_eeprom_save(p_eeprom)))
+	{
+		fprintf(stderr, "sim: could not write %s\n", p_eeprom);
+	}
+
+	if (false == trace_close(now, stderr))
+	{
+		if (NULL != p_record)
+		{
+			fprintf(stderr, "sim: could not write %s\n", p_record);
+		}
+		b_ok = false;
+	}
+
+	return b_ok ? 0 : 2;
+}
+
+/********************** internal functions definition ************************/
+
+static void sim_usage(const char *p_name)
+{
+	fprintf(stderr,
+			"usage: %s [-d seconds] [-p seconds] [-r slot] [-e eeprom.bin]\n"
+			"          [-s seed] [-k script] [-w trace] [-R trace] [-x] [-l] [-v]\n"
+			"  -d  simulated time (default %lu s)\n"
+			"  -p  trace period, 0 disables it (default %lu s)\n"
+			"  -r  start recipe slot 1..%u once the system is enabled\n"
+			"  -e  EEPROM image, loaded at start and written back at the end\n"
+			"  -s  noise seed\n"
+			"  -k  key script \"ms:key[/hold_ms],...\" (default \"%s\")\n"
+			"      keys: ent nex pre esc on off stats rec<n> pause abort\n"
+			"      buttons are held %lu ms unless hold_ms is given\n"
+			"  -w  record ADC samples, inputs, outputs and LCD lines to a trace\n"
+			"  -R  replay a trace instead of the plant and the script and diff\n"
+			"      the outputs against it, exits with 2 if they differ\n"
+			"  -x  pace the simulation to real time\n"
+			"  -l  add the LCD lines to the trace\n"
+			"  -v  print the application log to stderr\n",
+			p_name, SIM_DURATION_DEF_S, SIM_TRACE_PERIOD_DEF_S, (unsigned)RECIPE_SLOT_QTY, SIM_SCRIPT_DEF,
+			SIM_BUTTON_HOLD_MS);
+}
+
+static bool sim_script_parse(const char *p_script)
+{
+	const char *p = p_script;
+	char *p_end;
+	size_t len;
+
+	sim_key_qty = 0;
+	while ('\0' != *p)
+	{
+		if (SIM_KEY_MAX <= sim_key_qty)
+		{
+			return false;
+		}
+
+		sim_key_list[sim_key_qty].ms = (uint32_t)strtoul(p, &p_end, 10);
+		if ((p_end == p) || (':' != *p_end))
+		{
+			return false;
+		}
+		p = p_end + 1;
+
+		len = strcspn(p, ",/");
+		if ((0 == len) || (sizeof(sim_key_list[0].key) <= len))
+		{
+			return false;
+		}
+		memcpy(sim_key_list[sim_key_qty].key, p, len);
+		sim_key_list[sim_key_qty].key[len] = '\0';
+		sim_key_list[sim_key_qty].hold_ms = SIM_BUTTON_HOLD_MS;
+
+		p += len;
+		if ('/' == *p)
+		{
+			sim_key_list[sim_key_qty].hold_ms = (uint32_t)strtoul(p + 1, &p_end, 10);
+			if ((p_end == p + 1) || (0 == sim_key_list[sim_key_qty].hold_ms))
+			{
+				return false;
+			}
+			p = p_end;
+		}
+		sim_key_qty++;
+
+		if (',' == *p)
+		{
+			p++;
+		}
+	}
+
+	return true;
+}
+
+static void sim_script_run(uint32_t now)
+{
+	uint32_t index;
+	uint32_t button;
+	const char *p_key;
+
+	for (button = 0; SIM_BUTTON_QTY > button; button++)
+	{
+		if ((0 != sim_button_list[button].release_ms) && (now >= sim_button_list[button].release_ms))
+		{
+			sim_input_set(sim_button_list[button].port, sim_button_list[button].pin, GPIO_PIN_SET);
+			sim_button_list[button].release_ms = 0;
+		}
+	}
+
+	for (index = 0; sim_key_qty > index; index++)
+	{
+		if (sim_key_list[index].ms != now)
+		{
+			continue;
+		}
+		p_key = sim_key_list[index].key;
+
+		for (button = 0; SIM_BUTTON_QTY > button; button++)
+		{
+			if (0 == strcmp(p_key, sim_button_list[button].name))
+			{
+				sim_input_set(sim_button_list[button].port, sim_button_list[button].pin, GPIO_PIN_RESET);
+				sim_button_list[button].release_ms = now + sim_key_list[index].hold_ms;
+			}
+		}
+
+		if (0 == strcmp(p_key, "on"))
+		{
+			sim_input_set(SW_ENABLE_PORT, SW_ENABLE_PIN, SW_ENABLE_ON);
+		}
+		else if (0 == strcmp(p_key, "off"))
+		{
+			sim_input_set(SW_ENABLE_PORT, SW_ENABLE_PIN,
+						  (GPIO_PIN_SET == SW_ENABLE_ON) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+		}
+		/* Los comandos pasan por la traza para poder reproducirlos */
+		else if (0 == strcmp(p_key, "stats"))
+		{
+			trace_command(now, TRACE_CMD_UART_RX, 's');
+		}
+		else if (0 == strncmp(p_key, "rec", 3))
+		{
+			trace_command(now, TRACE_CMD_RECIPE, (uint32_t)atoi(&p_key[3]));
+		}
+		else if (0 == strcmp(p_key, "pause"))
+		{
+			trace_command(now, TRACE_CMD_PAUSE, 0);
+		}
+		else if (0 == strcmp(p_key, "abort"))
+		{
+			trace_command(now, TRACE_CMD_ABORT, 0);
+		}
+	}
+}
+
+static void sim_realtime_wait(const struct timespec *p_start, uint32_t now)
+{
+	struct timespec until = *p_start;
+	uint64_t ns = (uint64_t)until.tv_nsec + (uint64_t)(now + 1) * 1000000ull;
+
+	until.tv_sec += (time_t)(ns / 1000000000ull);
+	until.tv_nsec = (long)(ns % 1000000000ull);
+	clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL);
+}
+
+static void sim_trace_header(bool b_lcd)
+{
+	printf("t_s,temp_c,press_kpa,temp_meas,press_meas,temp_sp,press_sp,heater_pct,cooler,pump,vent,recipe_seg%s\n",
+		   b_lcd ? ",lcd0,lcd1" : "");
+}
+
+// Las mediciones y los setpoints salen de los snapshots, como los leen las tareas
+static void sim_trace(const plant_state_t *p_plant, bool b_lcd)
+{
+	sensor_frame_t frame;
+	system_config_t cfg;
+	setpoint_frame_t setpoint;
+	recipe_status_t recipe;
+	uint32_t temp_sp;
+	uint32_t press_sp;
+
+	snapshot_read(&shared_data.sensor, &frame);
+	snapshot_read(&shared_data.cfg, &cfg);
+	snapshot_read(&shared_data.setpoint, &setpoint);
+	task_recipe_get_status(&recipe);
+
+	temp_sp = setpoint.active ? setpoint.temp : cfg.temp_setpoint;
+	press_sp = setpoint.active ? setpoint.press : cfg.press_setpoint;
+
+	printf("%.1f,%.2f,%.2f,%.1f,%.1f,%.1f,%.1f,%.1f,%d,%d,%d,%d",
+		   sim_time_ms() / 1000.0, p_plant->temp, p_plant->press,
+		   frame.temp / 10.0, frame.press / 10.0, temp_sp / 10.0, press_sp / 10.0,
+		   pwm_get_duty(PWM_ID_HEATER) / 10.0,
+		   GPIO_PIN_RESET == sim_output_get(D5_GPIO_Port, D5_Pin),
+		   GPIO_PIN_RESET == sim_output_get(D7_GPIO_Port, D7_Pin),
+		   GPIO_PIN_SET == sim_output_get(D8_GPIO_Port, D8_Pin),
+		   recipe.running ? (int)recipe.segment + 1 : 0);
+
+	if (b_lcd)
+	{
+		printf(",\"%s\",\"%s\"", sim_lcd_line(0), sim_lcd_line(1));
+	}
+	printf("\n");
+}
+
+/********************** end of file ******************************************/
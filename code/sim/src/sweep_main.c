@@ -0,0 +1,298 @@
+/*
+ * @file   : sweep_main.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ *
+ * Barrido Monte Carlo del control: sortea los parámetros de cada corrida
+ * dentro de rangos, las reparte entre todos los núcleos y escribe una fila
+ * CSV por corrida con sus parámetros y resultados.
+ */
+
+/********************** inclusions *******************************************/
+#include "pool.h"
+#include "sweep.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/********************** macros and definitions *******************************/
+#define SWEEP_RUNS_DEF			1000ul
+#define SWEEP_DURATION_DEF_S	7200ul
+#define SWEEP_SEED_DEF			1ull
+
+typedef struct
+{
+	const char *name;
+	double min;
+	double max;
+} sweep_range_t;
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+static void sweep_usage(const char *p_name);
+static bool sweep_range_parse(const char *p_arg);
+static uint64_t sweep_rand(uint64_t *p_state);
+static void sweep_job(uint32_t index, uint32_t worker, void *p_arg);
+
+/********************** internal data definition *****************************/
+
+/* Los fijos (min == max) son los valores de plant_default_cfg() y los _INI
+ * de task_menu.c; los demás quedan alrededor de ellos */
+static sweep_range_t sweep_range_list[SWEEP_VAR_QTY] = {
+	[SWEEP_VAR_HEATER_W]	= {"heater_w",		160.0,	240.0},
+	[SWEEP_VAR_HEAT_CAP]	= {"heat_cap",		1500.0,	2500.0},
+	[SWEEP_VAR_LEAK_RATE]	= {"leak_rate",		0.02,	0.10},
+	[SWEEP_VAR_TEMP_NOISE]	= {"temp_noise",	0.05,	0.30},
+	[SWEEP_VAR_PRESS_NOISE]	= {"press_noise",	0.05,	0.30},
+	[SWEEP_VAR_TEMP_HYST]	= {"temp_hyst",		0.5,	5.0},
+	[SWEEP_VAR_PRESS_HYST]	= {"press_hyst",	0.5,	3.0},
+	[SWEEP_VAR_KP]			= {"kp",			10.0,	10.0},
+	[SWEEP_VAR_KI]			= {"ki",			0.2,	0.2},
+	[SWEEP_VAR_KD]			= {"kd",			0.0,	0.0},
+};
+
+static sweep_param_t *p_sweep_param_list;
+static sweep_result_t *p_sweep_result_list;
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+
+int main(int argc, char *argv[])
+{
+	sweep_param_t base = {
+		.b_pid = false,
+		.temp_setpoint = 70.0,
+		.press_setpoint = 10.0,
+		.temp_alarm = 75.0,
+		.press_alarm = 108.0,
+		.temp_band = 3.0,
+		.press_band = 2.0,
+		.duration_ms = SWEEP_DURATION_DEF_S * 1000ul,
+	};
+	uint32_t run_qty = SWEEP_RUNS_DEF;
+	long worker_qty = sysconf(_SC_NPROCESSORS_ONLN);
+	uint64_t seed = SWEEP_SEED_DEF;
+	bool b_verbose = false;
+	uint32_t run;
+	uint32_t var;
+	uint32_t worker;
+	int opt;
+
+	while (-1 != (opt = getopt(argc, argv, "n:j:s:d:t:p:T:P:B:b:mV:vh")))
+	{
+		switch (opt)
+		{
+		case 'n':
+			run_qty = (uint32_t)strtoul(optarg, NULL, 10);
+			break;
+		case 'j':
+			worker_qty = strtol(optarg, NULL, 10);
+			break;
+		case 's':
+			seed = strtoull(optarg, NULL, 10);
+			break;
+		case 'd':
+			base.duration_ms = (uint32_t)(strtoul(optarg, NULL, 10) * 1000ul);
+			break;
+		case 't':
+			base.temp_setpoint = strtod(optarg, NULL);
+			break;
+		case 'p':
+			base.press_setpoint = strtod(optarg, NULL);
+			break;
+		case 'T':
+			base.temp_alarm = strtod(optarg, NULL);
+			break;
+		case 'P':
+			base.press_alarm = strtod(optarg, NULL);
+			break;
+		case 'B':
+			base.temp_band = strtod(optarg, NULL);
+			break;
+		case 'b':
+			base.press_band = strtod(optarg, NULL);
+			break;
+		case 'm':
+			base.b_pid = true;
+			break;
+		case 'V':
+			if (false == sweep_range_parse(optarg))
+			{
+				fprintf(stderr, "sweep: bad range '%s'\n", optarg);
+				return 1;
+			}
+			break;
+		case 'v':
+			b_verbose = true;
+			break;
+		default:
+			sweep_usage(argv[0]);
+			return (opt == 'h') ? 0 : 1;
+		}
+	}
+
+	if (1 > worker_qty)
+	{
+		worker_qty = 1;
+	}
+
+	p_sweep_param_list = calloc(run_qty, sizeof(sweep_param_t));
+	p_sweep_result_list = calloc(run_qty, sizeof(sweep_result_t));
+	if ((NULL == p_sweep_param_list) || (NULL == p_sweep_result_list))
+	{
+		fprintf(stderr, "sweep: out of memory\n");
+		return 1;
+	}
+
+	/* Los sorteos se hacen antes de repartir: el resultado no depende de
+	 * cuántos hilos haya ni de quién corra cada corrida */
+	for (run = 0; run_qty > run; run++)
+	{
+		p_sweep_param_list[run] = base;
+		for (var = 0; SWEEP_VAR_QTY > var; var++)
+		{
+			p_sweep_param_list[run].value[var] = sweep_range_list[var].min
+					+ (sweep_range_list[var].max - sweep_range_list[var].min)
+					* ((sweep_rand(&seed) >> 11) * (1.0 / 9007199254740992.0));
+		}
+		p_sweep_param_list[run].seed = sweep_rand(&seed);
+	}
+
+	if (false == pool_run(run_qty, (uint32_t)worker_qty, sweep_job, NULL))
+	{
+		fprintf(stderr, "sweep: could not start every worker thread\n");
+	}
+
+	printf("run");
+	for (var = 0; SWEEP_VAR_QTY > var; var++)
+	{
+		printf(",%s", sweep_range_list[var].name);
+	}
+	printf(",temp_overshoot,temp_settle_s,temp_final,press_undershoot,press_settle_s,press_final,"
+		   "heater_starts,cooler_starts,pump_starts,valve_starts,alarm_trips\n");
+
+	for (run = 0; run_qty > run; run++)
+	{
+		const sweep_result_t *p_result = &p_sweep_result_list[run];
+
+		printf("%u", (unsigned)run);
+		for (var = 0; SWEEP_VAR_QTY > var; var++)
+		{
+			printf(",%.4g", p_sweep_param_list[run].value[var]);
+		}
+		printf(",%.2f,%.1f,%.2f,%.2f,%.1f,%.2f,%u,%u,%u,%u,%u\n",
+			   p_result->temp_overshoot, p_result->temp_settle_s, p_result->temp_final,
+			   p_result->press_undershoot, p_result->press_settle_s, p_result->press_final,
+			   (unsigned)p_result->heater_starts, (unsigned)p_result->cooler_starts,
+			   (unsigned)p_result->pump_starts, (unsigned)p_result->valve_starts,
+			   (unsigned)p_result->alarm_trips);
+	}
+
+	if (b_verbose)
+	{
+		for (worker = 0; (uint32_t)worker_qty > worker; worker++)
+		{
+			fprintf(stderr, "sweep: worker %u stole %u runs\n",
+					(unsigned)worker, (unsigned)pool_steal_count(worker));
+		}
+	}
+
+	free(p_sweep_param_list);
+	free(p_sweep_result_list);
+
+	return 0;
+}
+
+/********************** internal functions definition ************************/
+
+static void sweep_usage(const char *p_name)
+{
+	uint32_t var;
+
+	fprintf(stderr,
+			"usage: %s [-n runs] [-j threads] [-s seed] [-d seconds] [-m]\n"
+			"          [-t temp_sp] [-p press_sp] [-T temp_alarm] [-P press_alarm]\n"
+			"          [-B temp_band] [-b press_band] [-V name=min:max]... [-v]\n"
+			"  -n  simulations (default %lu)\n"
+			"  -j  worker threads (default: online CPUs)\n"
+			"  -s  seed for the parameter draws and the sensor noise\n"
+			"  -d  simulated time per run (default %lu s)\n"
+			"  -m  temperature by PID instead of hysteresis\n"
+			"  -t/-p  setpoints stepped to at t = 0 (default 70 C, 10 kPa)\n"
+			"  -T/-P  alarm limits (default 75 C, 108 kPa)\n"
+			"  -B/-b  settling bands (default 3 C, 2 kPa)\n"
+			"  -V  uniform range of a parameter, min == max fixes it\n"
+			"  -v  print how many runs each worker stole\n"
+			"parameters:\n",
+			p_name, SWEEP_RUNS_DEF, SWEEP_DURATION_DEF_S);
+
+	for (var = 0; SWEEP_VAR_QTY > var; var++)
+	{
+		fprintf(stderr, "  %-12s %g:%g\n", sweep_range_list[var].name,
+				sweep_range_list[var].min, sweep_range_list[var].max);
+	}
+}
+
+static bool sweep_range_parse(const char *p_arg)
+{
+	const char *p_eq = strchr(p_arg, '=');
+	char *p_end;
+	double min;
+	double max;
+	uint32_t var;
+
+	if (NULL == p_eq)
+	{
+		return false;
+	}
+
+	min = strtod(p_eq + 1, &p_end);
+	if (':' == *p_end)
+	{
+		max = strtod(p_end + 1, &p_end);
+	}
+	else
+	{
+		max = min;
+	}
+	if (('\0' != *p_end) || (max < min))
+	{
+		return false;
+	}
+
+	for (var = 0; SWEEP_VAR_QTY > var; var++)
+	{
+		if ((strlen(sweep_range_list[var].name) == (size_t)(p_eq - p_arg))
+				&& (0 == strncmp(p_arg, sweep_range_list[var].name, p_eq - p_arg)))
+		{
+			sweep_range_list[var].min = min;
+			sweep_range_list[var].max = max;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// splitmix64, para sortear y para sembrar el ruido de cada corrida
+static uint64_t sweep_rand(uint64_t *p_state)
+{
+	uint64_t z = (*p_state += 0x9E3779B97F4A7C15ull);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+	return z ^ (z >> 31);
+}
+
+static void sweep_job(uint32_t index, uint32_t worker, void *p_arg)
+{
+	sweep_run(&p_sweep_param_list[index], &p_sweep_result_list[index]);
+}
+
+/********************** end of file ******************************************/
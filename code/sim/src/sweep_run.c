@@ -0,0 +1,314 @@
+/*
+ * @file   : sweep_run.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ *
+ * Acá se definen las funciones que los statecharts de temperatura y presión
+ * usan para mover los actuadores (pwm.c, task_actuator) y avisar al menú.
+ * Escriben en el contexto de la corrida del hilo que las llama.
+ */
+
+/********************** inclusions *******************************************/
+#include "main.h"
+#include "logger.h"
+
+#include "app.h"
+#include "task_temp.h"
+#include "task_temp_attribute.h"
+#include "task_press.h"
+#include "task_press_attribute.h"
+#include "task_actuator.h"
+#include "task_actuator_attribute.h"
+#include "task_actuator_interface.h"
+#include "task_menu_attribute.h"
+#include "task_menu_interface.h"
+#include "task_adc.h"
+#include "adc_filter.h"
+#include "pwm.h"
+#include "utils.h"
+
+#include "plant.h"
+#include "sweep.h"
+
+/********************** macros and definitions *******************************/
+
+/* Cada medio buffer del DMA junta ADC_OVERSAMPLE scans de 1 ms, con los
+ * canales intercalados como en el scan del firmware */
+#define SWEEP_ADC_TEMP_IDX		0
+#define SWEEP_ADC_PRESS_IDX		1
+#define SWEEP_ADC_READINGS		2
+
+#define SWEEP_DECI(x)			((uint32_t)((x) * 10.0 + 0.5))
+
+typedef struct
+{
+	uint32_t heater_duty;		// [0.1 %]
+	bool act_on[ID_ACT_QTY];
+	uint32_t start_cnt[ID_ACT_QTY];
+} sweep_ctx_t;
+
+/* Banda de asentamiento: último instante fuera y valor extremo */
+typedef struct
+{
+	uint32_t out_ms;
+	bool b_out;
+	double peak;
+} sweep_settle_t;
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+static void sweep_cfg(const sweep_param_t *p_param, plant_cfg_t *p_plant, system_config_t *p_cfg);
+static bool sweep_alarm(const system_config_t *p_cfg, uint32_t temp, uint32_t press);
+static void sweep_settle(sweep_settle_t *p_settle, double error, double band, uint32_t now);
+static double sweep_settle_s(const sweep_settle_t *p_settle);
+
+/********************** internal data definition *****************************/
+static _Thread_local sweep_ctx_t *p_sweep_ctx;
+
+/********************** external data declaration ****************************/
+
+/* Los usan task_temp_update() y las funciones de init, que el barrido no
+ * llama, pero están en los mismos objetos */
+uint32_t g_app_tick;
+
+static char logger_msg_buffer_[LOGGER_CONFIG_MAXLEN];
+char* const logger_msg = logger_msg_buffer_;
+int logger_msg_len;
+
+/********************** external functions definition ************************/
+
+void sweep_run(const sweep_param_t *p_param, sweep_result_t *p_result)
+{
+	sweep_ctx_t ctx = {0};
+	task_temp_dta_t temp_dta = {ST_TEMP_OFF, EV_TEMP_ENABLE_ON, true, {0}, {0}};
+	task_press_dta_t press_dta = {ST_PRESS_OFF, EV_PRESS_ENABLE_ON, true};
+	plant_cfg_t plant_cfg;
+	plant_state_t plant;
+	plant_input_t input;
+	system_config_t cfg;
+	sweep_settle_t temp_settle = {0, true, 0.0};
+	sweep_settle_t press_settle = {0, true, 0.0};
+	uint16_t adc_block[ADC_OVERSAMPLE * SWEEP_ADC_READINGS];
+	adc_filter_dta_t temp_filter;
+	adc_filter_dta_t press_filter;
+	uint32_t adc_block_cnt = 0;
+	uint32_t scan;
+	uint32_t temp_raw;
+	uint32_t press_raw;
+	uint32_t temp = 0;
+	uint32_t press = 0;
+	bool b_frame = false;
+	bool b_alarm = false;
+	uint32_t alarm_trips = 0;
+	uint32_t now;
+
+	p_sweep_ctx = &ctx;
+
+	sweep_cfg(p_param, &plant_cfg, &cfg);
+	plant_init(&plant, &plant_cfg, p_param->seed);
+	adc_filter_reset(&temp_filter, ADC_TEMP_FILTER);
+	adc_filter_reset(&press_filter, ADC_PRESS_FILTER);
+
+	for (now = 0; p_param->duration_ms > now; now++)
+	{
+		/* Bloque decimado cada ADC_OVERSAMPLE ms con los filtros del
+		 * firmware, que tampoco publica hasta que se asientan */
+		scan = now % ADC_OVERSAMPLE;
+		adc_block[scan * SWEEP_ADC_READINGS + SWEEP_ADC_TEMP_IDX] = plant_temp_raw(&plant, &plant_cfg);
+		adc_block[scan * SWEEP_ADC_READINGS + SWEEP_ADC_PRESS_IDX] = plant_press_raw(&plant, &plant_cfg);
+		if ((ADC_OVERSAMPLE - 1) == scan)
+		{
+			temp_raw = adc_filter_block(&temp_filter, &adc_block[SWEEP_ADC_TEMP_IDX], SWEEP_ADC_READINGS);
+			press_raw = adc_filter_block(&press_filter, &adc_block[SWEEP_ADC_PRESS_IDX], SWEEP_ADC_READINGS);
+			if (ADC_FILTER_SETTLE_BLOCKS > adc_block_cnt)
+			{
+				adc_block_cnt++;
+			}
+			else
+			{
+				temp = temp_raw_to_deci_celsius(temp_raw);
+				press = press_raw_to_deci_kPa(press_raw);
+				b_frame = true;
+			}
+		}
+
+		/* Hasta la primera medición las tareas no tienen con qué decidir */
+		if (b_frame && (0 == (now % TASK_TEMP_PERIOD)))
+		{
+			task_temp_statechart(&temp_dta, &cfg, temp, now);
+		}
+		if (b_frame && (0 == (now % TASK_PRESS_PERIOD)))
+		{
+			task_press_statechart(&press_dta, &cfg, press);
+
+			/* La alarma se cuenta pero no apaga nada, para ver todas */
+			if (sweep_alarm(&cfg, temp, press) && (false == b_alarm))
+			{
+				alarm_trips++;
+			}
+			b_alarm = sweep_alarm(&cfg, temp, press);
+		}
+
+		/* Válvula energizada: venteo cerrado */
+		input.heater = ctx.heater_duty / (double)PWM_DUTY_MAX;
+		input.cooler = ctx.act_on[ID_ACT_COOLER];
+		input.pump = ctx.act_on[ID_ACT_PUMP];
+		input.vent = !ctx.act_on[ID_ACT_VALVE];
+		plant_step(&plant, &plant_cfg, &input, 0.001);
+
+		sweep_settle(&temp_settle, plant.temp - p_param->temp_setpoint, p_param->temp_band, now);
+		sweep_settle(&press_settle, p_param->press_setpoint - plant.press, p_param->press_band, now);
+	}
+
+	p_result->temp_overshoot = temp_settle.peak;
+	p_result->temp_settle_s = sweep_settle_s(&temp_settle);
+	p_result->temp_final = plant.temp;
+	p_result->press_undershoot = press_settle.peak;
+	p_result->press_settle_s = sweep_settle_s(&press_settle);
+	p_result->press_final = plant.press;
+	p_result->heater_starts = ctx.start_cnt[ID_ACT_HEATER];
+	p_result->cooler_starts = ctx.start_cnt[ID_ACT_COOLER];
+	p_result->pump_starts = ctx.start_cnt[ID_ACT_PUMP];
+	p_result->valve_starts = ctx.start_cnt[ID_ACT_VALVE];
+	p_result->alarm_trips = alarm_trips;
+
+	p_sweep_ctx = NULL;
+}
+
+/* ---------------------------------------------------------------------------
+ * Lo que en el firmware hacen pwm.c y las demás tareas
+ * ------------------------------------------------------------------------- */
+
+void pwm_set_duty(pwm_id_t id, uint32_t duty)
+{
+	if (PWM_ID_HEATER != id)
+	{
+		return;
+	}
+	if (PWM_DUTY_MAX < duty)
+	{
+		duty = PWM_DUTY_MAX;
+	}
+	if ((0 == p_sweep_ctx->heater_duty) && (0 != duty))
+	{
+		p_sweep_ctx->start_cnt[ID_ACT_HEATER]++;
+	}
+	p_sweep_ctx->heater_duty = duty;
+}
+
+uint32_t pwm_get_duty(pwm_id_t id)
+{
+	return (PWM_ID_HEATER == id) ? p_sweep_ctx->heater_duty : 0;
+}
+
+// Sin los tiempos mínimos de task_actuator: la orden se cumple en el momento
+void put_event_task_actuator(task_actuator_ev_t event, task_actuator_id_t identifier)
+{
+	bool b_on = (EV_ACT_XX_ON == event);
+
+	if (ID_ACT_HEATER == identifier)
+	{
+		pwm_set_duty(PWM_ID_HEATER, b_on ? PWM_DUTY_MAX : 0);
+		return;
+	}
+	if (ID_ACT_QTY <= identifier)
+	{
+		return;
+	}
+	if (b_on && (false == p_sweep_ctx->act_on[identifier]))
+	{
+		p_sweep_ctx->start_cnt[identifier]++;
+	}
+	p_sweep_ctx->act_on[identifier] = b_on;
+}
+
+void put_duty_task_actuator(uint32_t duty, task_actuator_id_t identifier)
+{
+	if (ID_ACT_HEATER == identifier)
+	{
+		pwm_set_duty(PWM_ID_HEATER, duty);
+	}
+}
+
+bool task_actuator_is_safe(void)
+{
+	return false;
+}
+
+void put_event_task_menu(task_menu_ev_t event)
+{
+}
+
+void logger_log_print_(char* const msg)
+{
+}
+
+/********************** internal functions definition ************************/
+
+static void sweep_cfg(const sweep_param_t *p_param, plant_cfg_t *p_plant, system_config_t *p_cfg)
+{
+	const double *p_value = p_param->value;
+
+	plant_default_cfg(p_plant);
+	p_plant->heater_w = p_value[SWEEP_VAR_HEATER_W];
+	p_plant->heat_cap = p_value[SWEEP_VAR_HEAT_CAP];
+	p_plant->leak_rate = p_value[SWEEP_VAR_LEAK_RATE];
+	p_plant->temp_noise = p_value[SWEEP_VAR_TEMP_NOISE];
+	p_plant->press_noise = p_value[SWEEP_VAR_PRESS_NOISE];
+
+	memset(p_cfg, 0, sizeof(*p_cfg));
+	p_cfg->version = SYSTEM_CONFIG_VERSION;
+	p_cfg->temp_setpoint = SWEEP_DECI(p_param->temp_setpoint);
+	p_cfg->temp_hysteresis = SWEEP_DECI(p_value[SWEEP_VAR_TEMP_HYST]);
+	p_cfg->temp_alarm_limit = SWEEP_DECI(p_param->temp_alarm);
+	p_cfg->temp_mode = p_param->b_pid ? CTRL_MODE_PID : CTRL_MODE_ONOFF;
+	p_cfg->temp_kp = SWEEP_DECI(p_value[SWEEP_VAR_KP]);
+	p_cfg->temp_ki = SWEEP_DECI(p_value[SWEEP_VAR_KI]);
+	p_cfg->temp_kd = SWEEP_DECI(p_value[SWEEP_VAR_KD]);
+	p_cfg->press_setpoint = SWEEP_DECI(p_param->press_setpoint);
+	p_cfg->press_hysteresis = SWEEP_DECI(p_value[SWEEP_VAR_PRESS_HYST]);
+	p_cfg->press_alarm_limit = SWEEP_DECI(p_param->press_alarm);
+	p_cfg->alarm_enabled = true;
+}
+
+// La misma condición que evalúa task_system
+static bool sweep_alarm(const system_config_t *p_cfg, uint32_t temp, uint32_t press)
+{
+	bool b_alarm = false;
+
+	if (p_cfg->temp_alarm_limit > p_cfg->temp_setpoint)
+		b_alarm |= (temp > p_cfg->temp_alarm_limit);
+	else
+		b_alarm |= (temp < p_cfg->temp_alarm_limit);
+
+	if (p_cfg->press_alarm_limit > p_cfg->press_setpoint)
+		b_alarm |= (press > p_cfg->press_alarm_limit);
+	else
+		b_alarm |= (press < p_cfg->press_alarm_limit);
+
+	return b_alarm;
+}
+
+// error positivo es pasarse del setpoint en el sentido del escalón
+static void sweep_settle(sweep_settle_t *p_settle, double error, double band, uint32_t now)
+{
+	if (error > p_settle->peak)
+	{
+		p_settle->peak = error;
+	}
+
+	p_settle->b_out = (error > band) || (error < -band);
+	if (p_settle->b_out)
+	{
+		p_settle->out_ms = now;
+	}
+}
+
+static double sweep_settle_s(const sweep_settle_t *p_settle)
+{
+	return p_settle->b_out ? -1.0 : (p_settle->out_ms + 1) / 1000.0;
+}
+
+/********************** end of file ******************************************/
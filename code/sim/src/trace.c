@@ -0,0 +1,625 @@
+/*
+ * @file   : trace.c
+ * @date   : Oct 17, 2026
+ * @author : Franco Berni <fberni@fi.uba.ar>
+ * @version	v1.0.0
+ */
+
+/********************** inclusions *******************************************/
+#include "main.h"
+#include "sim.h"
+#include "trace.h"
+
+#include "board.h"
+#include "pwm.h"
+#include "task_recipe.h"
+#include "task_recipe_attribute.h"
+#include "task_recipe_interface.h"
+
+#include <stdlib.h>
+
+/********************** macros and definitions *******************************/
+#define TRACE_LINE_MAX		(128)
+#define TRACE_LIST_INI		(4096u)
+
+#define TRACE_KIND_ADC		'A'
+#define TRACE_KIND_IN		'I'
+#define TRACE_KIND_OUT		'O'
+#define TRACE_KIND_CMD		'C'
+#define TRACE_KIND_LCD		'D'
+#define TRACE_KIND_END		'E'
+
+typedef struct
+{
+	uint32_t ms;
+	char kind;
+	uint8_t id;					// Pin o comando de la tabla, o fila del LCD
+	uint32_t value[2];			// Nivel, duty, argumento o las dos lecturas del ADC
+	char text[SIM_LCD_COLS + 1];
+} trace_event_t;
+
+typedef struct
+{
+	const char *name;
+	GPIO_TypeDef *port;
+	uint16_t pin;
+} trace_pin_t;
+
+/********************** internal data declaration ****************************/
+
+/********************** internal functions declaration ***********************/
+static void trace_emit(const trace_event_t *p_event);
+static bool trace_equal(const trace_event_t *p_a, const trace_event_t *p_b);
+static void trace_format(const trace_event_t *p_event, char *p_line, size_t size);
+static bool trace_parse(const char *p_line, trace_event_t *p_event);
+static bool trace_parse_text(const char *p, char *p_text);
+static int trace_find(const trace_pin_t *p_list, size_t qty, const char *p_name);
+static void trace_command_exec(trace_cmd_t cmd, uint32_t value);
+
+/********************** internal data definition *****************************/
+
+/* Entradas y salidas en el orden en que se anotan dentro de un mismo ms */
+static const trace_pin_t trace_in_list[] = {
+	{"ent", BTN_ENT_PORT, BTN_ENT_PIN},
+	{"nex", BTN_NEX_PORT, BTN_NEX_PIN},
+	{"pre", BTN_PRE_PORT, BTN_PRE_PIN},
+	{"esc", BTN_ESC_PORT, BTN_ESC_PIN},
+	{"sw",  SW_ENABLE_PORT, SW_ENABLE_PIN},
+};
+
+static const trace_pin_t trace_out_list[] = {
+	{"pump",   D7_GPIO_Port, D7_Pin},
+	{"valve",  D8_GPIO_Port, D8_Pin},
+	{"cooler", D5_GPIO_Port, D5_Pin},
+	{"buzzer", D2_GPIO_Port, D2_Pin},
+	{"heater", NULL, 0},			// PWM, value es el duty
+};
+
+/* Mismo orden que trace_cmd_t, no tienen pin */
+static const trace_pin_t trace_cmd_list[TRACE_CMD_QTY] = {
+	[TRACE_CMD_RECIPE]	= {"rec",   NULL, 0},
+	[TRACE_CMD_PAUSE]	= {"pause", NULL, 0},
+	[TRACE_CMD_ABORT]	= {"abort", NULL, 0},
+	[TRACE_CMD_UART_RX]	= {"rx",    NULL, 0},
+};
+
+#define TRACE_IN_QTY	(sizeof(trace_in_list)/sizeof(trace_in_list[0]))
+#define TRACE_OUT_QTY	(sizeof(trace_out_list)/sizeof(trace_out_list[0]))
+#define TRACE_HEATER	(TRACE_OUT_QTY - 1)
+
+static FILE *p_trace_file;
+static bool b_trace_replay;
+
+/* Último valor anotado de cada señal */
+static uint32_t trace_in_last[TRACE_IN_QTY];
+static uint32_t trace_out_last[TRACE_OUT_QTY];
+static uint32_t trace_adc_last[2];
+static char trace_lcd_last[SIM_LCD_ROWS][SIM_LCD_COLS + 1];
+static bool b_trace_lcd_known;
+
+/* Reproducción: la traza entera en memoria, con un cursor para las
+ * entradas y otro para las salidas esperadas */
+static trace_event_t *p_trace_list;
+static uint32_t trace_qty;
+static uint32_t trace_in_idx;
+static uint32_t trace_out_idx;
+static uint32_t trace_match_cnt;
+static bool b_trace_diverged;
+static trace_event_t trace_expected;
+static trace_event_t trace_got;
+static bool b_trace_missing;		// Se esperaba algo y no vino nada
+static bool b_trace_extra;			// Vino algo que no se esperaba
+
+/********************** external data declaration ****************************/
+
+/********************** external functions definition ************************/
+
+bool trace_record_open(const char *path)
+{
+	p_trace_file = fopen(path, "w");
+	if (NULL == p_trace_file)
+	{
+		return false;
+	}
+
+	b_trace_replay = false;
+	memset(trace_in_last, 0xFF, sizeof(trace_in_last));
+	memset(trace_out_last, 0xFF, sizeof(trace_out_last));
+	memset(trace_adc_last, 0xFF, sizeof(trace_adc_last));
+	b_trace_lcd_known = false;
+
+	fprintf(p_trace_file, "# sim trace v1\n");
+
+	return true;
+}
+
+bool trace_replay_open(const char *path, uint32_t *p_end_ms)
+{
+	FILE *p_file = fopen(path, "r");
+	char line[TRACE_LINE_MAX];
+	uint32_t line_num = 0;
+	uint32_t size = TRACE_LIST_INI;
+	trace_event_t event;
+
+	if (NULL == p_file)
+	{
+		return false;
+	}
+
+	p_trace_list = malloc(size * sizeof(trace_event_t));
+	trace_qty = 0;
+	*p_end_ms = 0;
+
+	while ((NULL != p_trace_list) && (NULL != fgets(line, sizeof(line), p_file)))
+	{
+		line_num++;
+		if (('#' == line[0]) || ('\n' == line[0]))
+		{
+			continue;
+		}
+		if (false == trace_parse(line, &event))
+		{
+			fprintf(stderr, "trace: %s:%u: bad line\n", path, (unsigned)line_num);
+			fclose(p_file);
+			return false;
+		}
+		if (trace_qty == size)
+		{
+			size *= 2;
+			p_trace_list = realloc(p_trace_list, size * sizeof(trace_event_t));
+			if (NULL == p_trace_list)
+			{
+				break;
+			}
+		}
+		p_trace_list[trace_qty++] = event;
+		*p_end_ms = event.ms;
+	}
+	fclose(p_file);
+
+	if (NULL == p_trace_list)
+	{
+		fprintf(stderr, "trace: out of memory\n");
+		return false;
+	}
+
+	b_trace_replay = true;
+	trace_in_idx = 0;
+	trace_out_idx = 0;
+	trace_match_cnt = 0;
+	b_trace_diverged = false;
+	memset(trace_out_last, 0xFF, sizeof(trace_out_last));
+	memset(trace_adc_last, 0, sizeof(trace_adc_last));
+	b_trace_lcd_known = false;
+
+	return true;
+}
+
+void trace_inputs(uint32_t now, uint16_t *p_temp_raw, uint16_t *p_press_raw)
+{
+	trace_event_t event = {0};
+	const trace_event_t *p_event;
+	uint32_t index;
+
+	if (b_trace_replay)
+	{
+		for (; (trace_qty > trace_in_idx) && (now >= p_trace_list[trace_in_idx].ms); trace_in_idx++)
+		{
+			p_event = &p_trace_list[trace_in_idx];
+			if (TRACE_KIND_ADC == p_event->kind)
+			{
+				trace_adc_last[0] = p_event->value[0];
+				trace_adc_last[1] = p_event->value[1];
+			}
+			else if (TRACE_KIND_IN == p_event->kind)
+			{
+				sim_input_set(trace_in_list[p_event->id].port, trace_in_list[p_event->id].pin,
+							  p_event->value[0] ? GPIO_PIN_SET : GPIO_PIN_RESET);
+			}
+			else if (TRACE_KIND_CMD == p_event->kind)
+			{
+				trace_command_exec((trace_cmd_t)p_event->id, p_event->value[0]);
+			}
+		}
+		*p_temp_raw = (uint16_t)trace_adc_last[0];
+		*p_press_raw = (uint16_t)trace_adc_last[1];
+		return;
+	}
+
+	if (NULL == p_trace_file)
+	{
+		return;
+	}
+
+	event.ms = now;
+	event.kind = TRACE_KIND_IN;
+	for (index = 0; TRACE_IN_QTY > index; index++)
+	{
+		event.id = (uint8_t)index;
+		event.value[0] = HAL_GPIO_ReadPin(trace_in_list[index].port, trace_in_list[index].pin);
+		if (event.value[0] != trace_in_last[index])
+		{
+			trace_in_last[index] = event.value[0];
+			trace_emit(&event);
+		}
+	}
+
+	if ((*p_temp_raw != trace_adc_last[0]) || (*p_press_raw != trace_adc_last[1]))
+	{
+		event.kind = TRACE_KIND_ADC;
+		event.id = 0;
+		event.value[0] = trace_adc_last[0] = *p_temp_raw;
+		event.value[1] = trace_adc_last[1] = *p_press_raw;
+		trace_emit(&event);
+	}
+}
+
+void trace_command(uint32_t now, trace_cmd_t cmd, uint32_t value)
+{
+	trace_event_t event = {0};
+
+	if ((NULL != p_trace_file) && (false == b_trace_replay))
+	{
+		event.ms = now;
+		event.kind = TRACE_KIND_CMD;
+		event.id = (uint8_t)cmd;
+		event.value[0] = value;
+		trace_emit(&event);
+	}
+
+	trace_command_exec(cmd, value);
+}
+
+void trace_outputs(uint32_t now)
+{
+	trace_event_t event = {0};
+	uint32_t index;
+	uint8_t row;
+
+	if ((NULL == p_trace_file) && (false == b_trace_replay))
+	{
+		return;
+	}
+
+	event.ms = now;
+	event.kind = TRACE_KIND_OUT;
+	for (index = 0; TRACE_OUT_QTY > index; index++)
+	{
+		event.id = (uint8_t)index;
+		event.value[0] = (TRACE_HEATER == index)
+				? pwm_get_duty(PWM_ID_HEATER)
+				: (uint32_t)sim_output_get(trace_out_list[index].port, trace_out_list[index].pin);
+		if (event.value[0] != trace_out_last[index])
+		{
+			trace_out_last[index] = event.value[0];
+			trace_emit(&event);
+		}
+	}
+
+	event.kind = TRACE_KIND_LCD;
+	event.value[0] = 0;
+	for (row = 0; SIM_LCD_ROWS > row; row++)
+	{
+		if (b_trace_lcd_known && (0 == strcmp(trace_lcd_last[row], sim_lcd_line(row))))
+		{
+			continue;
+		}
+		event.id = row;
+		snprintf(event.text, sizeof(event.text), "%s", sim_lcd_line(row));
+		snprintf(trace_lcd_last[row], sizeof(trace_lcd_last[row]), "%s", event.text);
+		trace_emit(&event);
+	}
+	b_trace_lcd_known = true;
+}
+
+bool trace_close(uint32_t now, FILE *p_out)
+{
+	char line[TRACE_LINE_MAX];
+	bool b_ok;
+
+	if (false == b_trace_replay)
+	{
+		if (NULL == p_trace_file)
+		{
+			return true;
+		}
+		fprintf(p_trace_file, "%lu E\n", (unsigned long)now);
+		b_ok = (0 == ferror(p_trace_file));
+		b_ok = (0 == fclose(p_trace_file)) && b_ok;
+		p_trace_file = NULL;
+		return b_ok;
+	}
+
+	/* Lo que quedó sin salir también es una diferencia */
+	for (; (false == b_trace_diverged) && (trace_qty > trace_out_idx); trace_out_idx++)
+	{
+		if ((TRACE_KIND_OUT == p_trace_list[trace_out_idx].kind)
+				|| (TRACE_KIND_LCD == p_trace_list[trace_out_idx].kind))
+		{
+			b_trace_diverged = true;
+			b_trace_missing = true;
+			b_trace_extra = false;
+			trace_expected = p_trace_list[trace_out_idx];
+		}
+	}
+
+	if (false == b_trace_diverged)
+	{
+		fprintf(p_out, "trace: %lu output events match\n", (unsigned long)trace_match_cnt);
+	}
+	else
+	{
+		fprintf(p_out, "trace: outputs diverge after %lu matching events\n",
+				(unsigned long)trace_match_cnt);
+		if (false == b_trace_extra)
+		{
+			trace_format(&trace_expected, line, sizeof(line));
+			fprintf(p_out, "- %s\n", line);
+		}
+		if (false == b_trace_missing)
+		{
+			trace_format(&trace_got, line, sizeof(line));
+			fprintf(p_out, "+ %s\n", line);
+		}
+	}
+
+	free(p_trace_list);
+	p_trace_list = NULL;
+	b_trace_replay = false;
+
+	return (false == b_trace_diverged);
+}
+
+/********************** internal functions definition ************************/
+
+// Al grabar va al archivo; al reproducir se compara con la próxima salida
+// esperada. Después de la primera diferencia ya no se compara: lo que
+// importa para hacer bisect es dónde empezó.
+static void trace_emit(const trace_event_t *p_event)
+{
+	char line[TRACE_LINE_MAX];
+	const trace_event_t *p_expected = NULL;
+
+	if (false == b_trace_replay)
+	{
+		trace_format(p_event, line, sizeof(line));
+		fprintf(p_trace_file, "%s\n", line);
+		return;
+	}
+
+	if (b_trace_diverged)
+	{
+		return;
+	}
+
+	for (; trace_qty > trace_out_idx; trace_out_idx++)
+	{
+		if ((TRACE_KIND_OUT == p_trace_list[trace_out_idx].kind)
+				|| (TRACE_KIND_LCD == p_trace_list[trace_out_idx].kind))
+		{
+			p_expected = &p_trace_list[trace_out_idx];
+			break;
+		}
+	}
+
+	if ((NULL != p_expected) && trace_equal(p_expected, p_event))
+	{
+		trace_out_idx++;
+		trace_match_cnt++;
+		return;
+	}
+
+	b_trace_diverged = true;
+	b_trace_missing = false;
+	b_trace_extra = (NULL == p_expected);
+	trace_got = *p_event;
+	if (NULL != p_expected)
+	{
+		trace_expected = *p_expected;
+	}
+}
+
+static bool trace_equal(const trace_event_t *p_a, const trace_event_t *p_b)
+{
+	return (p_a->ms == p_b->ms) && (p_a->kind == p_b->kind) && (p_a->id == p_b->id)
+			&& (p_a->value[0] == p_b->value[0])
+			&& ((TRACE_KIND_LCD != p_a->kind) || (0 == strcmp(p_a->text, p_b->text)));
+}
+
+static void trace_format(const trace_event_t *p_event, char *p_line, size_t size)
+{
+	const char *p;
+	size_t len;
+
+	switch (p_event->kind)
+	{
+	case TRACE_KIND_ADC:
+		snprintf(p_line, size, "%lu A %lu %lu", (unsigned long)p_event->ms,
+				 (unsigned long)p_event->value[0], (unsigned long)p_event->value[1]);
+		break;
+
+	case TRACE_KIND_IN:
+		snprintf(p_line, size, "%lu I %s %lu", (unsigned long)p_event->ms,
+				 trace_in_list[p_event->id].name, (unsigned long)p_event->value[0]);
+		break;
+
+	case TRACE_KIND_OUT:
+		snprintf(p_line, size, "%lu O %s %lu", (unsigned long)p_event->ms,
+				 trace_out_list[p_event->id].name, (unsigned long)p_event->value[0]);
+		break;
+
+	case TRACE_KIND_CMD:
+		snprintf(p_line, size, "%lu C %s %lu", (unsigned long)p_event->ms,
+				 trace_cmd_list[p_event->id].name, (unsigned long)p_event->value[0]);
+		break;
+
+	case TRACE_KIND_LCD:
+		len = (size_t)snprintf(p_line, size, "%lu D %u \"", (unsigned long)p_event->ms,
+							   (unsigned)p_event->id);
+		for (p = p_event->text; ('\0' != *p) && (len + 5 < size); p++)
+		{
+			if ((' ' <= *p) && ('~' >= *p) && ('"' != *p) && ('\\' != *p))
+			{
+				p_line[len++] = *p;
+			}
+			else
+			{
+				len += (size_t)snprintf(&p_line[len], size - len, "\\x%02X", (uint8_t)*p);
+			}
+		}
+		snprintf(&p_line[len], size - len, "\"");
+		break;
+
+	default:
+		snprintf(p_line, size, "%lu E", (unsigned long)p_event->ms);
+		break;
+	}
+}
+
+static bool trace_parse(const char *p_line, trace_event_t *p_event)
+{
+	char kind;
+	char name[8];
+	unsigned long ms;
+	unsigned long value[2];
+	unsigned row;
+	int pos;
+	int id;
+
+	memset(p_event, 0, sizeof(*p_event));
+	if (2 != sscanf(p_line, "%lu %c%n", &ms, &kind, &pos))
+	{
+		return false;
+	}
+	p_event->ms = (uint32_t)ms;
+	p_event->kind = kind;
+	p_line += pos;
+
+	switch (kind)
+	{
+	case TRACE_KIND_ADC:
+		if (2 != sscanf(p_line, "%lu %lu", &value[0], &value[1]))
+		{
+			return false;
+		}
+		p_event->value[0] = (uint32_t)value[0];
+		p_event->value[1] = (uint32_t)value[1];
+		return true;
+
+	case TRACE_KIND_IN:
+	case TRACE_KIND_OUT:
+	case TRACE_KIND_CMD:
+		if (2 != sscanf(p_line, "%7s %lu", name, &value[0]))
+		{
+			return false;
+		}
+		if (TRACE_KIND_IN == kind)
+		{
+			id = trace_find(trace_in_list, TRACE_IN_QTY, name);
+		}
+		else if (TRACE_KIND_OUT == kind)
+		{
+			id = trace_find(trace_out_list, TRACE_OUT_QTY, name);
+		}
+		else
+		{
+			id = trace_find(trace_cmd_list, TRACE_CMD_QTY, name);
+		}
+		if (0 > id)
+		{
+			return false;
+		}
+		p_event->id = (uint8_t)id;
+		p_event->value[0] = (uint32_t)value[0];
+		return true;
+
+	case TRACE_KIND_LCD:
+		if ((1 != sscanf(p_line, "%u %n", &row, &pos)) || (SIM_LCD_ROWS <= row))
+		{
+			return false;
+		}
+		p_event->id = (uint8_t)row;
+		return trace_parse_text(p_line + pos, p_event->text);
+
+	case TRACE_KIND_END:
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+static bool trace_parse_text(const char *p, char *p_text)
+{
+	size_t len = 0;
+	unsigned byte;
+
+	if ('"' != *p++)
+	{
+		return false;
+	}
+
+	while (('"' != *p) && ('\0' != *p) && (SIM_LCD_COLS > len))
+	{
+		if ('\\' == *p)
+		{
+			if (1 != sscanf(p, "\\x%2X", &byte))
+			{
+				return false;
+			}
+			p_text[len++] = (char)byte;
+			p += 4;
+		}
+		else
+		{
+			p_text[len++] = *p++;
+		}
+	}
+	p_text[len] = '\0';
+
+	return ('"' == *p);
+}
+
+static int trace_find(const trace_pin_t *p_list, size_t qty, const char *p_name)
+{
+	size_t index;
+
+	for (index = 0; qty > index; index++)
+	{
+		if (0 == strcmp(p_name, p_list[index].name))
+		{
+			return (int)index;
+		}
+	}
+
+	return -1;
+}
+
+// Lo mismo que hacen el menú de recetas y la consola
+static void trace_command_exec(trace_cmd_t cmd, uint32_t value)
+{
+	switch (cmd)
+	{
+	case TRACE_CMD_RECIPE:
+		task_recipe_select((uint8_t)(value - 1));
+		put_event_task_recipe(EV_REC_START);
+		break;
+
+	case TRACE_CMD_PAUSE:
+		put_event_task_recipe(EV_REC_PAUSE);
+		break;
+
+	case TRACE_CMD_ABORT:
+		put_event_task_recipe(EV_REC_ABORT);
+		break;
+
+	case TRACE_CMD_UART_RX:
+		sim_uart_rx((uint8_t)value);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/********************** end of file ******************************************/